@@ -0,0 +1,473 @@
+// ConstructionBench: microbenchmarks of network construction and I/O
+/*
+  Times the parts of the start up of a simulation that do not depend on its
+  length:
+    connect/<type>/<n>          SpikingModel::AddSynapseGroup of about n synapses of
+                                each CONNECTIVITY_TYPE (input neurons onto LIF neurons)
+    sort_synapses/<n>           Synapses::sort_synapses of n random synapses
+    save_connectivity_as_*      SpikingSynapses::save_connectivity_as_binary/txt
+    load_weights_from_*         Synapses::load_weights_from_binary/txt (of files
+                                written by save_weights_as_binary/txt)
+    save_spikes_as_*            SpikingActivityMonitor::save_spikes_as_txt/binary/archive
+  The I/O cases use a Brunel network (as SpikeBench's brunel workload) of the
+  largest size, run for --spike-simtime so that its monitor holds spikes.
+
+  Every case is repeated (untimed set up, such as building the network the
+  case works on, is done afresh before each repetition) and reported with the
+  median and minimum of its times, its throughput in synapses/s (spikes/s for
+  save_spikes_as_*) and MB/s (of the files read or written), and the number
+  and size of the heap allocations
+  of its median repetition. With glibc every malloc, calloc and realloc (and
+  so every operator new) is counted; elsewhere only operator new.
+
+  Options:
+    --sizes <n,n,...>      Synapses per case (default 10000,100000,1000000)
+    --repetitions <r>      (default 5)
+    --spike-simtime <s>    Simulated time before the spikes are saved (default 1s)
+    --threads <n>          Worker threads of construction and the CPU backend (default all)
+    --directory <path>     Where files are written (default ConstructionBench)
+    --output <file>        Writes the results as JSON
+*/
+
+#include "Spike/Spike.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <getopt.h>
+#include <sys/stat.h>
+
+
+/*
+  ALLOCATION COUNTING
+*/
+static std::atomic<long long> number_of_allocations(0);
+static std::atomic<long long> number_of_allocated_bytes(0);
+
+static inline void count_allocation(size_t size){
+  number_of_allocations.fetch_add(1, std::memory_order_relaxed);
+  number_of_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+#ifdef __GLIBC__
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* pointer, size_t size);
+
+  void* malloc(size_t size){
+    count_allocation(size);
+    return __libc_malloc(size);
+  }
+  void* calloc(size_t count, size_t size){
+    count_allocation(count*size);
+    return __libc_calloc(count, size);
+  }
+  void* realloc(void* pointer, size_t size){
+    count_allocation(size);
+    return __libc_realloc(pointer, size);
+  }
+}
+#else
+void* operator new(size_t size){
+  count_allocation(size);
+  if (void* pointer = malloc(size ? size : 1))
+    return pointer;
+  throw std::bad_alloc();
+}
+void* operator new[](size_t size){
+  return operator new(size);
+}
+void operator delete(void* pointer) noexcept {
+  free(pointer);
+}
+void operator delete[](void* pointer) noexcept {
+  free(pointer);
+}
+#endif
+
+
+/*
+  MEASUREMENT
+*/
+struct bench_result {
+  std::string name;
+  long long synapses = 0;
+  long long bytes = 0;               /**< Of the files read or written */
+  std::vector<double> seconds;       /**< Of each repetition, sorted */
+  long long allocations = 0;
+  long long allocated_bytes = 0;
+};
+
+static std::vector<bench_result> results;
+
+/**
+ * Runs work repetitions times, each after setup and before teardown (which are
+ * not timed). work returns the number of synapses it processed, bytes the
+ * number of bytes of its files (read after each repetition).
+ */
+static void measure(std::string name,
+                    int repetitions,
+                    std::function<void()> setup,
+                    std::function<long long()> work,
+                    std::function<void()> teardown,
+                    std::function<long long()> bytes = nullptr){
+  bench_result result;
+  result.name = name;
+  std::vector<std::pair<double, std::pair<long long, long long>>> repetition_results;
+  for (int r = 0; r < repetitions; r++){
+    setup();
+    long long allocations_before = number_of_allocations.load();
+    long long allocated_bytes_before = number_of_allocated_bytes.load();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    result.synapses = work();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    repetition_results.push_back(std::make_pair(seconds, std::make_pair(number_of_allocations.load() - allocations_before,
+                                                                         number_of_allocated_bytes.load() - allocated_bytes_before)));
+    if (bytes)
+      result.bytes = bytes();
+    teardown();
+  }
+  std::sort(repetition_results.begin(), repetition_results.end());
+  for (auto& repetition : repetition_results)
+    result.seconds.push_back(repetition.first);
+  result.allocations = repetition_results[repetitions / 2].second.first;
+  result.allocated_bytes = repetition_results[repetitions / 2].second.second;
+  results.push_back(result);
+
+  double median = result.seconds[repetitions / 2];
+  printf("%-40s %12.6f s %14.0f /s %10.1f MB/s %10lld allocations\n",
+         name.c_str(), median,
+         result.synapses / median,
+         result.bytes / median / 1.0e6,
+         result.allocations);
+  fflush(stdout);
+}
+
+static long long file_size(std::string filename){
+  struct stat file_status;
+  if (stat(filename.c_str(), &file_status) != 0)
+    return 0;
+  return file_status.st_size;
+}
+
+static long long files_size(std::string directory, std::string prefix, std::vector<std::string> names){
+  long long size = 0;
+  for (auto& name : names)
+    size += file_size(directory + "/" + prefix + name);
+  return size;
+}
+
+
+/*
+  NETWORKS
+*/
+struct bench_network {
+  SpikingModel* model = nullptr;
+  int input_group = 0;
+  int neuron_group = 0;
+};
+
+static bench_network new_network(int input_shape_x, int input_shape_y, int neuron_shape_x, int neuron_shape_y){
+  bench_network network;
+  network.model = new SpikingModel();
+  network.model->spiking_neurons = new LIFSpikingNeurons();
+  network.model->input_spiking_neurons = new PoissonInputSpikingNeurons();
+  network.model->spiking_synapses = new VoltageSpikingSynapses(42);
+
+  poisson_input_spiking_neuron_parameters_struct* input_params = new poisson_input_spiking_neuron_parameters_struct();
+  input_params->group_shape[0] = input_shape_x;
+  input_params->group_shape[1] = input_shape_y;
+  input_params->rate = 20.0f;
+  network.input_group = network.model->AddInputNeuronGroup(input_params);
+
+  lif_spiking_neuron_parameters_struct* neuron_params = new lif_spiking_neuron_parameters_struct();
+  neuron_params->group_shape[0] = neuron_shape_x;
+  neuron_params->group_shape[1] = neuron_shape_y;
+  neuron_params->somatic_capacitance_Cm = 200.0f*pow(10.0, -12);
+  neuron_params->somatic_leakage_conductance_g0 = 10.0f*pow(10.0, -9);
+  neuron_params->resting_potential_v0 = 0.0f;
+  neuron_params->after_spike_reset_potential_vreset = 0.0f;
+  neuron_params->absolute_refractory_period = 0.0f;
+  neuron_params->threshold_for_action_potential_spike = 20.0f*pow(10.0, -3);
+  neuron_params->background_current = 0.0f;
+  network.neuron_group = network.model->AddNeuronGroup(neuron_params);
+  return network;
+}
+
+static void delete_network(bench_network& network){
+  if (!network.model)
+    return;
+  delete network.model->spiking_synapses;
+  delete network.model->spiking_neurons;
+  delete network.model->input_spiking_neurons;
+  for (auto monitor : network.model->monitors_vec)
+    delete monitor;
+  delete network.model;
+  network.model = nullptr;
+}
+
+static voltage_spiking_synapse_parameters_struct* new_synapse_params(int connectivity_type, float weight){
+  voltage_spiking_synapse_parameters_struct* params = new voltage_spiking_synapse_parameters_struct();
+  params->delay_range[0] = 1.5f*powf(10.0, -3.0);
+  params->delay_range[1] = 1.5f*powf(10.0, -3.0);
+  params->weight_range[0] = weight;
+  params->weight_range[1] = weight;
+  params->weight_scaling_constant = 1.0f;
+  params->connectivity_type = connectivity_type;
+  return params;
+}
+
+// Group shapes and parameters for about number_of_synapses synapses of a connectivity type
+struct connection_case {
+  const char* name;
+  int connectivity_type;
+  int input_shape[2];
+  int neuron_shape[2];
+  voltage_spiking_synapse_parameters_struct* params;
+};
+
+static connection_case connection_case_for(int connectivity_type, int number_of_synapses){
+  connection_case c;
+  c.connectivity_type = connectivity_type;
+  c.params = new_synapse_params(connectivity_type, 0.1f*powf(10.0, -3.0));
+  int side = std::max(1, (int)std::round(sqrt((double)number_of_synapses)));
+  switch (connectivity_type){
+    case CONNECTIVITY_TYPE_ALL_TO_ALL:
+      c.name = "all_to_all";
+      c.input_shape[0] = 1; c.input_shape[1] = side;
+      c.neuron_shape[0] = 1; c.neuron_shape[1] = side;
+      break;
+    case CONNECTIVITY_TYPE_ONE_TO_ONE:
+      c.name = "one_to_one";
+      c.input_shape[0] = 1; c.input_shape[1] = number_of_synapses;
+      c.neuron_shape[0] = 1; c.neuron_shape[1] = number_of_synapses;
+      break;
+    case CONNECTIVITY_TYPE_RANDOM:
+      {
+        c.name = "random";
+        int number_of_neurons = std::max(1, (int)std::round(sqrt(number_of_synapses / 0.1)));
+        c.input_shape[0] = 1; c.input_shape[1] = number_of_neurons;
+        c.neuron_shape[0] = 1; c.neuron_shape[1] = number_of_neurons;
+        c.params->random_connectivity_probability = 0.1f;
+      }
+      break;
+    case CONNECTIVITY_TYPE_GAUSSIAN_SAMPLE:
+      {
+        c.name = "gaussian_sample";
+        int grid_side = std::max(4, (int)std::round(sqrt(number_of_synapses / 10.0)));
+        c.input_shape[0] = grid_side; c.input_shape[1] = grid_side;
+        c.neuron_shape[0] = grid_side; c.neuron_shape[1] = grid_side;
+        c.params->gaussian_synapses_per_postsynaptic_neuron = 10;
+        c.params->gaussian_synapses_standard_deviation = 5.0f;
+      }
+      break;
+    case CONNECTIVITY_TYPE_PAIRWISE:
+      {
+        c.name = "pairwise";
+        c.input_shape[0] = 1; c.input_shape[1] = side;
+        c.neuron_shape[0] = 1; c.neuron_shape[1] = side;
+        std::mt19937 generator(1);
+        std::uniform_int_distribution<int> neuron(0, side - 1);
+        for (int s = 0; s < number_of_synapses; s++){
+          c.params->pairwise_connect_presynaptic.push_back(neuron(generator));
+          c.params->pairwise_connect_postsynaptic.push_back(neuron(generator));
+        }
+      }
+      break;
+  }
+  return c;
+}
+
+// Brunel network with random connectivity of in-degree 100 from each of the three populations
+static bench_network new_brunel_network(int number_of_synapses, float simtime){
+  int number_of_neurons = std::max(100, number_of_synapses / 300);
+  bench_network network = new_network(1, number_of_neurons, 1, number_of_neurons);
+  SpikingModel* model = network.model;
+  float weight = 0.1f*powf(10.0, -3.0) * 10.0f;
+  voltage_spiking_synapse_parameters_struct* exc_params = new_synapse_params(CONNECTIVITY_TYPE_RANDOM, weight);
+  voltage_spiking_synapse_parameters_struct* inh_params = new_synapse_params(CONNECTIVITY_TYPE_RANDOM, -2.0f*weight);
+  exc_params->random_connectivity_probability = std::min(1.0f, 100.0f / number_of_neurons);
+  inh_params->random_connectivity_probability = std::min(1.0f, 100.0f / number_of_neurons);
+  model->AddSynapseGroup(network.input_group, network.neuron_group, exc_params);
+  model->AddSynapseGroup(network.neuron_group, network.neuron_group, exc_params);
+  model->AddSynapseGroup(network.neuron_group, network.neuron_group, inh_params);
+  model->AddActivityMonitor(new SpikingActivityMonitor(model->spiking_neurons));
+  model->finalise_model();
+  model->run(simtime, false);
+  return network;
+}
+
+
+int main (int argc, char *argv[]){
+  std::vector<int> sizes = {10000, 100000, 1000000};
+  int repetitions = 5;
+  float spike_simtime = 1.0f;
+  int threads = 0;
+  std::string directory = "ConstructionBench";
+  std::string output;
+  std::stringstream ss;
+  const char* const short_opts = "";
+  const option long_opts[] = {
+    {"sizes", 1, nullptr, 0},
+    {"repetitions", 1, nullptr, 1},
+    {"spike-simtime", 1, nullptr, 2},
+    {"threads", 1, nullptr, 3},
+    {"directory", 1, nullptr, 4},
+    {"output", 1, nullptr, 5},
+    {nullptr, 0, nullptr, 0},
+  };
+  while (true) {
+    const auto opt = getopt_long(argc, argv, short_opts, long_opts, nullptr);
+    if (-1 == opt) break;
+
+    ss.clear();
+    ss.str(optarg ? optarg : "");
+    switch (opt){
+      case 0:
+        {
+          sizes.clear();
+          std::string size;
+          while (std::getline(ss, size, ','))
+            sizes.push_back(std::stoi(size));
+        }
+        break;
+      case 1: ss >> repetitions; break;
+      case 2: ss >> spike_simtime; break;
+      case 3: ss >> threads; break;
+      case 4: ss >> directory; break;
+      case 5: ss >> output; break;
+      default:
+        std::cerr << "Usage: ConstructionBench [--sizes n,n,...] [--repetitions r] [--spike-simtime s] [--threads n] [--directory path] [--output file]" << std::endl;
+        exit(1);
+    }
+  }
+  if (sizes.empty() || (repetitions < 1)){
+    std::cerr << "ERROR: At least one size and one repetition are needed" << std::endl;
+    exit(1);
+  }
+  if ((mkdir(directory.c_str(), 0777) != 0) && (errno != EEXIST)){
+    std::cerr << "ERROR: Could not create " << directory << std::endl;
+    exit(1);
+  }
+
+  Backend::init_global_context();
+  _global_ctx->params.threads = threads;
+
+  /*
+    CONSTRUCTION
+  */
+  bench_network network;
+  auto teardown = [&]() { delete_network(network); };
+  for (int size : sizes){
+    for (int connectivity_type : {CONNECTIVITY_TYPE_ALL_TO_ALL, CONNECTIVITY_TYPE_ONE_TO_ONE, CONNECTIVITY_TYPE_RANDOM, CONNECTIVITY_TYPE_GAUSSIAN_SAMPLE, CONNECTIVITY_TYPE_PAIRWISE}){
+      connection_case c = connection_case_for(connectivity_type, size);
+      measure(std::string("connect/") + c.name + "/" + std::to_string(size), repetitions,
+              [&]() { network = new_network(c.input_shape[0], c.input_shape[1], c.neuron_shape[0], c.neuron_shape[1]); },
+              [&]() {
+                network.model->AddSynapseGroup(network.input_group, network.neuron_group, c.params);
+                return (long long)network.model->spiking_synapses->total_number_of_synapses;
+              },
+              teardown);
+      delete c.params;
+    }
+
+    connection_case c = connection_case_for(CONNECTIVITY_TYPE_RANDOM, size);
+    measure("sort_synapses/" + std::to_string(size), repetitions,
+            [&]() {
+              network = new_network(c.input_shape[0], c.input_shape[1], c.neuron_shape[0], c.neuron_shape[1]);
+              network.model->AddSynapseGroup(network.input_group, network.neuron_group, c.params);
+            },
+            [&]() {
+              network.model->spiking_synapses->sort_synapses(network.model->input_spiking_neurons, network.model->spiking_neurons);
+              return (long long)network.model->spiking_synapses->total_number_of_synapses;
+            },
+            teardown);
+    delete c.params;
+  }
+
+  /*
+    I/O
+  */
+  bench_network io_network = new_brunel_network(*std::max_element(sizes.begin(), sizes.end()), spike_simtime);
+  SpikingSynapses* synapses = io_network.model->spiking_synapses;
+  SpikingActivityMonitor* spike_monitor = (SpikingActivityMonitor*)io_network.model->monitors_vec[0];
+  long long number_of_synapses = synapses->total_number_of_synapses;
+  long long number_of_spikes = spike_monitor->total_number_of_spikes_stored_on_host;
+  printf("I/O network of %lld synapses, %lld spikes\n", number_of_synapses, number_of_spikes);
+  auto nothing = []() {};
+
+  measure("save_connectivity_as_binary", repetitions, nothing,
+          [&]() { synapses->save_connectivity_as_binary(directory, "Bench"); return number_of_synapses; },
+          nothing,
+          [&]() { return files_size(directory, "Bench", {"PresynapticIDs.bin", "PostsynapticIDs.bin", "SynapticWeights.bin", "SynapticDelays.bin"}); });
+  measure("save_connectivity_as_txt", repetitions, nothing,
+          [&]() { synapses->save_connectivity_as_txt(directory, "Bench"); return number_of_synapses; },
+          nothing,
+          [&]() { return files_size(directory, "Bench", {"PresynapticIDs.txt", "PostsynapticIDs.txt", "SynapticWeights.txt", "SynapticDelays.txt"}); });
+
+  synapses->save_weights_as_binary(directory, "Bench");
+  synapses->save_weights_as_txt(directory, "Bench");
+  measure("load_weights_from_binary", repetitions, nothing,
+          [&]() { synapses->load_weights_from_binary(directory + "/BenchSynapticWeights.bin"); return number_of_synapses; },
+          nothing,
+          [&]() { return file_size(directory + "/BenchSynapticWeights.bin"); });
+  measure("load_weights_from_txt", repetitions, nothing,
+          [&]() { synapses->load_weights_from_txt(directory + "/BenchSynapticWeights.txt"); return number_of_synapses; },
+          nothing,
+          [&]() { return file_size(directory + "/BenchSynapticWeights.txt"); });
+
+  // Spike cases report spikes in place of synapses
+  measure("save_spikes_as_txt", repetitions, nothing,
+          [&]() { spike_monitor->save_spikes_as_txt(directory, "Bench"); return number_of_spikes; },
+          nothing,
+          [&]() { return files_size(directory, "Bench", {"SpikeIDs.txt", "SpikeTimes.txt"}); });
+  measure("save_spikes_as_binary", repetitions, nothing,
+          [&]() { spike_monitor->save_spikes_as_binary(directory, "Bench"); return number_of_spikes; },
+          nothing,
+          [&]() { return files_size(directory, "Bench", {"SpikeIDs.bin", "SpikeTimes.bin"}); });
+  measure("save_spikes_as_archive", repetitions, nothing,
+          [&]() { spike_monitor->save_spikes_as_archive(directory, "Bench"); return number_of_spikes; },
+          nothing,
+          [&]() { return file_size(directory + "/BenchSpikeArchive.bin"); });
+
+  if (!output.empty()){
+    std::ofstream file(output);
+    if (!file.is_open()){
+      std::cerr << "ERROR: Could not open " << output << std::endl;
+      exit(1);
+    }
+    file.precision(9);
+    file << "{\n";
+    file << "  \"backend\": \"" << io_network.model->context->backend << "\",\n";
+    file << "  \"threads\": " << threads << ",\n";
+    file << "  \"repetitions\": " << repetitions << ",\n";
+    file << "  \"cases\": [";
+    for (int r = 0; r < (int)results.size(); r++){
+      const bench_result& result = results[r];
+      double median = result.seconds[repetitions / 2];
+      file << ((r > 0) ? ",\n" : "\n");
+      file << "    {\"name\": \"" << result.name << "\", "
+           << "\"count\": " << result.synapses << ", "
+           << "\"bytes\": " << result.bytes << ", "
+           << "\"median_seconds\": " << median << ", "
+           << "\"minimum_seconds\": " << result.seconds.front() << ", "
+           << "\"per_second\": " << result.synapses / median << ", "
+           << "\"megabytes_per_second\": " << result.bytes / median / 1.0e6 << ", "
+           << "\"allocations\": " << result.allocations << ", "
+           << "\"allocated_bytes\": " << result.allocated_bytes << "}";
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+  }
+  delete_network(io_network);
+  return 0;
+}
@@ -0,0 +1,404 @@
+// SpikeBench: benchmark workloads with machine readable results
+/*
+  Builds and runs one workload and reports, as JSON:
+    construction time (adding the neuron and synapse groups), finalise time,
+    run time, wall time per simulated second, synaptic events per second (from
+    the SpikingModel profiler, which is on for the run), the profile of the
+    run and the peak resident set size of the process.
+
+  Workloads:
+    brunel10k      The network of Examples/Brunel10K
+    vogelsabbott   The network of Examples/VogelsAbbottNet
+    brunel         A Brunel network of --neurons neurons (80% excitatory), each
+                   with an expected in-degree of --indegree from the excitatory,
+                   the inhibitory and an external Poisson population (as large as
+                   the network) in proportion 0.8 : 0.2 : 1. Weights are scaled
+                   by 1000 / indegree so that the activity is that of Brunel10K.
+                   This is the synthetic workload whose size is set by --neurons.
+    synthetic      Another name for brunel
+
+  Options:
+    --workload <name>   (default brunel)
+    --neurons <n>       For brunel and synthetic (default 10000)
+    --indegree <k>      For brunel and synthetic (default 100)
+    --simtime <s>       Simulated time (default 1s)
+    --plastic           Weight dependent STDP on the excitatory synapses (brunel, brunel10k)
+    --procedural        Procedural connectivity for the static random groups (brunel,
+                        vogelsabbott): their synapses are regenerated, not stored
+    --monitors          Record the spikes of the network
+    --threads <n>       Worker threads of the CPU backend (default all)
+    --output <file>     Writes the JSON there as well as to stdout
+
+  Each run is a process of its own, so that the peak RSS is its own. To scale
+  the brunel workload from 10^3 to 10^6 neurons:
+    for n in 1000 10000 100000 1000000; do ./SpikeBench --neurons $n --output brunel_$n.json; done
+*/
+
+#include "Spike/Spike.hpp"
+#include "UtilityFunctions.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <getopt.h>
+#include <sys/resource.h>
+
+
+struct bench_options {
+  std::string workload = "brunel";
+  int neurons = 10000;
+  int indegree = 100;
+  float simtime = 1.0f;
+  bool plastic = false;
+  bool procedural = false;
+  bool monitors = false;
+  int threads = 0;
+  std::string output;
+};
+
+// The components a workload builds, so that the model can be inspected after the run
+struct bench_network {
+  SpikingModel* model = nullptr;
+  SpikingActivityMonitor* spike_monitor = nullptr;
+};
+
+
+static lif_spiking_neuron_parameters_struct* brunel_neuron_params(int number_of_neurons){
+  lif_spiking_neuron_parameters_struct* params = new lif_spiking_neuron_parameters_struct();
+  params->group_shape[0] = 1;
+  params->group_shape[1] = number_of_neurons;
+  params->somatic_capacitance_Cm = 200.0f*pow(10.0, -12);
+  params->somatic_leakage_conductance_g0 = 10.0f*pow(10.0, -9);
+  params->resting_potential_v0 = 0.0f;
+  params->after_spike_reset_potential_vreset = 0.0f;
+  params->absolute_refractory_period = 0.0f;
+  params->threshold_for_action_potential_spike = 20.0f*pow(10.0, -3);
+  params->background_current = 0.0f;
+  return params;
+}
+
+static voltage_spiking_synapse_parameters_struct* brunel_synapse_params(float weight, float delay){
+  voltage_spiking_synapse_parameters_struct* params = new voltage_spiking_synapse_parameters_struct();
+  params->delay_range[0] = delay;
+  params->delay_range[1] = delay;
+  params->weight_range[0] = weight;
+  params->weight_range[1] = weight;
+  params->weight_scaling_constant = 1.0f;
+  return params;
+}
+
+static WeightDependentSTDPPlasticity* brunel_plasticity(SpikingModel* model){
+  weightdependent_stdp_plasticity_parameters_struct* params = new weightdependent_stdp_plasticity_parameters_struct;
+  params->a_plus = 1.0;
+  params->a_minus = 1.0;
+  params->tau_plus = 0.02;
+  params->tau_minus = 0.02;
+  params->lambda = 1.0f*powf(10.0, -2);
+  params->alpha = 2.02;
+  params->w_max = 0.3*powf(10.0, -3);
+  WeightDependentSTDPPlasticity* plasticity = new WeightDependentSTDPPlasticity(model->spiking_synapses, model->spiking_neurons, model->input_spiking_neurons, params);
+  model->AddPlasticityRule(plasticity);
+  return plasticity;
+}
+
+// As Examples/Brunel10K
+static void build_brunel10k(bench_network& network, const bench_options& options){
+  SpikingModel* model = network.model;
+  float timestep = 0.0001f;
+  model->SetTimestep(timestep);
+  float delay = 1.5f*powf(10.0, -3.0);
+  float sparseness = 0.1;
+
+  model->spiking_neurons = new LIFSpikingNeurons();
+  model->input_spiking_neurons = new PoissonInputSpikingNeurons();
+  model->spiking_synapses = new VoltageSpikingSynapses(42);
+  WeightDependentSTDPPlasticity* plasticity = options.plastic ? brunel_plasticity(model) : nullptr;
+
+  poisson_input_spiking_neuron_parameters_struct* input_params = new poisson_input_spiking_neuron_parameters_struct();
+  input_params->group_shape[0] = 1;
+  input_params->group_shape[1] = 10000;
+  input_params->rate = 20.0f;
+  int input_layer = model->AddInputNeuronGroup(input_params);
+
+  lif_spiking_neuron_parameters_struct* exc_params = brunel_neuron_params(8000);
+  lif_spiking_neuron_parameters_struct* inh_params = brunel_neuron_params(2000);
+  int exc_layer = model->AddNeuronGroup(exc_params);
+  int inh_layer = model->AddNeuronGroup(inh_params);
+
+  float weight = 0.1f*powf(10.0, -3.0);
+  float gamma = 5.0f;
+  voltage_spiking_synapse_parameters_struct* exc_syn_params = brunel_synapse_params(weight, delay);
+  voltage_spiking_synapse_parameters_struct* inh_syn_params = brunel_synapse_params(-gamma*weight, delay);
+  voltage_spiking_synapse_parameters_struct* input_syn_params = brunel_synapse_params(weight, delay);
+
+  connect_with_sparsity(input_layer, exc_layer, input_params, exc_params, input_syn_params, sparseness, model);
+  connect_with_sparsity(input_layer, inh_layer, input_params, inh_params, input_syn_params, sparseness, model);
+  connect_with_sparsity(exc_layer, inh_layer, exc_params, inh_params, exc_syn_params, sparseness, model);
+  if (plasticity)
+    exc_syn_params->plasticity_vec.push_back(plasticity);
+  connect_with_sparsity(exc_layer, exc_layer, exc_params, exc_params, exc_syn_params, sparseness, model);
+  connect_with_sparsity(inh_layer, exc_layer, inh_params, exc_params, inh_syn_params, sparseness, model);
+  connect_with_sparsity(inh_layer, inh_layer, inh_params, inh_params, inh_syn_params, sparseness, model);
+}
+
+// Brunel10K at any size, with random connectivity of a given expected in-degree
+static void build_brunel(bench_network& network, const bench_options& options){
+  SpikingModel* model = network.model;
+  float timestep = 0.0001f;
+  model->SetTimestep(timestep);
+  float delay = 1.5f*powf(10.0, -3.0);
+  int number_of_excitatory_neurons = (int)(0.8*options.neurons);
+  int number_of_inhibitory_neurons = options.neurons - number_of_excitatory_neurons;
+
+  model->spiking_neurons = new LIFSpikingNeurons();
+  model->input_spiking_neurons = new PoissonInputSpikingNeurons();
+  model->spiking_synapses = new VoltageSpikingSynapses(42);
+  WeightDependentSTDPPlasticity* plasticity = options.plastic ? brunel_plasticity(model) : nullptr;
+
+  poisson_input_spiking_neuron_parameters_struct* input_params = new poisson_input_spiking_neuron_parameters_struct();
+  input_params->group_shape[0] = 1;
+  input_params->group_shape[1] = options.neurons;
+  input_params->rate = 20.0f;
+  int input_layer = model->AddInputNeuronGroup(input_params);
+  int exc_layer = model->AddNeuronGroup(brunel_neuron_params(number_of_excitatory_neurons));
+  int inh_layer = model->AddNeuronGroup(brunel_neuron_params(number_of_inhibitory_neurons));
+
+  float weight = 0.1f*powf(10.0, -3.0) * 1000.0f / options.indegree;
+  float gamma = 5.0f;
+  voltage_spiking_synapse_parameters_struct* exc_syn_params = brunel_synapse_params(weight, delay);
+  voltage_spiking_synapse_parameters_struct* inh_syn_params = brunel_synapse_params(-gamma*weight, delay);
+  voltage_spiking_synapse_parameters_struct* input_syn_params = brunel_synapse_params(weight, delay);
+  for (voltage_spiking_synapse_parameters_struct* params : {exc_syn_params, inh_syn_params, input_syn_params}){
+    params->connectivity_type = CONNECTIVITY_TYPE_RANDOM;
+    params->procedural_connectivity = options.procedural;
+  }
+  // Expected in-degrees of 0.8, 0.2 and 1 times indegree
+  input_syn_params->random_connectivity_probability = std::min(1.0f, (float)options.indegree / options.neurons);
+  exc_syn_params->random_connectivity_probability = std::min(1.0f, 0.8f*options.indegree / number_of_excitatory_neurons);
+  inh_syn_params->random_connectivity_probability = std::min(1.0f, 0.2f*options.indegree / number_of_inhibitory_neurons);
+
+  if (!options.procedural)
+    model->reserve((int)std::min(2.0*options.indegree*(double)options.neurons*1.01, (double)INT_MAX));
+  model->AddSynapseGroup(input_layer, exc_layer, input_syn_params);
+  model->AddSynapseGroup(input_layer, inh_layer, input_syn_params);
+  model->AddSynapseGroup(exc_layer, inh_layer, exc_syn_params);
+  model->AddSynapseGroup(inh_layer, exc_layer, inh_syn_params);
+  model->AddSynapseGroup(inh_layer, inh_layer, inh_syn_params);
+  if (plasticity){
+    // Plastic synapses are always stored
+    exc_syn_params->plasticity_vec.push_back(plasticity);
+    exc_syn_params->procedural_connectivity = false;
+  }
+  model->AddSynapseGroup(exc_layer, exc_layer, exc_syn_params);
+}
+
+// As Examples/VogelsAbbottNet, with its default delays (8 timesteps)
+static void build_vogelsabbott(bench_network& network, const bench_options& options){
+  SpikingModel* model = network.model;
+  float timestep = 0.0001f;
+  model->SetTimestep(timestep);
+
+  model->spiking_neurons = new LIFSpikingNeurons();
+  model->spiking_synapses = new ConductanceSpikingSynapses();
+
+  lif_spiking_neuron_parameters_struct* exc_params = new lif_spiking_neuron_parameters_struct();
+  lif_spiking_neuron_parameters_struct* inh_params = new lif_spiking_neuron_parameters_struct();
+  for (lif_spiking_neuron_parameters_struct* params : {exc_params, inh_params}){
+    params->somatic_capacitance_Cm = 200.0f*pow(10.0, -12);
+    params->somatic_leakage_conductance_g0 = 10.0f*pow(10.0, -9);
+    params->resting_potential_v0 = -60.0f*pow(10.0, -3);
+    params->after_spike_reset_potential_vreset = -60.0f*pow(10.0, -3);
+    params->absolute_refractory_period = 5.0f*pow(10, -3);
+    params->threshold_for_action_potential_spike = -50.0f*pow(10.0, -3);
+    params->background_current = 2.0f*pow(10.0, -2);
+  }
+  exc_params->group_shape[0] = 1;
+  exc_params->group_shape[1] = 3200;
+  inh_params->group_shape[0] = 1;
+  inh_params->group_shape[1] = 800;
+  int exc_layer = model->AddNeuronGroup(exc_params);
+  int inh_layer = model->AddNeuronGroup(inh_params);
+
+  conductance_spiking_synapse_parameters_struct* exc_syn_params = new conductance_spiking_synapse_parameters_struct();
+  conductance_spiking_synapse_parameters_struct* inh_syn_params = new conductance_spiking_synapse_parameters_struct();
+  for (conductance_spiking_synapse_parameters_struct* params : {exc_syn_params, inh_syn_params}){
+    params->delay_range[0] = 8*timestep;
+    params->delay_range[1] = 8*timestep;
+    params->weight_scaling_constant = 10.0f*pow(10.0, -9);
+    params->connectivity_type = CONNECTIVITY_TYPE_RANDOM;
+    params->random_connectivity_probability = 0.02;
+    params->procedural_connectivity = options.procedural;
+    params->plasticity_vec.push_back(nullptr);
+  }
+  exc_syn_params->reversal_potential_Vhat = 0.0f;
+  inh_syn_params->reversal_potential_Vhat = -80.0f*pow(10.0, -3);
+  exc_syn_params->weight_range[0] = 0.4f;
+  exc_syn_params->weight_range[1] = 0.4f;
+  inh_syn_params->weight_range[0] = 5.1f;
+  inh_syn_params->weight_range[1] = 5.1f;
+  exc_syn_params->decay_term_tau_g = 5.0f*pow(10.0, -3);
+  inh_syn_params->decay_term_tau_g = 10.0f*pow(10.0, -3);
+
+  model->AddSynapseGroup(exc_layer, exc_layer, exc_syn_params);
+  model->AddSynapseGroup(exc_layer, inh_layer, exc_syn_params);
+  model->AddSynapseGroup(inh_layer, exc_layer, inh_syn_params);
+  model->AddSynapseGroup(inh_layer, inh_layer, inh_syn_params);
+}
+
+
+static long long peak_rss_in_bytes(){
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return usage.ru_maxrss * 1024LL;
+#endif
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start){
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Indents every line but the first of a nested JSON value by one level
+static std::string nested_json(const std::string& value){
+  std::string nested;
+  std::string trimmed = value.substr(0, value.find_last_not_of('\n') + 1);
+  for (char c : trimmed){
+    nested += c;
+    if (c == '\n')
+      nested += "  ";
+  }
+  return nested;
+}
+
+
+int main (int argc, char *argv[]){
+  bench_options options;
+  std::stringstream ss;
+  const char* const short_opts = "";
+  const option long_opts[] = {
+    {"workload", 1, nullptr, 0},
+    {"neurons", 1, nullptr, 1},
+    {"indegree", 1, nullptr, 2},
+    {"simtime", 1, nullptr, 3},
+    {"plastic", 0, nullptr, 4},
+    {"monitors", 0, nullptr, 5},
+    {"threads", 1, nullptr, 6},
+    {"output", 1, nullptr, 7},
+    {"procedural", 0, nullptr, 8},
+    {nullptr, 0, nullptr, 0},
+  };
+  while (true) {
+    const auto opt = getopt_long(argc, argv, short_opts, long_opts, nullptr);
+    if (-1 == opt) break;
+
+    ss.clear();
+    ss.str(optarg ? optarg : "");
+    switch (opt){
+      case 0: ss >> options.workload; break;
+      case 1: ss >> options.neurons; break;
+      case 2: ss >> options.indegree; break;
+      case 3: ss >> options.simtime; break;
+      case 4: options.plastic = true; break;
+      case 5: options.monitors = true; break;
+      case 6: ss >> options.threads; break;
+      case 7: ss >> options.output; break;
+      case 8: options.procedural = true; break;
+      default:
+        std::cerr << "Usage: SpikeBench [--workload brunel|synthetic|brunel10k|vogelsabbott] [--neurons n] [--indegree k] [--simtime s] [--plastic] [--procedural] [--monitors] [--threads n] [--output file]" << std::endl;
+        exit(1);
+    }
+  }
+  if ((options.neurons < 10) || (options.indegree < 1)){
+    std::cerr << "ERROR: --neurons must be at least 10 and --indegree at least 1" << std::endl;
+    exit(1);
+  }
+  if (options.workload == "synthetic")
+    options.workload = "brunel";
+
+  Backend::init_global_context();
+  _global_ctx->params.threads = options.threads;
+
+  /*
+    CONSTRUCTION
+  */
+  std::chrono::steady_clock::time_point construction_start = std::chrono::steady_clock::now();
+  bench_network network;
+  network.model = new SpikingModel();
+  if (options.workload == "brunel10k")
+    build_brunel10k(network, options);
+  else if (options.workload == "brunel")
+    build_brunel(network, options);
+  else if (options.workload == "vogelsabbott")
+    build_vogelsabbott(network, options);
+  else {
+    std::cerr << "ERROR: Unknown workload " << options.workload << std::endl;
+    exit(1);
+  }
+  SpikingModel* model = network.model;
+  if (options.monitors){
+    network.spike_monitor = new SpikingActivityMonitor(model->spiking_neurons);
+    model->AddActivityMonitor(network.spike_monitor);
+  }
+  double construction_seconds = seconds_since(construction_start);
+
+  std::chrono::steady_clock::time_point finalise_start = std::chrono::steady_clock::now();
+  model->finalise_model();
+  double finalise_seconds = seconds_since(finalise_start);
+
+  /*
+    RUN
+  */
+  model->enable_profiling();
+  std::chrono::steady_clock::time_point run_start = std::chrono::steady_clock::now();
+  model->run(options.simtime);
+  double run_seconds = seconds_since(run_start);
+
+  const StepProfiler& profile = model->profiler;
+  double simulated_seconds = profile.number_of_timesteps*(double)model->timestep;
+
+  std::ostringstream json;
+  json.precision(9);
+  json << "{\n";
+  json << "  \"workload\": \"" << options.workload << "\",\n";
+  json << "  \"backend\": \"" << model->context->backend << "\",\n";
+  json << "  \"threads\": " << options.threads << ",\n";
+  json << "  \"neurons\": " << model->spiking_neurons->total_number_of_neurons << ",\n";
+  json << "  \"input_neurons\": " << model->input_spiking_neurons->total_number_of_neurons << ",\n";
+  json << "  \"synapses\": " << model->spiking_synapses->total_number_of_synapses << ",\n";
+  if (options.workload == "brunel")
+    json << "  \"indegree\": " << options.indegree << ",\n";
+  json << "  \"plastic\": " << (options.plastic ? "true" : "false") << ",\n";
+  json << "  \"procedural\": " << (options.procedural ? "true" : "false") << ",\n";
+  json << "  \"monitors\": " << (options.monitors ? "true" : "false") << ",\n";
+  json << "  \"timestep\": " << model->timestep << ",\n";
+  json << "  \"timestep_grouping\": " << model->timestep_grouping << ",\n";
+  json << "  \"simulated_seconds\": " << simulated_seconds << ",\n";
+  json << "  \"construction_seconds\": " << construction_seconds << ",\n";
+  json << "  \"finalise_seconds\": " << finalise_seconds << ",\n";
+  json << "  \"run_seconds\": " << run_seconds << ",\n";
+  json << "  \"wall_seconds_per_simulated_second\": " << run_seconds / simulated_seconds << ",\n";
+  json << "  \"synaptic_events\": " << profile.synaptic_events << ",\n";
+  json << "  \"synaptic_events_per_second\": " << profile.synaptic_events / run_seconds << ",\n";
+  if (network.spike_monitor)
+    json << "  \"spikes\": " << network.spike_monitor->total_number_of_spikes_stored_on_host << ",\n";
+  json << "  \"peak_rss_bytes\": " << peak_rss_in_bytes() << ",\n";
+  json << "  \"profile\": " << nested_json(profile.as_json()) << "\n";
+  json << "}\n";
+
+  printf("%s", json.str().c_str());
+  if (!options.output.empty()){
+    std::ofstream file(options.output);
+    if (!file.is_open()){
+      std::cerr << "ERROR: Could not open " << options.output << std::endl;
+      exit(1);
+    }
+    file << json.str();
+  }
+  return 0;
+}
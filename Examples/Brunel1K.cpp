@@ -0,0 +1,167 @@
+// Brunel 1,000 Neuron Network
+/*
+  A scaled down Brunel10K to benchmark the fixed cost of a simulation step.
+  With 1,000 neurons and the shortest delays (one timestep, so that every
+  timestep is a step of its own) little work is done per step and the time
+  per step is mostly overhead.
+
+  Options:
+    --simtime <s>     Simulated time (default 10s)
+    --delay <ms>      Synaptic delay (default 0.1ms, the timestep)
+    --plastic         Turn on weight dependent STDP
+    --fast            No spike monitor
+    --profile         Print the time of each stage of a step (SpikingModel::enable_profiling)
+
+  Original Publication:
+  Brunel N. Dynamics of sparsely connected networks of excitatory and inhibitory spiking neurons. J Comput Neurosci. 2000;8: 183–208.
+*/
+
+#include "Spike/Spike.hpp"
+#include "UtilityFunctions.hpp"
+
+#include <chrono>
+#include <sstream>
+#include <getopt.h>
+
+
+int main (int argc, char *argv[]){
+  float simtime = 10.0;
+  float delay_in_ms = 0.1f;
+  float sparseness = 0.1;
+  bool fast = false;
+  bool plastic = false;
+  bool profile = false;
+  std::stringstream ss;
+  const char* const short_opts = "";
+  const option long_opts[] = {
+    {"simtime", 1, nullptr, 0},
+    {"fast", 0, nullptr, 1},
+    {"delay", 1, nullptr, 2},
+    {"plastic", 0, nullptr, 4},
+    {"profile", 0, nullptr, 5},
+    {nullptr, 0, nullptr, 0},
+  };
+  while (true) {
+    const auto opt = getopt_long(argc, argv, short_opts, long_opts, nullptr);
+    if (-1 == opt) break;
+
+    switch (opt){
+      case 0:
+        ss << optarg;
+        ss >> simtime;
+        ss.clear();
+        break;
+      case 1:
+        fast = true;
+        break;
+      case 2:
+        ss << optarg;
+        ss >> delay_in_ms;
+        ss.clear();
+        break;
+      case 4:
+        plastic = true;
+        break;
+      case 5:
+        profile = true;
+        break;
+    }
+  };
+
+  SpikingModel * BenchModel = new SpikingModel();
+  float timestep = 0.0001f;
+  BenchModel->SetTimestep(timestep);
+  float delayval = delay_in_ms*powf(10.0, -3.0);
+
+  LIFSpikingNeurons * lif_spiking_neurons = new LIFSpikingNeurons();
+  PoissonInputSpikingNeurons * poisson_input_spiking_neurons = new PoissonInputSpikingNeurons();
+  VoltageSpikingSynapses * voltage_spiking_synapses = new VoltageSpikingSynapses(42);
+
+  weightdependent_stdp_plasticity_parameters_struct * WDSTDP_PARAMS = new weightdependent_stdp_plasticity_parameters_struct;
+  WDSTDP_PARAMS->a_plus = 1.0;
+  WDSTDP_PARAMS->a_minus = 1.0;
+  WDSTDP_PARAMS->tau_plus = 0.02;
+  WDSTDP_PARAMS->tau_minus = 0.02;
+  WDSTDP_PARAMS->lambda = 1.0f*powf(10.0, -2);
+  WDSTDP_PARAMS->alpha = 2.02;
+  WDSTDP_PARAMS->w_max = 0.3*powf(10.0, -3);
+  WeightDependentSTDPPlasticity * weightdependent_stdp = new WeightDependentSTDPPlasticity((SpikingSynapses *) voltage_spiking_synapses, (SpikingNeurons *)lif_spiking_neurons, (SpikingNeurons *) poisson_input_spiking_neurons, (stdp_plasticity_parameters_struct *) WDSTDP_PARAMS);
+
+  BenchModel->spiking_neurons = lif_spiking_neurons;
+  BenchModel->input_spiking_neurons = poisson_input_spiking_neurons;
+  BenchModel->spiking_synapses = voltage_spiking_synapses;
+  if (plastic)
+    BenchModel->AddPlasticityRule(weightdependent_stdp);
+
+  SpikingActivityMonitor* spike_monitor = new SpikingActivityMonitor(lif_spiking_neurons);
+  if (!fast)
+    BenchModel->AddActivityMonitor(spike_monitor);
+
+  // Neurons as in Brunel10K
+  lif_spiking_neuron_parameters_struct * EXC_NEURON_PARAMS = new lif_spiking_neuron_parameters_struct();
+  lif_spiking_neuron_parameters_struct * INH_NEURON_PARAMS = new lif_spiking_neuron_parameters_struct();
+  for (lif_spiking_neuron_parameters_struct * params : {EXC_NEURON_PARAMS, INH_NEURON_PARAMS}){
+    params->somatic_capacitance_Cm = 200.0f*pow(10.0, -12);
+    params->somatic_leakage_conductance_g0 = 10.0f*pow(10.0, -9);
+    params->resting_potential_v0 = 0.0f;
+    params->after_spike_reset_potential_vreset = 0.0f;
+    params->absolute_refractory_period = 0.0f;
+    params->threshold_for_action_potential_spike = 20.0f*pow(10.0, -3);
+    params->background_current = 0.0f;
+  }
+
+  poisson_input_spiking_neuron_parameters_struct* input_neuron_params = new poisson_input_spiking_neuron_parameters_struct();
+  input_neuron_params->group_shape[0] = 1;
+  input_neuron_params->group_shape[1] = 1000;
+  input_neuron_params->rate = 20.0f; // Hz
+  int input_layer_ID = BenchModel->AddInputNeuronGroup(input_neuron_params);
+
+  EXC_NEURON_PARAMS->group_shape[0] = 1;
+  EXC_NEURON_PARAMS->group_shape[1] = 800;
+  INH_NEURON_PARAMS->group_shape[0] = 1;
+  INH_NEURON_PARAMS->group_shape[1] = 200;
+  int excitatory_layer_ID = BenchModel->AddNeuronGroup(EXC_NEURON_PARAMS);
+  int inhibitory_layer_ID = BenchModel->AddNeuronGroup(INH_NEURON_PARAMS);
+
+  voltage_spiking_synapse_parameters_struct * EXC_OUT_SYN_PARAMS = new voltage_spiking_synapse_parameters_struct();
+  voltage_spiking_synapse_parameters_struct * INH_OUT_SYN_PARAMS = new voltage_spiking_synapse_parameters_struct();
+  voltage_spiking_synapse_parameters_struct * INPUT_SYN_PARAMS = new voltage_spiking_synapse_parameters_struct();
+  // Ten times the weights of Brunel10K, for a tenth of the in-degree
+  float weight_val = 1.0f*powf(10.0, -3.0);
+  float gamma = 5.0f;
+  for (voltage_spiking_synapse_parameters_struct * params : {EXC_OUT_SYN_PARAMS, INH_OUT_SYN_PARAMS, INPUT_SYN_PARAMS}){
+    params->delay_range[0] = delayval;
+    params->delay_range[1] = delayval;
+    params->weight_range[0] = weight_val;
+    params->weight_range[1] = weight_val;
+    params->weight_scaling_constant = 1.0;
+  }
+  INH_OUT_SYN_PARAMS->weight_range[0] = -gamma * weight_val;
+  INH_OUT_SYN_PARAMS->weight_range[1] = -gamma * weight_val;
+
+  connect_with_sparsity(input_layer_ID, excitatory_layer_ID, input_neuron_params, EXC_NEURON_PARAMS, INPUT_SYN_PARAMS, sparseness, BenchModel);
+  connect_with_sparsity(input_layer_ID, inhibitory_layer_ID, input_neuron_params, INH_NEURON_PARAMS, INPUT_SYN_PARAMS, sparseness, BenchModel);
+  connect_with_sparsity(excitatory_layer_ID, inhibitory_layer_ID, EXC_NEURON_PARAMS, INH_NEURON_PARAMS, EXC_OUT_SYN_PARAMS, sparseness, BenchModel);
+  if (plastic)
+    EXC_OUT_SYN_PARAMS->plasticity_vec.push_back(weightdependent_stdp);
+  connect_with_sparsity(excitatory_layer_ID, excitatory_layer_ID, EXC_NEURON_PARAMS, EXC_NEURON_PARAMS, EXC_OUT_SYN_PARAMS, sparseness, BenchModel);
+  connect_with_sparsity(inhibitory_layer_ID, excitatory_layer_ID, INH_NEURON_PARAMS, EXC_NEURON_PARAMS, INH_OUT_SYN_PARAMS, sparseness, BenchModel);
+  connect_with_sparsity(inhibitory_layer_ID, inhibitory_layer_ID, INH_NEURON_PARAMS, INH_NEURON_PARAMS, INH_OUT_SYN_PARAMS, sparseness, BenchModel);
+
+  BenchModel->finalise_model();
+  BenchModel->enable_profiling(profile);
+
+  /*
+    RUN SIMULATION
+  */
+  auto starttime = std::chrono::steady_clock::now();
+  BenchModel->run(simtime);
+  double totaltime = std::chrono::duration<double>(std::chrono::steady_clock::now() - starttime).count();
+
+  long long number_of_steps = BenchModel->current_time_in_timesteps / BenchModel->timestep_grouping;
+  printf("Simulated %fs in %fs wall time\n", simtime, totaltime);
+  printf("%lld steps of %d timestep(s), %f us per step\n", number_of_steps, BenchModel->timestep_grouping, 1.0e6*totaltime/number_of_steps);
+  if (!fast)
+    printf("%d spikes\n", spike_monitor->total_number_of_spikes_stored_on_host);
+  return(0);
+}
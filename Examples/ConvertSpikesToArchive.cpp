@@ -0,0 +1,28 @@
+// Converts a SpikeIDs.bin/SpikeTimes.bin pair, as written by
+// SpikingActivityMonitor::save_spikes_as_binary, into a compressed and
+// indexed spike archive (see Spike/ActivityMonitor/SpikeArchive.hpp).
+//
+// Usage: ConvertSpikesToArchive SpikeIDs.bin SpikeTimes.bin output timestep [timesteps_per_block]
+
+#include "Spike/ActivityMonitor/SpikeArchive.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main (int argc, char *argv[]){
+  if ((argc < 5) || (argc > 6)){
+    printf("Usage: %s SpikeIDs.bin SpikeTimes.bin output timestep [timesteps_per_block]\n", argv[0]);
+    return 1;
+  }
+  float timestep = atof(argv[4]);
+  int timesteps_per_block = (argc > 5) ? atoi(argv[5]) : 1000;
+  if (timestep <= 0.0f){
+    printf("The timestep must be positive.\n");
+    return 1;
+  }
+
+  convert_spike_binaries_to_archive(argv[1], argv[2], argv[3], timestep, timesteps_per_block);
+
+  SpikeArchiveReader archive(argv[3]);
+  printf("Wrote %lld spikes in %d blocks to %s\n", archive.total_number_of_spikes, (int)archive.index.size(), argv[3]);
+  return 0;
+}
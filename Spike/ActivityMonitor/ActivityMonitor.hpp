@@ -37,6 +37,8 @@ public:
   virtual void state_update(unsigned int current_time_in_timesteps, float timestep) = 0;
   virtual void final_update(unsigned int current_time_in_timesteps, float timestep) = 0;
   virtual void reset_state() = 0;
+  // Called by SpikingModel::run_schedule as each stimulus presentation starts
+  virtual void begin_presentation(unsigned int current_time_in_timesteps, float timestep) {}
 
 private:
   std::shared_ptr<::Backend::ActivityMonitor> _backend;
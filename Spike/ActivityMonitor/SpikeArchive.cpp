@@ -0,0 +1,264 @@
+#include "SpikeArchive.hpp"
+#include "../Helpers/TerminalHelpers.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char spike_archive_magic[8] = {'S','P','K','A','R','C','H','1'};
+static const char spike_archive_index_magic[8] = {'S','P','K','I','N','D','E','X'};
+static const uint32_t spike_archive_version = 1;
+static const int spike_archive_footer_size = 3*sizeof(uint64_t) + 8;
+
+static void append_varint(std::vector<unsigned char>& out, uint64_t value) {
+  while (value >= 0x80){
+    out.push_back((unsigned char)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((unsigned char)value);
+}
+
+static uint64_t read_varint(const std::vector<unsigned char>& in, size_t& pos) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7){
+    if (pos >= in.size())
+      print_message_and_exit("Corrupt spike archive block.");
+    unsigned char byte = in[pos++];
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+  print_message_and_exit("Corrupt spike archive block.");
+  return 0;
+}
+
+template <typename T>
+static void write_value(std::ofstream& file, T value) {
+  file.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+static T read_value(std::ifstream& file) {
+  T value;
+  file.read((char*)&value, sizeof(T));
+  return value;
+}
+
+
+SpikeArchiveWriter::SpikeArchiveWriter(std::string filename_parameter, float timestep_parameter, int timesteps_per_block_parameter) {
+  filename = filename_parameter;
+  timestep = timestep_parameter;
+  timesteps_per_block = (timesteps_per_block_parameter < 1) ? 1 : timesteps_per_block_parameter;
+
+  file.open(filename, std::ios::out | std::ios::binary);
+  if (!file.is_open())
+    print_message_and_exit(("Could not open spike archive " + filename + " for writing.").c_str());
+  file.write(spike_archive_magic, 8);
+  write_value<uint32_t>(file, spike_archive_version);
+  write_value<uint32_t>(file, timesteps_per_block);
+  write_value<float>(file, timestep);
+  file_offset = 8 + 2*sizeof(uint32_t) + sizeof(float);
+}
+
+SpikeArchiveWriter::~SpikeArchiveWriter() {
+  close();
+}
+
+void SpikeArchiveWriter::append(const int* neuron_ids, const float* spike_times, int count) {
+  for (int i = 0; i < count; i++){
+    int64_t spike_timestep = llround((double)spike_times[i] / timestep);
+    int64_t block = spike_timestep / timesteps_per_block;
+    if ((neuron_ids[i] < 0) || (spike_timestep < 0))
+      print_message_and_exit("Spike archives can only hold non-negative neuron ids and spike times.");
+    if (block < first_open_block)
+      print_message_and_exit("Spike appended to a spike archive block which has already been written. Spikes must be appended in (approximate) time order.");
+    pending_spikes.emplace_back(spike_timestep, neuron_ids[i]);
+    latest_block = std::max(latest_block, block);
+  }
+  total_number_of_spikes += count;
+
+  // The block before the latest may still receive spikes, earlier ones are done
+  if (latest_block - 1 > first_open_block)
+    write_blocks_before(latest_block - 1);
+}
+
+void SpikeArchiveWriter::write_blocks_before(int64_t block) {
+  int64_t block_start_timestep = block*timesteps_per_block;
+  auto done = std::partition(pending_spikes.begin(), pending_spikes.end(),
+                             [&](const std::pair<int64_t, int>& spike){ return spike.first < block_start_timestep; });
+  std::sort(pending_spikes.begin(), done);
+
+  auto begin = pending_spikes.begin();
+  while (begin != done){
+    int64_t first_timestep = (begin->first / timesteps_per_block)*timesteps_per_block;
+    auto end = begin;
+    while ((end != done) && (end->first < first_timestep + timesteps_per_block))
+      end++;
+
+    spike_archive_block_index entry;
+    entry.first_timestep = first_timestep;
+    entry.offset = file_offset;
+    entry.number_of_spikes = end - begin;
+    entry.min_neuron = begin->second;
+    entry.max_neuron = begin->second;
+
+    encoded.clear();
+    int64_t previous_timestep = first_timestep;
+    for (auto spike = begin; spike != end; ){
+      auto same_timestep = spike;
+      while ((same_timestep != end) && (same_timestep->first == spike->first))
+        same_timestep++;
+      append_varint(encoded, spike->first - previous_timestep);
+      append_varint(encoded, same_timestep - spike);
+      previous_timestep = spike->first;
+      int previous_neuron = 0;
+      for (; spike != same_timestep; spike++){
+        append_varint(encoded, spike->second - previous_neuron);
+        previous_neuron = spike->second;
+        entry.min_neuron = std::min(entry.min_neuron, spike->second);
+        entry.max_neuron = std::max(entry.max_neuron, spike->second);
+      }
+    }
+    entry.bytes = encoded.size();
+    file.write((const char*)encoded.data(), encoded.size());
+    file_offset += encoded.size();
+    index.push_back(entry);
+    begin = end;
+  }
+
+  pending_spikes.erase(pending_spikes.begin(), done);
+  first_open_block = std::max(first_open_block, block);
+}
+
+void SpikeArchiveWriter::close() {
+  if (closed)
+    return;
+  closed = true;
+  write_blocks_before(latest_block + 1);
+
+  uint64_t index_offset = file_offset;
+  for (auto& entry : index){
+    write_value<int64_t>(file, entry.first_timestep);
+    write_value<uint64_t>(file, entry.offset);
+    write_value<uint32_t>(file, entry.bytes);
+    write_value<uint32_t>(file, entry.number_of_spikes);
+    write_value<int32_t>(file, entry.min_neuron);
+    write_value<int32_t>(file, entry.max_neuron);
+  }
+  write_value<uint64_t>(file, index_offset);
+  write_value<uint64_t>(file, index.size());
+  write_value<uint64_t>(file, total_number_of_spikes);
+  file.write(spike_archive_index_magic, 8);
+  file.close();
+  if (!file)
+    print_message_and_exit(("Failed writing spike archive " + filename + ".").c_str());
+}
+
+
+SpikeArchiveReader::SpikeArchiveReader(std::string filename_parameter) {
+  filename = filename_parameter;
+  file.open(filename, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    print_message_and_exit(("Could not open spike archive " + filename + ".").c_str());
+
+  char magic[8];
+  file.read(magic, 8);
+  if (!file || memcmp(magic, spike_archive_magic, 8) != 0)
+    print_message_and_exit((filename + " is not a spike archive.").c_str());
+  if (read_value<uint32_t>(file) != spike_archive_version)
+    print_message_and_exit(("Unsupported spike archive version in " + filename + ".").c_str());
+  timesteps_per_block = read_value<uint32_t>(file);
+  timestep = read_value<float>(file);
+
+  file.seekg(-spike_archive_footer_size, std::ios::end);
+  uint64_t index_offset = read_value<uint64_t>(file);
+  uint64_t number_of_blocks = read_value<uint64_t>(file);
+  total_number_of_spikes = read_value<uint64_t>(file);
+  file.read(magic, 8);
+  if (!file || memcmp(magic, spike_archive_index_magic, 8) != 0)
+    print_message_and_exit(("Spike archive " + filename + " has no index (was it closed?).").c_str());
+
+  file.seekg(index_offset);
+  index.resize(number_of_blocks);
+  for (auto& entry : index){
+    entry.first_timestep = read_value<int64_t>(file);
+    entry.offset = read_value<uint64_t>(file);
+    entry.bytes = read_value<uint32_t>(file);
+    entry.number_of_spikes = read_value<uint32_t>(file);
+    entry.min_neuron = read_value<int32_t>(file);
+    entry.max_neuron = read_value<int32_t>(file);
+  }
+  if (!file)
+    print_message_and_exit(("Corrupt spike archive index in " + filename + ".").c_str());
+}
+
+void SpikeArchiveReader::read_spikes(int first_neuron, int last_neuron, float start_time, float end_time,
+                                     std::vector<int>& neuron_ids, std::vector<float>& spike_times) {
+  // Blocks are selected with a timestep of slack, spikes by their exact time
+  double first_timestep = std::floor((double)start_time / timestep) - 1;
+  double last_timestep = std::ceil((double)end_time / timestep) + 1;
+
+  for (auto& entry : index){
+    if ((entry.first_timestep + timesteps_per_block <= first_timestep) || (entry.first_timestep > last_timestep))
+      continue;
+    if ((entry.max_neuron < first_neuron) || (entry.min_neuron > last_neuron))
+      continue;
+
+    encoded.resize(entry.bytes);
+    file.seekg(entry.offset);
+    file.read((char*)encoded.data(), entry.bytes);
+    if (!file)
+      print_message_and_exit(("Failed reading spike archive " + filename + ".").c_str());
+
+    size_t pos = 0;
+    int64_t spike_timestep = entry.first_timestep;
+    while (pos < encoded.size()){
+      spike_timestep += read_varint(encoded, pos);
+      uint64_t count = read_varint(encoded, pos);
+      float time = (float)spike_timestep*timestep;
+      bool in_window = (time >= start_time) && (time < end_time);
+      int neuron = 0;
+      for (uint64_t k = 0; k < count; k++){
+        neuron += (int)read_varint(encoded, pos);
+        if (in_window && (neuron >= first_neuron) && (neuron <= last_neuron)){
+          neuron_ids.push_back(neuron);
+          spike_times.push_back(time);
+        }
+      }
+    }
+  }
+}
+
+void SpikeArchiveReader::read_all_spikes(std::vector<int>& neuron_ids, std::vector<float>& spike_times) {
+  neuron_ids.reserve(neuron_ids.size() + total_number_of_spikes);
+  spike_times.reserve(spike_times.size() + total_number_of_spikes);
+  read_spikes(0, INT32_MAX, 0.0f, INFINITY, neuron_ids, spike_times);
+}
+
+
+void convert_spike_binaries_to_archive(std::string spike_ids_filename,
+                                       std::string spike_times_filename,
+                                       std::string archive_filename,
+                                       float timestep,
+                                       int timesteps_per_block) {
+  std::ifstream spikeidfile(spike_ids_filename, std::ios::in | std::ios::binary);
+  std::ifstream spiketimesfile(spike_times_filename, std::ios::in | std::ios::binary);
+  if (!spikeidfile.is_open() || !spiketimesfile.is_open())
+    print_message_and_exit(("Could not open " + spike_ids_filename + " or " + spike_times_filename + ".").c_str());
+
+  SpikeArchiveWriter writer(archive_filename, timestep, timesteps_per_block);
+  const int spikes_per_read = 1 << 20;
+  std::vector<int> neuron_ids(spikes_per_read);
+  std::vector<float> spike_times(spikes_per_read);
+  while (true){
+    spikeidfile.read((char*)neuron_ids.data(), spikes_per_read*sizeof(int));
+    spiketimesfile.read((char*)spike_times.data(), spikes_per_read*sizeof(float));
+    int ids_read = spikeidfile.gcount() / sizeof(int);
+    int times_read = spiketimesfile.gcount() / sizeof(float);
+    if (ids_read != times_read)
+      print_message_and_exit("Spike id and spike time files hold different numbers of spikes.");
+    if (ids_read == 0)
+      break;
+    writer.append(neuron_ids.data(), spike_times.data(), ids_read);
+  }
+  writer.close();
+}
@@ -0,0 +1,101 @@
+#ifndef SpikeArchive_H
+#define SpikeArchive_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Compressed spike raster file.
+ *
+ * Spikes are grouped into blocks of timesteps_per_block timesteps. Within a
+ * block the spikes are ordered by (timestep, neuron id) and stored as varints:
+ * for every timestep with spikes, the timestep delta to the previous such
+ * timestep and the number of spikes, followed by the delta encoded neuron ids.
+ * An index of the non-empty blocks (first timestep, byte range, spike count
+ * and neuron id range) is written at the end of the file, so a reader only
+ * needs the blocks which overlap the requested time window and neuron range.
+ *
+ * Layout (little endian):
+ *   header: "SPKARCH1", uint32 version, uint32 timesteps_per_block, float timestep
+ *   blocks
+ *   index:  per block {int64 first_timestep, uint64 offset, uint32 bytes,
+ *                      uint32 number_of_spikes, int32 min_neuron, int32 max_neuron}
+ *   footer: uint64 index_offset, uint64 number_of_blocks, uint64 number_of_spikes, "SPKINDEX"
+ *
+ * Spike times are stored as whole timesteps and read back as timestep*timestep
+ * (in float), which reproduces the times recorded by SpikingActivityMonitor.
+ */
+
+struct spike_archive_block_index {
+  int64_t first_timestep;
+  uint64_t offset;
+  uint32_t bytes;
+  uint32_t number_of_spikes;
+  int32_t min_neuron;
+  int32_t max_neuron;
+};
+
+
+class SpikeArchiveWriter {
+public:
+  SpikeArchiveWriter(std::string filename, float timestep, int timesteps_per_block=1000);
+  ~SpikeArchiveWriter();
+
+  // Spikes may arrive out of order by up to timesteps_per_block timesteps
+  void append(const int* neuron_ids, const float* spike_times, int count);
+  // Writes the remaining blocks and the index
+  void close();
+
+  long long total_number_of_spikes = 0;
+
+private:
+  std::ofstream file;
+  std::string filename;
+  float timestep;
+  int timesteps_per_block;
+  bool closed = false;
+
+  std::vector<std::pair<int64_t, int>> pending_spikes;  // (timestep, neuron id)
+  int64_t latest_block = 0;
+  int64_t first_open_block = 0;
+  uint64_t file_offset = 0;
+  std::vector<spike_archive_block_index> index;
+  std::vector<unsigned char> encoded;
+
+  void write_blocks_before(int64_t block);
+};
+
+
+class SpikeArchiveReader {
+public:
+  SpikeArchiveReader(std::string filename);
+
+  float timestep;
+  int timesteps_per_block;
+  long long total_number_of_spikes;
+  std::vector<spike_archive_block_index> index;
+
+  // Appends, in time order, the spikes of neurons [first_neuron, last_neuron]
+  // with start_time <= time < end_time (in seconds)
+  void read_spikes(int first_neuron, int last_neuron, float start_time, float end_time,
+                   std::vector<int>& neuron_ids, std::vector<float>& spike_times);
+  void read_all_spikes(std::vector<int>& neuron_ids, std::vector<float>& spike_times);
+
+private:
+  std::ifstream file;
+  std::string filename;
+  std::vector<unsigned char> encoded;
+};
+
+
+// Converts a SpikeIDs.bin/SpikeTimes.bin pair (see SpikingActivityMonitor::save_spikes_as_binary)
+void convert_spike_binaries_to_archive(std::string spike_ids_filename,
+                                       std::string spike_times_filename,
+                                       std::string archive_filename,
+                                       float timestep,
+                                       int timesteps_per_block=1000);
+
+#endif
@@ -0,0 +1,176 @@
+#include "SpikeStreamReader.hpp"
+#include "../Helpers/TerminalHelpers.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+SpikeStreamReader::SpikeStreamReader(std::string spike_ids_filename, std::string spike_times_filename, int spikes_per_chunk_parameter, float look_ahead_in_seconds_parameter) {
+  look_ahead_in_seconds = look_ahead_in_seconds_parameter;
+  spikes_per_chunk = (spikes_per_chunk_parameter < 1) ? 1 : spikes_per_chunk_parameter;
+  filename = spike_ids_filename + " and " + spike_times_filename;
+
+  spikeidfile.open(spike_ids_filename, std::ios::in | std::ios::binary);
+  spiketimesfile.open(spike_times_filename, std::ios::in | std::ios::binary);
+  if (!spikeidfile.is_open() || !spiketimesfile.is_open())
+    print_message_and_exit(("Could not open " + spike_ids_filename + " or " + spike_times_filename + ".").c_str());
+
+  spikeidfile.seekg(0, std::ios::end);
+  spiketimesfile.seekg(0, std::ios::end);
+  long long id_bytes = spikeidfile.tellg();
+  long long time_bytes = spiketimesfile.tellg();
+  if ((id_bytes != time_bytes) || (id_bytes % sizeof(int) != 0))
+    print_message_and_exit(("The spike files " + filename + " hold different numbers of spikes.").c_str());
+  total_number_of_spikes = id_bytes / sizeof(int);
+  // The last spikes may be slightly out of order, so the latest is looked for in the last chunk
+  long long spikes_in_last_chunk = std::min<long long>(total_number_of_spikes, spikes_per_chunk);
+  if (spikes_in_last_chunk > 0){
+    std::vector<float> last_spike_times(spikes_in_last_chunk);
+    spiketimesfile.seekg(-spikes_in_last_chunk*(long long)sizeof(float), std::ios::end);
+    spiketimesfile.read((char*)last_spike_times.data(), spikes_in_last_chunk*sizeof(float));
+    time_of_last_spike = *std::max_element(last_spike_times.begin(), last_spike_times.end());
+  }
+
+  rewind();
+}
+
+SpikeStreamReader::~SpikeStreamReader() {
+  stop_reader();
+}
+
+void SpikeStreamReader::rewind() {
+  stop_reader();
+  window_neuron_ids.clear();
+  window_spike_times.clear();
+  window_start = 0;
+  earliest_asked_for = -INFINITY;
+  latest_asked_for = -INFINITY;
+  all_chunks_taken = false;
+  chunk_ready = false;
+  end_of_file = false;
+  stopping = false;
+  spikeidfile.clear();
+  spiketimesfile.clear();
+  spikeidfile.seekg(0);
+  spiketimesfile.seekg(0);
+  start_reader();
+}
+
+void SpikeStreamReader::start_reader() {
+  reader = std::thread(&SpikeStreamReader::reader_loop, this);
+}
+
+void SpikeStreamReader::stop_reader() {
+  if (!reader.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+  reader.join();
+}
+
+void SpikeStreamReader::reader_loop() {
+  std::vector<int> neuron_ids;
+  std::vector<float> spike_times;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true){
+    changed.wait(lock, [&]{ return !chunk_ready || stopping; });
+    if (stopping)
+      return;
+    lock.unlock();
+
+    neuron_ids.resize(spikes_per_chunk);
+    spike_times.resize(spikes_per_chunk);
+    spikeidfile.read((char*)neuron_ids.data(), spikes_per_chunk*sizeof(int));
+    spiketimesfile.read((char*)spike_times.data(), spikes_per_chunk*sizeof(float));
+    long long ids_read = spikeidfile.gcount() / sizeof(int);
+    long long times_read = spiketimesfile.gcount() / sizeof(float);
+    neuron_ids.resize(ids_read);
+    spike_times.resize(times_read);
+
+    lock.lock();
+    if (ids_read != times_read)
+      read_failed = true;
+    if (read_failed || (ids_read == 0)){
+      end_of_file = true;
+      changed.notify_all();
+      return;
+    }
+    std::swap(neuron_ids, chunk_neuron_ids);
+    std::swap(spike_times, chunk_spike_times);
+    chunk_ready = true;
+    changed.notify_all();
+  }
+}
+
+bool SpikeStreamReader::take_chunk() {
+  std::vector<int> neuron_ids;
+  std::vector<float> spike_times;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&]{ return chunk_ready || end_of_file; });
+    if (read_failed)
+      print_message_and_exit(("Failed reading spikes from " + filename + ".").c_str());
+    if (!chunk_ready){
+      all_chunks_taken = true;
+      return false;
+    }
+    std::swap(neuron_ids, chunk_neuron_ids);
+    std::swap(spike_times, chunk_spike_times);
+    chunk_ready = false;
+  }
+  changed.notify_all();
+
+  // The spikes before window_start are no longer needed
+  window_neuron_ids.erase(window_neuron_ids.begin(), window_neuron_ids.begin() + window_start);
+  window_spike_times.erase(window_spike_times.begin(), window_spike_times.begin() + window_start);
+  window_start = 0;
+
+  size_t first_new_spike = window_spike_times.size();
+  window_neuron_ids.insert(window_neuron_ids.end(), neuron_ids.begin(), neuron_ids.end());
+  window_spike_times.insert(window_spike_times.end(), spike_times.begin(), spike_times.end());
+  // A spike which an earlier call should have returned has been missed
+  if (*std::min_element(spike_times.begin(), spike_times.end()) - latest_asked_for < timestep_of_last_call)
+    print_message_and_exit(("The spikes in " + filename + " are out of time order by more than the look-ahead of the reader.").c_str());
+
+  // Spikes slightly out of order are sorted within the window (stable, as for in-memory stimuli)
+  size_t check_from = (first_new_spike > 0) ? (first_new_spike - 1) : 0;
+  if (!std::is_sorted(window_spike_times.begin() + check_from, window_spike_times.end())){
+    std::vector<size_t> order(window_spike_times.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return window_spike_times[a] < window_spike_times[b]; });
+    std::vector<int> sorted_neuron_ids(order.size());
+    std::vector<float> sorted_spike_times(order.size());
+    for (size_t i = 0; i < order.size(); i++){
+      sorted_neuron_ids[i] = window_neuron_ids[order[i]];
+      sorted_spike_times[i] = window_spike_times[order[i]];
+    }
+    window_neuron_ids.swap(sorted_neuron_ids);
+    window_spike_times.swap(sorted_spike_times);
+  }
+  return true;
+}
+
+int SpikeStreamReader::spikes_due(float earliest, float latest, float timestep, const int*& neuron_ids, const float*& spike_times) {
+  if (earliest < earliest_asked_for)
+    rewind();
+
+  // Spikes (even out of order ones) up to the look-ahead past latest are in the window
+  float look_ahead = std::max(timestep, look_ahead_in_seconds);
+  while (!all_chunks_taken && ((window_start == window_spike_times.size()) || (window_spike_times.back() - latest < look_ahead))){
+    if (!take_chunk())
+      break;
+  }
+  while ((window_start < window_spike_times.size()) && (earliest - window_spike_times[window_start] >= timestep))
+    window_start++;
+  earliest_asked_for = earliest;
+  latest_asked_for = latest;
+  timestep_of_last_call = timestep;
+
+  auto end = std::partition_point(window_spike_times.begin() + window_start, window_spike_times.end(),
+                                  [&](float spike_time){ return spike_time - latest < timestep; });
+  neuron_ids = window_neuron_ids.data() + window_start;
+  spike_times = window_spike_times.data() + window_start;
+  return end - (window_spike_times.begin() + window_start);
+}
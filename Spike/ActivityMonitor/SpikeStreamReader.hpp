@@ -0,0 +1,79 @@
+#ifndef SpikeStreamReader_H
+#define SpikeStreamReader_H
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Reads a SpikeIDs.bin/SpikeTimes.bin pair (as written by
+ * SpikingActivityMonitor::save_spikes_as_binary or SpikeStreamWriter) in time
+ * order with bounded memory, for replaying long recordings as input (see
+ * GeneratorInputSpikingNeurons::add_stimulus_from_binary).
+ *
+ * A background thread reads the files ahead one chunk at a time. Spikes are
+ * kept in a window which starts at the first spike which may still be due
+ * and ends within a chunk of the look-ahead past the latest time asked for.
+ * Memory use is therefore about two chunks plus the spikes of the window,
+ * however long the files are.
+ *
+ * The files must be in time order, but spikes may be out of order by up to
+ * look_ahead_in_seconds (recordings made with timestep grouping are slightly
+ * out of order): the window always extends that far past the latest time
+ * asked for. A spike which arrives after its time has been played is an error.
+ */
+class SpikeStreamReader {
+public:
+  SpikeStreamReader(std::string spike_ids_filename, std::string spike_times_filename, int spikes_per_chunk=(1 << 20), float look_ahead_in_seconds=0.01f);
+  ~SpikeStreamReader();
+
+  long long total_number_of_spikes = 0;
+  float time_of_last_spike = 0.0f;  /**< The latest spike time (of the last chunk) */
+
+  // Starts again from the first spike
+  void rewind();
+  /**
+   *  Points neuron_ids/spike_times at the spikes with
+   *  earliest - timestep < time < latest + timestep (in time order) and returns
+   *  their number. Spikes earlier than that are dropped. Asking for an earlier
+   *  time than the previous call rewinds the files.
+   */
+  int spikes_due(float earliest, float latest, float timestep, const int*& neuron_ids, const float*& spike_times);
+
+private:
+  std::string filename;
+  std::ifstream spikeidfile, spiketimesfile;
+  int spikes_per_chunk;
+  float look_ahead_in_seconds;
+
+  // The window of spikes, from window_start on
+  std::vector<int> window_neuron_ids;
+  std::vector<float> window_spike_times;
+  size_t window_start = 0;
+  float earliest_asked_for;
+  float latest_asked_for;
+  float timestep_of_last_call = 0.0f;
+  bool all_chunks_taken = false;
+
+  // Chunk read ahead by the reader thread
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<int> chunk_neuron_ids;
+  std::vector<float> chunk_spike_times;
+  bool chunk_ready = false;
+  bool end_of_file = false;
+  bool read_failed = false;
+  bool stopping = false;
+  std::thread reader;
+
+  void start_reader();
+  void stop_reader();
+  void reader_loop();
+  // Appends the read-ahead chunk to the window, returns false at the end of the files
+  bool take_chunk();
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "SpikeStreamWriter.hpp"
+#include "../Helpers/TerminalHelpers.hpp"
+#include <algorithm>
+
+SpikeStreamWriter::SpikeStreamWriter(std::string path, std::string prefix, int spikes_per_chunk_parameter) {
+  spikes_per_chunk = (spikes_per_chunk_parameter < 1) ? 1 : spikes_per_chunk_parameter;
+  filename = path + "/" + prefix;
+
+  spikeidfile.open((filename + "SpikeIDs.bin"), std::ios::out | std::ios::binary);
+  spiketimesfile.open((filename + "SpikeTimes.bin"), std::ios::out | std::ios::binary);
+  if (!spikeidfile.is_open() || !spiketimesfile.is_open())
+    print_message_and_exit(("Could not open " + filename + "SpikeIDs.bin/SpikeTimes.bin for streaming spikes.").c_str());
+
+  for (int c = 0; c < 2; c++){
+    chunk_neuron_ids[c].resize(spikes_per_chunk);
+    chunk_spike_times[c].resize(spikes_per_chunk);
+  }
+  writer = std::thread(&SpikeStreamWriter::writer_loop, this);
+}
+
+SpikeStreamWriter::~SpikeStreamWriter() {
+  flush();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+  writer.join();
+  spikeidfile.close();
+  spiketimesfile.close();
+}
+
+void SpikeStreamWriter::append(const int* neuron_ids, const float* spike_times, int count) {
+  while (count > 0){
+    int n = std::min(count, spikes_per_chunk - spikes_in_filling_chunk);
+    std::copy(neuron_ids, neuron_ids + n, &chunk_neuron_ids[filling_chunk][spikes_in_filling_chunk]);
+    std::copy(spike_times, spike_times + n, &chunk_spike_times[filling_chunk][spikes_in_filling_chunk]);
+    spikes_in_filling_chunk += n;
+    total_number_of_spikes_appended += n;
+    neuron_ids += n;
+    spike_times += n;
+    count -= n;
+    if (spikes_in_filling_chunk == spikes_per_chunk)
+      submit_chunk();
+  }
+}
+
+void SpikeStreamWriter::flush() {
+  if (spikes_in_filling_chunk > 0)
+    submit_chunk();
+  std::unique_lock<std::mutex> lock(mutex);
+  wait_for_writer(lock);
+  spikeidfile.flush();
+  spiketimesfile.flush();
+}
+
+void SpikeStreamWriter::submit_chunk() {
+  std::unique_lock<std::mutex> lock(mutex);
+  // The other chunk becomes the filling chunk, so it must have been written
+  wait_for_writer(lock);
+  chunk_pending = true;
+  pending_chunk = filling_chunk;
+  spikes_in_pending_chunk = spikes_in_filling_chunk;
+  lock.unlock();
+  changed.notify_all();
+
+  filling_chunk = 1 - filling_chunk;
+  spikes_in_filling_chunk = 0;
+}
+
+void SpikeStreamWriter::wait_for_writer(std::unique_lock<std::mutex>& lock) {
+  changed.wait(lock, [&]{ return !chunk_pending; });
+  if (write_failed)
+    print_message_and_exit(("Failed writing streamed spikes to " + filename + "SpikeIDs.bin/SpikeTimes.bin.").c_str());
+}
+
+void SpikeStreamWriter::writer_loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true){
+    changed.wait(lock, [&]{ return chunk_pending || stopping; });
+    if (!chunk_pending)
+      return;
+    int chunk = pending_chunk;
+    int count = spikes_in_pending_chunk;
+    lock.unlock();
+
+    spikeidfile.write((char *)chunk_neuron_ids[chunk].data(), count*sizeof(int));
+    spiketimesfile.write((char *)chunk_spike_times[chunk].data(), count*sizeof(float));
+    bool failed = !spikeidfile || !spiketimesfile;
+
+    lock.lock();
+    write_failed = write_failed || failed;
+    chunk_pending = false;
+    changed.notify_all();
+  }
+}
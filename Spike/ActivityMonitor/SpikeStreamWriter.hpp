@@ -0,0 +1,57 @@
+#ifndef SpikeStreamWriter_H
+#define SpikeStreamWriter_H
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Appends spikes to path/prefix{SpikeIDs,SpikeTimes}.bin (the format written by
+ * SpikingActivityMonitor::save_spikes_as_binary) from a background thread.
+ *
+ * Spikes are gathered into one of two fixed size chunks. A full chunk is handed
+ * to the writer thread while the other one is filled; the simulation only waits
+ * if it fills a chunk before the writer has finished with the previous one, so
+ * memory use never exceeds two chunks however long the simulation runs.
+ */
+class SpikeStreamWriter {
+public:
+  SpikeStreamWriter(std::string path, std::string prefix, int spikes_per_chunk);
+  ~SpikeStreamWriter();
+
+  // Copies count spikes into the current chunk, handing over chunks as they fill
+  void append(const int* neuron_ids, const float* spike_times, int count);
+  // Hands over any partly filled chunk and waits until everything is on disk
+  void flush();
+
+  long long total_number_of_spikes_appended = 0;
+
+private:
+  std::ofstream spikeidfile, spiketimesfile;
+  std::string filename;
+
+  int spikes_per_chunk;
+  std::vector<int> chunk_neuron_ids[2];
+  std::vector<float> chunk_spike_times[2];
+  int filling_chunk = 0;
+  int spikes_in_filling_chunk = 0;
+
+  // Chunk handed to the writer thread
+  std::mutex mutex;
+  std::condition_variable changed;
+  bool chunk_pending = false;
+  int pending_chunk = 0;
+  int spikes_in_pending_chunk = 0;
+  bool write_failed = false;
+  bool stopping = false;
+  std::thread writer;
+
+  void submit_chunk();
+  void wait_for_writer(std::unique_lock<std::mutex>& lock);
+  void writer_loop();
+};
+
+#endif
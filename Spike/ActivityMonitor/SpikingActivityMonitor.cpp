@@ -1,4 +1,5 @@
 #include "SpikingActivityMonitor.hpp"
+#include "../Helpers/Checkpoint.hpp"
 #include <stdlib.h>
 #include <iostream>
 #include <stdio.h>
@@ -6,6 +7,7 @@
 #include "../Helpers/TerminalHelpers.hpp"
 #include <string>
 #include <time.h>
+#include <algorithm>
 using namespace std;
 
 // SpikingActivityMonitor Constructor
@@ -15,6 +17,9 @@ SpikingActivityMonitor::SpikingActivityMonitor(SpikingNeurons * neurons_paramete
   // Variables
   size_of_device_spike_store = 0;
   total_number_of_spikes_stored_on_host = 0;
+  timesteps_since_device_spike_count_check = 0;
+  maximum_spikes_between_device_spike_count_checks = 0;
+  size_of_host_spike_staging = 0;
 
   // Host Pointers
   advanced_parameters = new spike_monitor_advanced_parameters();
@@ -34,6 +39,7 @@ SpikingActivityMonitor::SpikingActivityMonitor(SpikingNeurons * neurons_paramete
 
 // SpikingActivityMonitor Destructor
 SpikingActivityMonitor::~SpikingActivityMonitor() {
+  delete spike_stream_writer;
   free(neuron_ids_of_stored_spikes_on_host);
   free(spike_times_of_stored_spikes_on_host);
   free(total_number_of_spikes_stored_on_device);
@@ -43,7 +49,11 @@ SpikingActivityMonitor::~SpikingActivityMonitor() {
 }
 
 void SpikingActivityMonitor::prepare_backend_early() {
-  size_of_device_spike_store = advanced_parameters->device_spike_store_size_multiple_of_total_neurons * neurons->total_number_of_neurons;
+  // Leave room for every neuron to spike on every timestep between two spike count checks
+  int timesteps_between_checks = ((advanced_parameters->number_of_timesteps_per_device_spike_copy_check + model->timestep_grouping - 1) / model->timestep_grouping) * model->timestep_grouping;
+  int store_size_multiple = std::max(advanced_parameters->device_spike_store_size_multiple_of_total_neurons, timesteps_between_checks);
+  size_of_device_spike_store = store_size_multiple * neurons->total_number_of_neurons;
+  maximum_spikes_between_device_spike_count_checks = timesteps_between_checks * neurons->total_number_of_neurons;
   allocate_pointers_for_spike_store();
 }
 
@@ -62,6 +72,8 @@ void SpikingActivityMonitor::reset_state() {
   // Host values
   total_number_of_spikes_stored_on_host = 0;
   total_number_of_spikes_stored_on_device[0] = 0;
+  timesteps_since_device_spike_count_check = 0;
+  first_spike_of_each_presentation.clear();
   // Free/Clear Device stuff
   // Reset the number on the device
   backend()->reset_state();
@@ -78,26 +90,38 @@ void SpikingActivityMonitor::reset_state() {
 
 void SpikingActivityMonitor::copy_spikes_from_device_to_host_and_reset_device_spikes_if_device_spike_count_above_threshold(unsigned int current_time_in_timesteps, float timestep, bool force) {
 
-  if (((current_time_in_timesteps % (advanced_parameters->number_of_timesteps_per_device_spike_copy_check / model->timestep_grouping)) == 0) || force){
+  timesteps_since_device_spike_count_check += model->timestep_grouping;
+  if ((timesteps_since_device_spike_count_check >= advanced_parameters->number_of_timesteps_per_device_spike_copy_check) || force){
+    timesteps_since_device_spike_count_check = 0;
 
     // Finally, we want to get the spikes back. Every few timesteps check the number of spikes:
     backend()->copy_spikecount_to_front();
 
-    // Ensure that we don't have too many
-    if (total_number_of_spikes_stored_on_device[0] > size_of_device_spike_store){
-      print_message_and_exit("Spike recorder has been overloaded! Reduce threshold.");
-    }
-
-    // Deal with them!
-    if ((total_number_of_spikes_stored_on_device[0] >= (advanced_parameters->proportion_of_device_spike_store_full_before_copy * size_of_device_spike_store)) ||  force){
-
-      // Reallocate host spike arrays to accommodate for new device spikes.
-      neuron_ids_of_stored_spikes_on_host = (int*)realloc(neuron_ids_of_stored_spikes_on_host, sizeof(int)*(total_number_of_spikes_stored_on_host + total_number_of_spikes_stored_on_device[0]));
-      spike_times_of_stored_spikes_on_host = (float*)realloc(spike_times_of_stored_spikes_on_host, sizeof(float)*(total_number_of_spikes_stored_on_host + total_number_of_spikes_stored_on_device[0]));
-      // Copy device spikes into correct host array location
-      backend()->copy_spikes_to_front();
-
-      total_number_of_spikes_stored_on_host += total_number_of_spikes_stored_on_device[0];
+    // Deal with them! The device store is sized (see prepare_backend_early)
+    // such that it cannot overflow before the next check.
+    if ((total_number_of_spikes_stored_on_device[0] >= (advanced_parameters->proportion_of_device_spike_store_full_before_copy * size_of_device_spike_store)) ||
+        (total_number_of_spikes_stored_on_device[0] + maximum_spikes_between_device_spike_count_checks > size_of_device_spike_store) ||
+        force){
+
+      if (spike_stream_writer){
+        // The host arrays are only a staging area for the writer
+        if (total_number_of_spikes_stored_on_device[0] > size_of_host_spike_staging){
+          size_of_host_spike_staging = std::max(total_number_of_spikes_stored_on_device[0], size_of_device_spike_store);
+          neuron_ids_of_stored_spikes_on_host = (int*)realloc(neuron_ids_of_stored_spikes_on_host, sizeof(int)*size_of_host_spike_staging);
+          spike_times_of_stored_spikes_on_host = (float*)realloc(spike_times_of_stored_spikes_on_host, sizeof(float)*size_of_host_spike_staging);
+        }
+        total_number_of_spikes_stored_on_host = 0;
+        backend()->copy_spikes_to_front();
+        spike_stream_writer->append(neuron_ids_of_stored_spikes_on_host, spike_times_of_stored_spikes_on_host, total_number_of_spikes_stored_on_device[0]);
+      } else {
+        // Reallocate host spike arrays to accommodate for new device spikes.
+        neuron_ids_of_stored_spikes_on_host = (int*)realloc(neuron_ids_of_stored_spikes_on_host, sizeof(int)*(total_number_of_spikes_stored_on_host + total_number_of_spikes_stored_on_device[0]));
+        spike_times_of_stored_spikes_on_host = (float*)realloc(spike_times_of_stored_spikes_on_host, sizeof(float)*(total_number_of_spikes_stored_on_host + total_number_of_spikes_stored_on_device[0]));
+        // Copy device spikes into correct host array location
+        backend()->copy_spikes_to_front();
+
+        total_number_of_spikes_stored_on_host += total_number_of_spikes_stored_on_device[0];
+      }
 
 
       // Reset device spikes
@@ -113,13 +137,45 @@ void SpikingActivityMonitor::state_update(unsigned int current_time_in_timesteps
   copy_spikes_from_device_to_host_and_reset_device_spikes_if_device_spike_count_above_threshold(current_time_in_timesteps, timestep);
 }
 
+void SpikingActivityMonitor::begin_presentation(unsigned int current_time_in_timesteps, float timestep){
+  // Only the spike count is fetched, the spikes stay on the device
+  backend()->copy_spikecount_to_front();
+  long long spikes_before_device = spike_stream_writer ? spike_stream_writer->total_number_of_spikes_appended : total_number_of_spikes_stored_on_host;
+  first_spike_of_each_presentation.push_back(spikes_before_device + total_number_of_spikes_stored_on_device[0]);
+}
+
 void SpikingActivityMonitor::final_update(unsigned int current_time_in_timesteps, float timestep){
   copy_spikes_from_device_to_host_and_reset_device_spikes_if_device_spike_count_above_threshold(current_time_in_timesteps, timestep, true);
-  printf(" Number of Spikes Recorded: %d\n", total_number_of_spikes_stored_on_host);
+  if (spike_stream_writer){
+    // Streamed files are complete whenever run() returns
+    spike_stream_writer->flush();
+    printf(" Number of Spikes Recorded: %lld\n", spike_stream_writer->total_number_of_spikes_appended);
+  } else {
+    printf(" Number of Spikes Recorded: %d\n", total_number_of_spikes_stored_on_host);
+  }
+}
+
+
+void SpikingActivityMonitor::stream_spikes_to_binary(string path, string prefix, int spikes_per_chunk){
+  delete spike_stream_writer;
+  spike_stream_writer = new SpikeStreamWriter(path, prefix, spikes_per_chunk);
+
+  // Spikes recorded before streaming began go first
+  spike_stream_writer->append(neuron_ids_of_stored_spikes_on_host, spike_times_of_stored_spikes_on_host, total_number_of_spikes_stored_on_host);
+  free(neuron_ids_of_stored_spikes_on_host);
+  free(spike_times_of_stored_spikes_on_host);
+  neuron_ids_of_stored_spikes_on_host = nullptr;
+  spike_times_of_stored_spikes_on_host = nullptr;
+  total_number_of_spikes_stored_on_host = 0;
+  size_of_host_spike_staging = 0;
 }
 
 
 void SpikingActivityMonitor::save_spikes_as_txt(string path, string prefix){
+  if (spike_stream_writer){
+    printf("Spikes are being streamed to binary files and are not kept for save_spikes_as_txt.\n");
+    return;
+  }
   ofstream spikeidfile, spiketimesfile;
 
   // Open output files
@@ -137,6 +193,10 @@ void SpikingActivityMonitor::save_spikes_as_txt(string path, string prefix){
 }
 
 void SpikingActivityMonitor::save_spikes_as_binary(string path, string prefix){
+  if (spike_stream_writer){
+    printf("Spikes are being streamed to binary files and are not kept for save_spikes_as_binary.\n");
+    return;
+  }
   ofstream spikeidfile, spiketimesfile;
 
   // Open output files
@@ -149,7 +209,52 @@ void SpikingActivityMonitor::save_spikes_as_binary(string path, string prefix){
   // Close the files
   spikeidfile.close();
   spiketimesfile.close();
+
+  if (!first_spike_of_each_presentation.empty()){
+    ofstream presentationfile((path + "/" + prefix + "PresentationStarts.bin"), ios::out | ios::binary);
+    presentationfile.write((char *)first_spike_of_each_presentation.data(), first_spike_of_each_presentation.size()*sizeof(long long));
+  }
+}
+
+void SpikingActivityMonitor::save_spikes_as_archive(string path, string prefix, int timesteps_per_block){
+  if (spike_stream_writer){
+    printf("Spikes are being streamed to binary files and are not kept for save_spikes_as_archive.\n");
+    return;
+  }
+  SpikeArchiveWriter archive((path + "/" + prefix + "SpikeArchive.bin"), model->timestep, timesteps_per_block);
+  archive.append(neuron_ids_of_stored_spikes_on_host, spike_times_of_stored_spikes_on_host, total_number_of_spikes_stored_on_host);
+  archive.close();
 }
 
 
+
+void SpikingActivityMonitor::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  // When streaming, the recorded spikes are already on disk
+  int spikes_on_host = spike_stream_writer ? 0 : total_number_of_spikes_stored_on_host;
+  checkpoint.write(prefix + "/neuron_ids_of_stored_spikes_on_host", neuron_ids_of_stored_spikes_on_host, spikes_on_host*sizeof(int));
+  checkpoint.write(prefix + "/spike_times_of_stored_spikes_on_host", spike_times_of_stored_spikes_on_host, spikes_on_host*sizeof(float));
+  checkpoint.write_value(prefix + "/total_number_of_spikes_stored_on_device", total_number_of_spikes_stored_on_device[0]);
+  checkpoint.write_value(prefix + "/timesteps_since_device_spike_count_check", timesteps_since_device_spike_count_check);
+  checkpoint.write_vector(prefix + "/first_spike_of_each_presentation", first_spike_of_each_presentation);
+}
+
+void SpikingActivityMonitor::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  size_t bytes;
+  checkpoint.data(prefix + "/neuron_ids_of_stored_spikes_on_host", bytes);
+  int spikes_on_host = bytes / sizeof(int);
+  if (spike_stream_writer){
+    if (spikes_on_host > 0)
+      print_message_and_exit("Cannot restore recorded spikes into a monitor which streams its spikes.");
+  } else {
+    total_number_of_spikes_stored_on_host = spikes_on_host;
+    neuron_ids_of_stored_spikes_on_host = (int*)realloc(neuron_ids_of_stored_spikes_on_host, sizeof(int)*spikes_on_host);
+    spike_times_of_stored_spikes_on_host = (float*)realloc(spike_times_of_stored_spikes_on_host, sizeof(float)*spikes_on_host);
+    checkpoint.read(prefix + "/neuron_ids_of_stored_spikes_on_host", neuron_ids_of_stored_spikes_on_host, spikes_on_host*sizeof(int));
+    checkpoint.read(prefix + "/spike_times_of_stored_spikes_on_host", spike_times_of_stored_spikes_on_host, spikes_on_host*sizeof(float));
+  }
+  total_number_of_spikes_stored_on_device[0] = checkpoint.read_value<int>(prefix + "/total_number_of_spikes_stored_on_device");
+  timesteps_since_device_spike_count_check = checkpoint.read_value<int>(prefix + "/timesteps_since_device_spike_count_check");
+  checkpoint.read_vector(prefix + "/first_spike_of_each_presentation", first_spike_of_each_presentation);
+}
+
 SPIKE_MAKE_INIT_BACKEND(SpikingActivityMonitor);
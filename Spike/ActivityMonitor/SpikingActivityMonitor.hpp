@@ -3,6 +3,10 @@
 
 
 #include "../ActivityMonitor/ActivityMonitor.hpp"
+#include "SpikeStreamWriter.hpp"
+#include "SpikeArchive.hpp"
+
+#include <vector>
 
 class SpikingActivityMonitor; // forward definition
 
@@ -40,6 +44,9 @@ public:
   // Variables
   int size_of_device_spike_store;
   int total_number_of_spikes_stored_on_host;
+  int timesteps_since_device_spike_count_check;
+  int maximum_spikes_between_device_spike_count_checks;
+  int size_of_host_spike_staging;
 
   // Host Pointers
   SpikingNeurons * neurons;
@@ -50,6 +57,13 @@ public:
   int* reset_neuron_ids = nullptr;
   float* reset_neuron_times = nullptr;
 
+  // When streaming, the host arrays only hold the spikes of one device copy
+  SpikeStreamWriter* spike_stream_writer = nullptr;
+
+  // The index of the first spike recorded in each presentation of a
+  // stimulus schedule (see SpikingModel::run_schedule)
+  std::vector<long long> first_spike_of_each_presentation;
+
   // Constructor/Destructor
   SpikingActivityMonitor(SpikingNeurons * neurons_parameter);
   ~SpikingActivityMonitor() override;
@@ -62,11 +76,21 @@ public:
   void state_update(unsigned int current_time_in_timesteps, float timestep) override;
   void final_update(unsigned int current_time_in_timesteps, float timestep) override;
   void reset_state() override;
+  void begin_presentation(unsigned int current_time_in_timesteps, float timestep) override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
 
   void copy_spikes_from_device_to_host_and_reset_device_spikes_if_device_spike_count_above_threshold(unsigned int current_time_in_timesteps, float timestep, bool force=false);
 
   void save_spikes_as_txt(string path, string prefix="");
+  // Also writes prefixPresentationStarts.bin (first_spike_of_each_presentation) after a schedule
   void save_spikes_as_binary(string path, string prefix="");
+  // Compressed, indexed file readable with SpikeArchiveReader
+  void save_spikes_as_archive(string path, string prefix="", int timesteps_per_block=1000);
+
+  // Appends spikes to path/prefix{SpikeIDs,SpikeTimes}.bin from a background
+  // thread as they are recorded, instead of keeping them all in memory
+  void stream_spikes_to_binary(string path, string prefix="", int spikes_per_chunk=1048576);
 
 
 private:
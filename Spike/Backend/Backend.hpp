@@ -11,6 +11,9 @@
 #include <iostream>
 #endif
 
+class CheckpointWriter;
+class CheckpointReader;
+
 namespace Backend {
   class SpikeBackendBase {
   public:
@@ -22,6 +25,11 @@ namespace Backend {
     virtual ~SpikeBackendBase() = default;
     virtual void reset_state() = 0;
     virtual void prepare() = 0;
+
+    // Simulation state for checkpoints, in sections named prefix + "/..."
+    // (see SpikingModel::save_checkpoint). Called after prepare().
+    virtual void save_state(CheckpointWriter& checkpoint, const std::string& prefix) {}
+    virtual void load_state(const CheckpointReader& checkpoint, const std::string& prefix) {}
   };
 
   template<typename FrontT, typename BackT>
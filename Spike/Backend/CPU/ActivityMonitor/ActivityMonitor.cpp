@@ -0,0 +1,14 @@
+#include "ActivityMonitor.hpp"
+
+// SPIKE_EXPORT_BACKEND_TYPE(CPU, ActivityMonitor);
+
+namespace Backend {
+  namespace CPU {
+    void ActivityMonitor::prepare() {
+      pool = thread_pool(context);
+    }
+
+    void ActivityMonitor::reset_state() {
+    }
+  }
+}
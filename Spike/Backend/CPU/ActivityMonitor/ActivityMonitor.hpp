@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Spike/ActivityMonitor/ActivityMonitor.hpp"
+#include "Spike/Backend/CPU/CPUBackend.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class ActivityMonitor : public virtual ::Backend::ActivityMonitor {
+    public:
+      using ::Backend::ActivityMonitor::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      std::shared_ptr<ThreadPool> pool;
+    };
+  }
+}
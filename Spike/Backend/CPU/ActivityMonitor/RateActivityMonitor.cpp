@@ -0,0 +1,45 @@
+#include "RateActivityMonitor.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, RateActivityMonitor);
+
+namespace Backend {
+  namespace CPU {
+    void RateActivityMonitor::prepare() {
+      ActivityMonitor::prepare();
+      neurons_backend =
+        dynamic_cast<::Backend::CPU::SpikingNeurons*>(frontend()->neurons->backend());
+      per_neuron_spike_counts.resize(frontend()->neurons->total_number_of_neurons);
+    }
+
+    void RateActivityMonitor::reset_state() {
+      ActivityMonitor::reset_state();
+      std::fill(per_neuron_spike_counts.begin(), per_neuron_spike_counts.end(), 0);
+    }
+
+    void RateActivityMonitor::copy_spike_count_to_host() {
+      std::copy(per_neuron_spike_counts.begin(),
+                per_neuron_spike_counts.end(),
+                frontend()->per_neuron_spike_counts);
+    }
+
+    void RateActivityMonitor::add_spikes_to_per_neuron_spike_count
+    (unsigned int current_time_in_timesteps, float timestep) {
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      pool->parallel_for(per_neuron_spike_counts.size(), [&](int begin, int end, int block){
+        for (int idx = begin; idx < end; idx++)
+          for (int g = 0; g < timestep_grouping; g++)
+            if (neurons_backend->spiked(idx, neurons_backend->bitloc(current_time_in_timesteps + g)))
+              per_neuron_spike_counts[idx]++;
+      }, 1024);
+    }
+
+    void RateActivityMonitor::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      checkpoint.write_vector(prefix + "/per_neuron_spike_counts", per_neuron_spike_counts);
+    }
+
+    void RateActivityMonitor::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      checkpoint.read_vector_of_same_size(prefix + "/per_neuron_spike_counts", per_neuron_spike_counts);
+    }
+  }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Spike/ActivityMonitor/RateActivityMonitor.hpp"
+#include "ActivityMonitor.hpp"
+#include "Spike/Backend/CPU/Neurons/SpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class RateActivityMonitor :
+      public virtual ::Backend::CPU::ActivityMonitor,
+      public virtual ::Backend::RateActivityMonitor {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(RateActivityMonitor);
+      using ::Backend::RateActivityMonitor::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      std::vector<int> per_neuron_spike_counts;
+
+      void copy_spike_count_to_host() override;
+      void add_spikes_to_per_neuron_spike_count
+      (unsigned int current_time_in_timesteps, float timestep) override;
+
+    private:
+      ::Backend::CPU::SpikingNeurons* neurons_backend = nullptr;
+    };
+  }
+}
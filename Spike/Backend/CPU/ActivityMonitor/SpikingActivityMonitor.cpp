@@ -0,0 +1,73 @@
+#include "SpikingActivityMonitor.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, SpikingActivityMonitor);
+
+namespace Backend {
+  namespace CPU {
+    void SpikingActivityMonitor::prepare() {
+      ActivityMonitor::prepare();
+      neurons_backend =
+        dynamic_cast<::Backend::CPU::SpikingNeurons*>(frontend()->neurons->backend());
+      neuron_ids_of_stored_spikes.reserve(frontend()->size_of_device_spike_store);
+      time_in_seconds_of_stored_spikes.reserve(frontend()->size_of_device_spike_store);
+      block_neuron_ids.resize(pool->size());
+      block_spike_times.resize(pool->size());
+      reset_state();
+    }
+
+    void SpikingActivityMonitor::reset_state() {
+      ActivityMonitor::reset_state();
+      neuron_ids_of_stored_spikes.clear();
+      time_in_seconds_of_stored_spikes.clear();
+    }
+
+    void SpikingActivityMonitor::copy_spikecount_to_front() {
+      frontend()->total_number_of_spikes_stored_on_device[0] = neuron_ids_of_stored_spikes.size();
+    }
+
+    void SpikingActivityMonitor::copy_spikes_to_front() {
+      std::copy(neuron_ids_of_stored_spikes.begin(),
+                neuron_ids_of_stored_spikes.begin() + frontend()->total_number_of_spikes_stored_on_device[0],
+                &frontend()->neuron_ids_of_stored_spikes_on_host[frontend()->total_number_of_spikes_stored_on_host]);
+      std::copy(time_in_seconds_of_stored_spikes.begin(),
+                time_in_seconds_of_stored_spikes.begin() + frontend()->total_number_of_spikes_stored_on_device[0],
+                &frontend()->spike_times_of_stored_spikes_on_host[frontend()->total_number_of_spikes_stored_on_host]);
+    }
+
+    void SpikingActivityMonitor::collect_spikes_for_timestep
+    (unsigned int current_time_in_timesteps, float timestep) {
+      int timestep_grouping = frontend()->model->timestep_grouping;
+
+      pool->parallel_for(frontend()->neurons->total_number_of_neurons, [&](int begin, int end, int block){
+        std::vector<int>& ids = block_neuron_ids[block];
+        std::vector<float>& times = block_spike_times[block];
+        for (int idx = begin; idx < end; idx++){
+          for (int g = 0; g < timestep_grouping; g++){
+            if (neurons_backend->spiked(idx, neurons_backend->bitloc(current_time_in_timesteps + g))){
+              ids.push_back(idx);
+              times.push_back((current_time_in_timesteps + g)*timestep);
+            }
+          }
+        }
+      }, 1024);
+
+      for (int block = 0; block < (int)block_neuron_ids.size(); block++){
+        neuron_ids_of_stored_spikes.insert(neuron_ids_of_stored_spikes.end(), block_neuron_ids[block].begin(), block_neuron_ids[block].end());
+        time_in_seconds_of_stored_spikes.insert(time_in_seconds_of_stored_spikes.end(), block_spike_times[block].begin(), block_spike_times[block].end());
+        block_neuron_ids[block].clear();
+        block_spike_times[block].clear();
+      }
+    }
+
+    void SpikingActivityMonitor::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      checkpoint.write_vector(prefix + "/neuron_ids_of_stored_spikes", neuron_ids_of_stored_spikes);
+      checkpoint.write_vector(prefix + "/time_in_seconds_of_stored_spikes", time_in_seconds_of_stored_spikes);
+    }
+
+    void SpikingActivityMonitor::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      checkpoint.read_vector(prefix + "/neuron_ids_of_stored_spikes", neuron_ids_of_stored_spikes);
+      checkpoint.read_vector(prefix + "/time_in_seconds_of_stored_spikes", time_in_seconds_of_stored_spikes);
+    }
+  }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Spike/ActivityMonitor/SpikingActivityMonitor.hpp"
+#include "ActivityMonitor.hpp"
+#include "Spike/Backend/CPU/Neurons/SpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class SpikingActivityMonitor :
+      public virtual ::Backend::CPU::ActivityMonitor,
+      public virtual ::Backend::SpikingActivityMonitor {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(SpikingActivityMonitor);
+      using ::Backend::SpikingActivityMonitor::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      // Spikes collected since the last copy to the frontend
+      std::vector<int> neuron_ids_of_stored_spikes;
+      std::vector<float> time_in_seconds_of_stored_spikes;
+
+      void copy_spikes_to_front() override;
+      void copy_spikecount_to_front() override;
+      void collect_spikes_for_timestep
+      (unsigned int current_time_in_timesteps, float timestep) override;
+
+    private:
+      ::Backend::CPU::SpikingNeurons* neurons_backend = nullptr;
+      // Per block scratch lists, appended in block order
+      std::vector<std::vector<int>> block_neuron_ids;
+      std::vector<std::vector<float>> block_spike_times;
+    };
+  }
+}
@@ -0,0 +1,94 @@
+#include "CPUBackend.hpp"
+
+namespace Backend {
+  namespace CPU {
+    ThreadPool::ThreadPool(int number_of_threads_parameter) {
+      number_of_threads = (number_of_threads_parameter < 1) ? 1 : number_of_threads_parameter;
+      // The calling thread always runs block 0
+      for (int w = 1; w < number_of_threads; w++)
+        workers.emplace_back(&ThreadPool::worker_loop, this, w);
+    }
+
+    ThreadPool::~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+      wake.notify_all();
+      for (auto& worker : workers)
+        worker.join();
+    }
+
+    void ThreadPool::run_block(int block) {
+      int begin = (int)(((long long)job_size * block) / job_blocks);
+      int end = (int)(((long long)job_size * (block + 1)) / job_blocks);
+      if (begin < end)
+        (*job)(begin, end, block);
+    }
+
+    void ThreadPool::worker_loop(int worker) {
+      unsigned long seen_generation = 0;
+      while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&]{ return stopping || (generation != seen_generation); });
+        if (stopping)
+          return;
+        seen_generation = generation;
+        lock.unlock();
+
+        if (worker < job_blocks)
+          run_block(worker);
+
+        lock.lock();
+        if (--pending == 0)
+          done.notify_one();
+      }
+    }
+
+    void ThreadPool::parallel_for(int n,
+                                  const std::function<void(int, int, int)>& fn,
+                                  int minimum_block_size) {
+      if (n <= 0)
+        return;
+      if (minimum_block_size < 1)
+        minimum_block_size = 1;
+      int blocks = (n + minimum_block_size - 1) / minimum_block_size;
+      if (blocks > number_of_threads)
+        blocks = number_of_threads;
+
+      // Small jobs are not worth waking anyone for
+      if (blocks <= 1) {
+        fn(0, n, 0);
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        job_size = n;
+        job_blocks = blocks;
+        pending = number_of_threads - 1;
+        generation++;
+      }
+      wake.notify_all();
+
+      run_block(0);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      done.wait(lock, [&]{ return pending == 0; });
+      job = nullptr;
+    }
+
+    std::shared_ptr<ThreadPool> thread_pool(Context* ctx) {
+      static std::shared_ptr<ThreadPool> pool;
+      int number_of_threads = ctx ? ctx->params.threads : 0;
+      if (number_of_threads <= 0)
+        number_of_threads = std::thread::hardware_concurrency();
+      if (number_of_threads <= 0)
+        number_of_threads = 1;
+      if (!pool || (pool->size() != number_of_threads))
+        pool = std::make_shared<ThreadPool>(number_of_threads);
+      return pool;
+    }
+  } // namespace CPU
+} // namespace Backend
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Spike/Backend/Device.hpp"
+#include "Spike/Backend/Backend.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Backend {
+  namespace CPU {
+    /**
+     *  Fixed size pool of worker threads shared by every CPU backend object.
+     *  parallel_for splits [0, n) into contiguous blocks which are always
+     *  numbered in ascending index order, so per-block results which are
+     *  concatenated by block number give the same order at any thread count.
+     */
+    class ThreadPool {
+    public:
+      explicit ThreadPool(int number_of_threads);
+      ~ThreadPool();
+
+      inline int size() const { return number_of_threads; }
+
+      // fn(begin, end, block) is called once per block, block < size()
+      void parallel_for(int n,
+                        const std::function<void(int, int, int)>& fn,
+                        int minimum_block_size = 1024);
+
+    private:
+      int number_of_threads = 1;
+      std::vector<std::thread> workers;
+
+      std::mutex mutex;
+      std::condition_variable wake;
+      std::condition_variable done;
+      bool stopping = false;
+      unsigned long generation = 0;
+      int pending = 0;
+
+      // Current job
+      const std::function<void(int, int, int)>* job = nullptr;
+      int job_size = 0;
+      int job_blocks = 0;
+
+      void run_block(int block);
+      void worker_loop(int worker);
+    };
+
+    // Returns the pool sized by context->params.threads (0 = all hardware threads)
+    std::shared_ptr<ThreadPool> thread_pool(Context* ctx);
+  } // namespace CPU
+} // namespace Backend
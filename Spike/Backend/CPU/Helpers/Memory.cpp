@@ -0,0 +1,19 @@
+#include "Memory.hpp"
+#include <unistd.h>
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, MemoryManager);
+
+namespace Backend {
+  namespace CPU {
+    void MemoryManager::prepare() {
+    }
+
+    std::size_t MemoryManager::total_bytes() const {
+      return (std::size_t)sysconf(_SC_PHYS_PAGES) * (std::size_t)sysconf(_SC_PAGE_SIZE);
+    }
+
+    std::size_t MemoryManager::free_bytes() const {
+      return (std::size_t)sysconf(_SC_AVPHYS_PAGES) * (std::size_t)sysconf(_SC_PAGE_SIZE);
+    }
+  }
+}
@@ -0,0 +1,14 @@
+#include "RandomStateManager.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, RandomStateManager);
+
+namespace Backend {
+  namespace CPU {
+    void RandomStateManager::prepare() {
+    }
+
+    CounterRandom RandomStateManager::generator_for_stream(random_stream_purpose purpose, uint64_t stream) const {
+      return CounterRandom(seed, purpose, stream);
+    }
+  }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Spike/Helpers/RandomStateManager.hpp"
+#include "Spike/Backend/CPU/CPUBackend.hpp"
+
+#include "Spike/Helpers/CounterRandom.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class RandomStateManager : public virtual ::Backend::RandomStateManager {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(RandomStateManager);
+
+      // Same default seed as the CUDA backend
+      unsigned int seed = 1;
+
+      void prepare() override;
+
+      // One independent generator per stream (e.g. per neuron), so that
+      // results do not depend upon the number of worker threads
+      CounterRandom generator_for_stream(random_stream_purpose purpose, uint64_t stream) const;
+    };
+  }
+}
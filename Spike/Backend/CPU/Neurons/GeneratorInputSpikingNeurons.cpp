@@ -0,0 +1,69 @@
+#include "GeneratorInputSpikingNeurons.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, GeneratorInputSpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void GeneratorInputSpikingNeurons::prepare() {
+      InputSpikingNeurons::prepare();
+    }
+
+    void GeneratorInputSpikingNeurons::reset_state() {
+      InputSpikingNeurons::reset_state();
+      setup_stimulus();
+    }
+
+    void GeneratorInputSpikingNeurons::setup_stimulus() {
+      if (frontend()->total_number_of_input_stimuli == 0){
+        num_spikes_in_current_stimulus = 0;
+        return;
+      }
+      num_spikes_in_current_stimulus = frontend()->number_of_spikes_in_stimuli[frontend()->current_stimulus_index];
+      first_spike_not_yet_past = 0;
+    }
+
+    void GeneratorInputSpikingNeurons::state_update(unsigned int current_time_in_timesteps, float timestep) {
+      if (num_spikes_in_current_stimulus == 0)
+        return;
+      if ((frontend()->temporal_lengths_of_stimuli[frontend()->current_stimulus_index] + (neuron_spike_time_bitbuffer_bytesize*8 + 1)*timestep) <= (current_time_in_timesteps*timestep - frontend()->stimulus_onset_adjustment))
+        return;
+
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      float current_time_in_seconds = current_time_in_timesteps*timestep;
+
+      pool->parallel_for(frontend()->total_number_of_neurons, [&](int begin, int end, int block){
+        for (int idx = begin; idx < end; idx++)
+          for (int g = 0; g < timestep_grouping; g++)
+            clear_spike(idx, bitloc(current_time_in_timesteps + g));
+      }, 1024);
+
+      const int* neuron_ids_for_stimulus;
+      const float* spike_times_for_stimulus;
+      int number_of_spikes_due = frontend()->spikes_due(current_time_in_timesteps, timestep, first_spike_not_yet_past,
+                                                        neuron_ids_for_stimulus, spike_times_for_stimulus);
+
+      // Spikes of one stimulus may share a neuron, so these are placed serially
+      for (int s = 0; s < number_of_spikes_due; s++){
+        for (int g = 0; g < timestep_grouping; g++){
+          if (fabs((current_time_in_seconds - frontend()->stimulus_onset_adjustment + g*timestep) - spike_times_for_stimulus[s]) < 0.5 * timestep){
+            int idx = neuron_ids_for_stimulus[s];
+            set_spike(idx, bitloc(current_time_in_timesteps + g));
+            last_spike_time_of_each_neuron[idx] = current_time_in_seconds + g*timestep;
+            activate(0, g, idx);
+          }
+        }
+      }
+    }
+
+    void GeneratorInputSpikingNeurons::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      InputSpikingNeurons::save_state(checkpoint, prefix);
+    }
+
+    void GeneratorInputSpikingNeurons::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      InputSpikingNeurons::load_state(checkpoint, prefix);
+      // The frontend has restored current_stimulus_index
+      setup_stimulus();
+    }
+  }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Spike/Neurons/GeneratorInputSpikingNeurons.hpp"
+#include "InputSpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class GeneratorInputSpikingNeurons : public virtual ::Backend::CPU::InputSpikingNeurons,
+                                         public virtual ::Backend::GeneratorInputSpikingNeurons {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(GeneratorInputSpikingNeurons);
+      using ::Backend::GeneratorInputSpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+      void setup_stimulus() override;
+
+      int num_spikes_in_current_stimulus = 0;
+      // Cursor into the (time sorted) stimulus, see spikes_due
+      int first_spike_not_yet_past = 0;
+
+      void state_update(unsigned int current_time_in_timesteps, float timestep) override;
+    };
+  }
+}
@@ -0,0 +1,22 @@
+#include "ImagePoissonInputSpikingNeurons.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, ImagePoissonInputSpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void ImagePoissonInputSpikingNeurons::prepare() {
+      PoissonInputSpikingNeurons::prepare();
+    }
+
+    void ImagePoissonInputSpikingNeurons::reset_state() {
+      PoissonInputSpikingNeurons::reset_state();
+    }
+
+    void ImagePoissonInputSpikingNeurons::copy_rates_to_device() {
+    }
+
+    const float* ImagePoissonInputSpikingNeurons::stimuli_rates() const {
+      return frontend()->gabor_input_rates;
+    }
+  }
+}
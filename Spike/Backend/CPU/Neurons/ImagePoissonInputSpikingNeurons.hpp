@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Spike/Neurons/ImagePoissonInputSpikingNeurons.hpp"
+#include "PoissonInputSpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class ImagePoissonInputSpikingNeurons : public virtual ::Backend::CPU::PoissonInputSpikingNeurons,
+                                          public virtual ::Backend::ImagePoissonInputSpikingNeurons {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(ImagePoissonInputSpikingNeurons);
+      using ::Backend::ImagePoissonInputSpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      // Rates live on the frontend, nothing to copy
+      void copy_rates_to_device() override;
+
+      const float* stimuli_rates() const override;
+    };
+  }
+}
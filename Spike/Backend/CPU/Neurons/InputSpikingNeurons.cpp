@@ -0,0 +1,15 @@
+#include "InputSpikingNeurons.hpp"
+
+// SPIKE_EXPORT_BACKEND_TYPE(CPU, InputSpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void InputSpikingNeurons::prepare() {
+      SpikingNeurons::prepare();
+    }
+
+    void InputSpikingNeurons::reset_state() {
+      SpikingNeurons::reset_state();
+    }
+  }
+}
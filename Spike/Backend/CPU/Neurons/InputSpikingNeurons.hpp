@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Spike/Neurons/InputSpikingNeurons.hpp"
+#include "SpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class InputSpikingNeurons : public virtual ::Backend::CPU::SpikingNeurons,
+                                public virtual ::Backend::InputSpikingNeurons {
+    public:
+      using ::Backend::InputSpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+    };
+  }
+}
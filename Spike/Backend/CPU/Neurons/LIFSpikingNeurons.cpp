@@ -0,0 +1,131 @@
+#include "LIFSpikingNeurons.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+#include "Spike/Backend/CPU/Synapses/ConductanceSpikingSynapses.hpp"
+#include "Spike/Backend/CPU/Synapses/CurrentSpikingSynapses.hpp"
+#include "Spike/Backend/CPU/Synapses/VoltageSpikingSynapses.hpp"
+#include <typeinfo>
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, LIFSpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void LIFSpikingNeurons::prepare() {
+      SpikingNeurons::prepare();
+
+      float timestep = frontend()->model->timestep;
+      int num_labels = frontend()->membrane_time_constants_tau_m.size();
+      membrane_decay_constants.resize(num_labels);
+      membrane_resistances_R.resize(num_labels);
+      background_currents.resize(num_labels);
+      resting_potentials_v0.resize(num_labels);
+      refractory_timesteps.resize(num_labels);
+      for (int n = 0; n < num_labels; n++){
+        membrane_decay_constants[n] = timestep / frontend()->membrane_time_constants_tau_m[n];
+        membrane_resistances_R[n] = membrane_decay_constants[n]*frontend()->membrane_resistances_R[n];
+        background_currents[n] = membrane_decay_constants[n]*frontend()->background_currents[n];
+        resting_potentials_v0[n] = membrane_decay_constants[n]*frontend()->resting_potentials_v0[n];
+        refractory_timesteps[n] = ceil(frontend()->refractory_periods[n] / timestep);
+      }
+
+      membrane_potentials_v.resize(frontend()->total_number_of_neurons);
+      refraction_counter.resize(frontend()->total_number_of_neurons);
+
+      // Other synapse types (and subclasses of these) take a virtual call per input
+      if (!(bind_update_with<VoltageSpikingSynapses>(synapses_backend)
+            || bind_update_with<ConductanceSpikingSynapses>(synapses_backend)
+            || bind_update_with<CurrentSpikingSynapses>(synapses_backend)))
+        update_with_synapses = [this](unsigned int current_time_in_timesteps, float timestep){
+          update(synapses_backend, current_time_in_timesteps, timestep);
+        };
+    }
+
+    template<typename SynapsesT>
+    bool LIFSpikingNeurons::bind_update_with(::Backend::CPU::SpikingSynapses* synapses) {
+      if (!synapses || (typeid(*synapses) != typeid(SynapsesT)))
+        return false;
+      SynapsesT* typed_synapses = dynamic_cast<SynapsesT*>(synapses);
+      update_with_synapses = [this, typed_synapses](unsigned int current_time_in_timesteps, float timestep){
+        update(typed_synapses, current_time_in_timesteps, timestep);
+      };
+      return true;
+    }
+
+    void LIFSpikingNeurons::reset_state() {
+      SpikingNeurons::reset_state();
+      std::fill(refraction_counter.begin(), refraction_counter.end(), 0);
+      std::copy(frontend()->membrane_potentials_v.begin(),
+                frontend()->membrane_potentials_v.end(),
+                membrane_potentials_v.begin());
+    }
+
+    void LIFSpikingNeurons::state_update(unsigned int current_time_in_timesteps, float timestep) {
+      update_with_synapses(current_time_in_timesteps, timestep);
+    }
+
+    template<typename SynapsesT>
+    void LIFSpikingNeurons::update(SynapsesT* synapses, unsigned int current_time_in_timesteps, float timestep) {
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      const int* neuron_labels = frontend()->neuron_labels.data();
+      const float* thresholds = frontend()->spiking_thresholds_vthresh.data();
+      const float* reset_potentials = frontend()->after_spike_reset_potentials_vreset.data();
+
+      // The same for every neuron
+      bitlocs_of_step.resize(timestep_grouping);
+      for (int g = 0; g < timestep_grouping; g++)
+        bitlocs_of_step[g] = bitloc(current_time_in_timesteps + g);
+
+      pool->parallel_for(frontend()->total_number_of_neurons, [&](int begin, int end, int block){
+        for (int idx = begin; idx < end; idx++){
+          int neuron_label = neuron_labels[idx];
+          float equation_constant = membrane_decay_constants[neuron_label];
+          float resting_potential_V0 = resting_potentials_v0[neuron_label];
+          float temp_membrane_resistance_R = membrane_resistances_R[neuron_label];
+          float background_current = background_currents[neuron_label];
+          int refractory_period_in_timesteps = refractory_timesteps[neuron_label];
+
+          float membrane_potential_Vi = membrane_potentials_v[idx];
+
+          for (int g = 0; g < timestep_grouping; g++){
+            int loc = bitlocs_of_step[g];
+            clear_spike(idx, loc);
+            float voltage_input_for_timestep = synapses->input_injection(
+                temp_membrane_resistance_R,
+                membrane_potential_Vi,
+                current_time_in_timesteps,
+                timestep,
+                idx,
+                g);
+
+            if (refraction_counter[idx] <= 0){
+              membrane_potential_Vi += resting_potential_V0 - equation_constant * membrane_potential_Vi + background_current + voltage_input_for_timestep;
+
+              // Finally check for a spike
+              if (membrane_potential_Vi >= thresholds[neuron_label]){
+                set_spike(idx, loc);
+                refraction_counter[idx] = refractory_period_in_timesteps;
+                last_spike_time_of_each_neuron[idx] = (current_time_in_timesteps + g)*timestep;
+                membrane_potential_Vi = reset_potentials[neuron_label];
+                activate(block, g, idx);
+              }
+            } else {
+              refraction_counter[idx] -= 1;
+            }
+          }
+          membrane_potentials_v[idx] = membrane_potential_Vi;
+        }
+      }, 256);
+    }
+
+    void LIFSpikingNeurons::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      SpikingNeurons::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/membrane_potentials_v", membrane_potentials_v);
+      checkpoint.write_vector(prefix + "/refraction_counter", refraction_counter);
+    }
+
+    void LIFSpikingNeurons::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      SpikingNeurons::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/membrane_potentials_v", membrane_potentials_v);
+      checkpoint.read_vector_of_same_size(prefix + "/refraction_counter", refraction_counter);
+    }
+  }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Spike/Neurons/LIFSpikingNeurons.hpp"
+#include "SpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class LIFSpikingNeurons : public virtual ::Backend::CPU::SpikingNeurons,
+                              public virtual ::Backend::LIFSpikingNeurons {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(LIFSpikingNeurons);
+      using ::Backend::LIFSpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      // Per neuron state
+      std::vector<float> membrane_potentials_v;
+      std::vector<int> refraction_counter;
+
+      // Per label constants, pre-multiplied by (timestep / tau_m) as in the CUDA backend
+      std::vector<float> membrane_decay_constants;
+      std::vector<float> membrane_resistances_R;
+      std::vector<float> background_currents;
+      std::vector<float> resting_potentials_v0;
+      std::vector<int> refractory_timesteps;
+
+      void state_update(unsigned int current_time_in_timesteps, float timestep) override;
+
+    private:
+      // The update for the type of synapse backend, chosen by prepare()
+      std::function<void(unsigned int, float)> update_with_synapses;
+      std::vector<int> bitlocs_of_step;
+      template<typename SynapsesT> bool bind_update_with(::Backend::CPU::SpikingSynapses* synapses);
+      template<typename SynapsesT> void update(SynapsesT* synapses, unsigned int current_time_in_timesteps, float timestep);
+    };
+  }
+}
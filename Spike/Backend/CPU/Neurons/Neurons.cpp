@@ -0,0 +1,15 @@
+#include "Neurons.hpp"
+
+// SPIKE_EXPORT_BACKEND_TYPE(CPU, Neurons);
+
+namespace Backend {
+  namespace CPU {
+    void Neurons::prepare() {
+      pool = thread_pool(context);
+    }
+
+    void Neurons::reset_state() {
+    }
+
+  } // namespace CPU
+} // namespace Backend
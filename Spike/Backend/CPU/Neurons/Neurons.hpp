@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Spike/Neurons/Neurons.hpp"
+#include "Spike/Backend/CPU/CPUBackend.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class Neurons : public virtual ::Backend::Neurons {
+    public:
+      ~Neurons() override = default;
+      using ::Backend::Neurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      std::shared_ptr<ThreadPool> pool;
+    };
+  } // namespace CPU
+} // namespace Backend
@@ -0,0 +1,22 @@
+#include "PatternedPoissonInputSpikingNeurons.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, PatternedPoissonInputSpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void PatternedPoissonInputSpikingNeurons::prepare() {
+      PoissonInputSpikingNeurons::prepare();
+    }
+
+    void PatternedPoissonInputSpikingNeurons::reset_state() {
+      PoissonInputSpikingNeurons::reset_state();
+    }
+
+    void PatternedPoissonInputSpikingNeurons::copy_rates_to_device() {
+    }
+
+    const float* PatternedPoissonInputSpikingNeurons::stimuli_rates() const {
+      return frontend()->stimuli_rates;
+    }
+  }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Spike/Neurons/PatternedPoissonInputSpikingNeurons.hpp"
+#include "PoissonInputSpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class PatternedPoissonInputSpikingNeurons : public virtual ::Backend::CPU::PoissonInputSpikingNeurons,
+                                              public virtual ::Backend::PatternedPoissonInputSpikingNeurons {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(PatternedPoissonInputSpikingNeurons);
+      using ::Backend::PatternedPoissonInputSpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      // Rates live on the frontend, nothing to copy
+      void copy_rates_to_device() override;
+
+      const float* stimuli_rates() const override;
+    };
+  }
+}
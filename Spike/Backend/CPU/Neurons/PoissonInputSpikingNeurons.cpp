@@ -0,0 +1,135 @@
+#include "PoissonInputSpikingNeurons.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+#include <algorithm>
+#include <climits>
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, PoissonInputSpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void PoissonInputSpikingNeurons::prepare() {
+      InputSpikingNeurons::prepare();
+
+      random_state_manager_backend
+        = dynamic_cast<::Backend::CPU::RandomStateManager*>
+        (frontend()->random_state_manager->backend());
+      assert(random_state_manager_backend);
+
+      generators.clear();
+      generators.reserve(frontend()->total_number_of_neurons);
+      for (int idx = 0; idx < frontend()->total_number_of_neurons; idx++)
+        generators.push_back(random_state_manager_backend->generator_for_stream(RANDOM_STREAM_POISSON_INPUT, idx));
+      next_spike_step_of_each_neuron.resize(frontend()->total_number_of_neurons);
+      timing_wheel.resize(timing_wheel_size);
+      neurons_spiked_at_bitloc.resize(neuron_spike_time_bitbuffer_bytesize*8);
+    }
+
+    void PoissonInputSpikingNeurons::reset_state() {
+      InputSpikingNeurons::reset_state();
+      for (auto& neurons : neurons_spiked_at_bitloc)
+        neurons.clear();
+      steps_taken = 0;
+      setup_stimulus();
+    }
+
+    void PoissonInputSpikingNeurons::setup_stimulus() {
+      stimulus_started = false;
+    }
+
+    const float* PoissonInputSpikingNeurons::stimuli_rates() const {
+      return frontend()->rates;
+    }
+
+    void PoissonInputSpikingNeurons::schedule_next_spike(int idx, long long step, float rate, float timestep) {
+      float random_float = generators[idx].uniform_float();
+      float next_interval = ceilf((- (1.0f / rate)*logf(random_float))/timestep);
+      long long interval = (rate > 0.0f && next_interval < (float)INT_MAX) ? (long long)next_interval : INT_MAX;
+      // The interval counts the steps waited in between, as in the CUDA backend
+      next_spike_step_of_each_neuron[idx] = step + interval + 1;
+      timing_wheel[next_spike_step_of_each_neuron[idx] % timing_wheel_size].push_back(idx);
+    }
+
+    void PoissonInputSpikingNeurons::state_update(unsigned int current_time_in_timesteps, float timestep) {
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      int total_number_of_input_neurons = frontend()->total_number_of_neurons;
+      const float* rates = stimuli_rates() + (total_number_of_input_neurons * frontend()->current_stimulus_index);
+
+      fired.clear();
+      for (int g = 0; g < timestep_grouping; g++){
+        long long step = steps_taken + g;
+        int loc = bitloc(current_time_in_timesteps + g);
+        for (int idx : neurons_spiked_at_bitloc[loc])
+          clear_spike(idx, loc);
+        neurons_spiked_at_bitloc[loc].clear();
+
+        // A new stimulus only draws the first intervals
+        if (!stimulus_started){
+          for (auto& bucket : timing_wheel)
+            bucket.clear();
+          for (int idx = 0; idx < total_number_of_input_neurons; idx++)
+            schedule_next_spike(idx, step, rates[idx], timestep);
+          stimulus_started = true;
+          continue;
+        }
+
+        waiting.clear();
+        waiting.swap(timing_wheel[step % timing_wheel_size]);
+        for (int idx : waiting){
+          if (next_spike_step_of_each_neuron[idx] != step){
+            timing_wheel[step % timing_wheel_size].push_back(idx);
+            continue;
+          }
+          last_spike_time_of_each_neuron[idx] = (current_time_in_timesteps + g)*timestep;
+          set_spike(idx, loc);
+          neurons_spiked_at_bitloc[loc].push_back(idx);
+          fired.push_back({idx, g});
+          schedule_next_spike(idx, step, rates[idx], timestep);
+        }
+      }
+      steps_taken += timestep_grouping;
+
+      // Activations go to the synapses in neuron order, as when every neuron is updated
+      std::sort(fired.begin(), fired.end(), [](const neuron_activation& a, const neuron_activation& b){
+        return (a.neuron_id < b.neuron_id) || ((a.neuron_id == b.neuron_id) && (a.group_index < b.group_index));
+      });
+      for (auto& activation : fired)
+        activate(0, activation.group_index, activation.neuron_id);
+    }
+
+    void PoissonInputSpikingNeurons::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      InputSpikingNeurons::save_state(checkpoint, prefix);
+      // A generator's state is its position in its stream
+      std::vector<uint64_t> generator_positions;
+      for (auto& generator : generators)
+        generator_positions.push_back(generator.position);
+      checkpoint.write_vector(prefix + "/generator_positions", generator_positions);
+      checkpoint.write_vector(prefix + "/next_spike_step_of_each_neuron", next_spike_step_of_each_neuron);
+      checkpoint.write_value(prefix + "/steps_taken", steps_taken);
+      checkpoint.write_value(prefix + "/stimulus_started", (char)stimulus_started);
+    }
+
+    void PoissonInputSpikingNeurons::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      InputSpikingNeurons::load_state(checkpoint, prefix);
+      std::vector<uint64_t> generator_positions(generators.size());
+      checkpoint.read_vector_of_same_size(prefix + "/generator_positions", generator_positions);
+      for (size_t idx = 0; idx < generators.size(); idx++)
+        generators[idx].position = generator_positions[idx];
+      checkpoint.read_vector_of_same_size(prefix + "/next_spike_step_of_each_neuron", next_spike_step_of_each_neuron);
+      steps_taken = checkpoint.read_value<long long>(prefix + "/steps_taken");
+      stimulus_started = checkpoint.read_value<char>(prefix + "/stimulus_started");
+
+      // The timing wheel and the spiked lists follow from the saved state
+      for (auto& bucket : timing_wheel)
+        bucket.clear();
+      if (stimulus_started)
+        for (int idx = 0; idx < frontend()->total_number_of_neurons; idx++)
+          timing_wheel[next_spike_step_of_each_neuron[idx] % timing_wheel_size].push_back(idx);
+      for (int loc = 0; loc < (int)neurons_spiked_at_bitloc.size(); loc++){
+        neurons_spiked_at_bitloc[loc].clear();
+        for (int idx = 0; idx < frontend()->total_number_of_neurons; idx++)
+          if (spiked(idx, loc))
+            neurons_spiked_at_bitloc[loc].push_back(idx);
+      }
+    }
+  }
+}
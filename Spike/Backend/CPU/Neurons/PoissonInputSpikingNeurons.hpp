@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Spike/Neurons/PoissonInputSpikingNeurons.hpp"
+#include "InputSpikingNeurons.hpp"
+#include "Spike/Backend/CPU/Helpers/RandomStateManager.hpp"
+
+
+namespace Backend {
+  namespace CPU {
+    class PoissonInputSpikingNeurons : public virtual ::Backend::CPU::InputSpikingNeurons,
+                                       public virtual ::Backend::PoissonInputSpikingNeurons {
+    public:
+      PoissonInputSpikingNeurons() = default;
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(PoissonInputSpikingNeurons);
+      using ::Backend::PoissonInputSpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+      void setup_stimulus() override;
+
+      ::Backend::CPU::RandomStateManager* random_state_manager_backend = nullptr;
+
+      // One generator per neuron keeps the spike trains independent of the thread count
+      std::vector<CounterRandom> generators;
+
+      // Each neuron draws the interval to its next spike and is not visited
+      // until then, so a step costs in proportion to the spikes it holds.
+      // Neurons wait in the timing wheel bucket of their next spike step
+      // (modulo timing_wheel_size); later spikes go round the wheel again.
+      static const int timing_wheel_size = 4096;
+      std::vector<std::vector<int>> timing_wheel;
+      std::vector<long long> next_spike_step_of_each_neuron;
+      long long steps_taken = 0;  // Not changed by reset_time, unlike the model time
+      bool stimulus_started = false;
+      // The neurons with a spike bit set at each bit buffer location, so that
+      // only those bits need clearing when the location comes round again
+      std::vector<std::vector<int>> neurons_spiked_at_bitloc;
+
+      // Rates for every stimulus, (total_number_of_neurons * stimulus index) + neuron
+      virtual const float* stimuli_rates() const;
+
+      void state_update(unsigned int current_time_in_timesteps, float timestep) override;
+
+    private:
+      std::vector<neuron_activation> fired;
+      std::vector<int> waiting;
+
+      // Draws the next spike of neuron idx after step
+      void schedule_next_spike(int idx, long long step, float rate, float timestep);
+    };
+  }
+}
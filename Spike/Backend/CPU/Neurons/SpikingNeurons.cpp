@@ -0,0 +1,66 @@
+#include "SpikingNeurons.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+#include "Spike/Backend/CPU/Synapses/SpikingSynapses.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, SpikingNeurons);
+
+namespace Backend {
+  namespace CPU {
+    void SpikingNeurons::prepare() {
+      Neurons::prepare();
+
+      synapses_backend = dynamic_cast<::Backend::CPU::SpikingSynapses*>
+        (frontend()->model->spiking_synapses->backend());
+
+      neuron_spike_time_bitbuffer_bytesize = ((frontend()->model->spiking_synapses->maximum_axonal_delay_in_timesteps + 2*frontend()->model->timestep_grouping) / 8) + 1;
+      neuron_spike_time_bitbuffer.resize(frontend()->total_number_of_neurons*neuron_spike_time_bitbuffer_bytesize);
+      last_spike_time_of_each_neuron.resize(frontend()->total_number_of_neurons);
+      activations.resize(pool->size());
+
+      int total_number_of_neurons = frontend()->total_number_of_neurons;
+      has_efferent_synapses.assign(total_number_of_neurons, 0);
+      for (int idx = 0; idx < total_number_of_neurons; idx++)
+        has_efferent_synapses[idx] = (frontend()->per_neuron_efferent_synapse_count[idx] > 0);
+      bool is_input = (frontend() == frontend()->model->input_spiking_neurons);
+      for (auto& group : frontend()->model->spiking_synapses->dense_groups)
+        if (group.presynaptic_group_is_input == is_input)
+          std::fill(has_efferent_synapses.begin() + group.presynaptic_start,
+                    has_efferent_synapses.begin() + group.presynaptic_start + group.number_of_presynaptic_neurons,
+                    1);
+      for (auto& group : frontend()->model->spiking_synapses->convolutional_groups)
+        if (group.presynaptic_group_is_input == is_input)
+          std::fill(has_efferent_synapses.begin() + group.presynaptic_start,
+                    has_efferent_synapses.begin() + group.presynaptic_start + group.presynaptic_shape[0]*group.presynaptic_shape[1],
+                    1);
+      for (auto& group : frontend()->model->spiking_synapses->procedural_groups)
+        if (group.presynaptic_group_is_input == is_input)
+          std::fill(has_efferent_synapses.begin() + group.presynaptic_start,
+                    has_efferent_synapses.begin() + group.presynaptic_start + group.number_of_presynaptic_neurons,
+                    1);
+    }
+
+    void SpikingNeurons::reset_state() {
+      Neurons::reset_state();
+
+      // Set last spike times to -1000 so that the times do not affect current simulation.
+      std::fill(last_spike_time_of_each_neuron.begin(), last_spike_time_of_each_neuron.end(), -1000.0f);
+      std::fill(neuron_spike_time_bitbuffer.begin(), neuron_spike_time_bitbuffer.end(), 0);
+      for (auto& block_activations : activations)
+        block_activations.clear();
+    }
+
+    void SpikingNeurons::state_update(unsigned int current_time_in_timesteps, float timestep) {
+    }
+
+
+    void SpikingNeurons::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      checkpoint.write_vector(prefix + "/last_spike_time_of_each_neuron", last_spike_time_of_each_neuron);
+      checkpoint.write_vector(prefix + "/neuron_spike_time_bitbuffer", neuron_spike_time_bitbuffer);
+    }
+
+    void SpikingNeurons::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      checkpoint.read_vector_of_same_size(prefix + "/last_spike_time_of_each_neuron", last_spike_time_of_each_neuron);
+      checkpoint.read_vector_of_same_size(prefix + "/neuron_spike_time_bitbuffer", neuron_spike_time_bitbuffer);
+    }
+  } // namespace CPU
+} // namespace Backend
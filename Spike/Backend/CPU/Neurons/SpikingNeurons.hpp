@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Spike/Neurons/SpikingNeurons.hpp"
+#include "Neurons.hpp"
+
+#include <stdint.h>
+
+namespace Backend {
+  namespace CPU {
+    class SpikingSynapses; // forward definition
+
+    // A neuron which has spiked at timestep (t + group_index)
+    struct neuron_activation {
+      int neuron_id;
+      int group_index;
+    };
+
+    class SpikingNeurons : public virtual ::Backend::CPU::Neurons,
+                           public virtual ::Backend::SpikingNeurons {
+    public:
+      SpikingNeurons() = default;
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(SpikingNeurons);
+      using ::Backend::SpikingNeurons::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      void state_update(unsigned int current_time_in_timesteps, float timestep) override;
+
+      // Spike history, identical layout to the CUDA backend
+      std::vector<float> last_spike_time_of_each_neuron;
+      int neuron_spike_time_bitbuffer_bytesize = 0;
+      std::vector<uint8_t> neuron_spike_time_bitbuffer;
+
+      // Neurons which spiked this step, one list per thread pool block.
+      // Filled by state_update and consumed by the synapse backend.
+      std::vector<std::vector<neuron_activation>> activations;
+
+      ::Backend::CPU::SpikingSynapses* synapses_backend = nullptr;
+
+      inline int bitloc(unsigned int timestep_index) const {
+        return timestep_index % (neuron_spike_time_bitbuffer_bytesize*8);
+      }
+      inline bool spiked(int idx, int loc) const {
+        return neuron_spike_time_bitbuffer[idx*neuron_spike_time_bitbuffer_bytesize + (loc / 8)] & (1 << (loc % 8));
+      }
+      inline void set_spike(int idx, int loc) {
+        neuron_spike_time_bitbuffer[idx*neuron_spike_time_bitbuffer_bytesize + (loc / 8)] |= (1 << (loc % 8));
+      }
+      inline void clear_spike(int idx, int loc) {
+        neuron_spike_time_bitbuffer[idx*neuron_spike_time_bitbuffer_bytesize + (loc / 8)] &= ~(1 << (loc % 8));
+      }
+      // Neurons with stored, convolutional or procedural efferent synapses, whose spikes are passed on
+      std::vector<char> has_efferent_synapses;
+
+      inline void activate(int block, int g, int idx) {
+        if (has_efferent_synapses[idx])
+          activations[block].push_back({idx, g});
+      }
+    };
+  } // namespace CPU
+} // namespace Backend
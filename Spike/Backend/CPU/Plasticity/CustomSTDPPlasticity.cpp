@@ -0,0 +1,149 @@
+#include "CustomSTDPPlasticity.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, CustomSTDPPlasticity);
+
+namespace Backend {
+  namespace CPU {
+    void CustomSTDPPlasticity::prepare() {
+      STDPPlasticity::prepare();
+      if (frontend()->stdp_params->per_neuron_traces){
+        prepare_neuron_traces(pre_trace_history, post_trace_history);
+      } else {
+        stdp_pre_memory_trace.resize(total_number_of_plastic_synapses);
+        stdp_post_memory_trace.resize(total_number_of_plastic_synapses);
+      }
+    }
+
+    void CustomSTDPPlasticity::reset_state() {
+      STDPPlasticity::reset_state();
+      std::fill(stdp_pre_memory_trace.begin(), stdp_pre_memory_trace.end(), 0.0f);
+      std::fill(stdp_post_memory_trace.begin(), stdp_post_memory_trace.end(), 0.0f);
+      std::fill(pre_trace_history.begin(), pre_trace_history.end(), 0.0f);
+      std::fill(post_trace_history.begin(), post_trace_history.end(), 0.0f);
+    }
+
+    void CustomSTDPPlasticity::apply_stdp_to_synapse_weights(unsigned int current_time_in_timesteps, float timestep) {
+      const custom_stdp_plasticity_parameters_struct stdp_vars = *(frontend()->stdp_params);
+      float post_decay = expf(- timestep / stdp_vars.tau_minus);
+      float pre_decay = expf(- timestep / stdp_vars.tau_plus);
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      float* weights = synapses_backend->frontend()->synaptic_efficacies_or_weights;
+      const int* postsynaptic_neuron_indices = synapses_backend->frontend()->postsynaptic_neuron_indices;
+      const int* delays = synapses_backend->frontend()->delays;
+      bool per_neuron_traces = stdp_vars.per_neuron_traces;
+
+      // Per-neuron traces are advanced once per neuron, before any synapse reads them
+      if (per_neuron_traces){
+        advance_neuron_traces(pre_trace_history, current_time_in_timesteps, timestep_grouping, [&](int key, float trace, unsigned int t){
+          trace *= pre_decay;
+          if (pre_neuron_spiked(key, t)){
+            trace += stdp_vars.a_plus;
+            if (stdp_vars.nearest_spike_only)
+              trace = stdp_vars.a_plus;
+          }
+          return trace;
+        });
+        advance_neuron_traces(post_trace_history, current_time_in_timesteps, timestep_grouping, [&](int postid, float trace, unsigned int t){
+          trace *= post_decay;
+          if (post_neuron_spiked(postid, t)){
+            trace += stdp_vars.a_minus;
+            if (stdp_vars.nearest_spike_only)
+              trace = stdp_vars.a_minus;
+          }
+          return trace;
+        });
+        next_trace_timestep = current_time_in_timesteps + timestep_grouping;
+      }
+
+      for_each_plastic_synapse(current_time_in_timesteps, timestep_grouping, [&](int indx, int skipped_timesteps){
+        int idx = plastic_synapse_indices[indx];
+
+        // Getting synapse details
+        float stdp_pre_memory_trace_val = 0.0f;
+        float stdp_post_memory_trace_val = 0.0f;
+        if (!per_neuron_traces){
+          stdp_pre_memory_trace_val = stdp_pre_memory_trace[indx];
+          stdp_post_memory_trace_val = stdp_post_memory_trace[indx];
+          if (skipped_timesteps > 0){
+            stdp_pre_memory_trace_val *= powf(pre_decay, skipped_timesteps);
+            stdp_post_memory_trace_val *= powf(post_decay, skipped_timesteps);
+          }
+        }
+        float old_synaptic_weight = weights[idx];
+        float new_synaptic_weight = old_synaptic_weight;
+
+        // Looping over timesteps
+        for (int g = 0; g < timestep_grouping; g++){
+          bool pre_spike = presynaptic_spiked(idx, current_time_in_timesteps + g);
+          bool post_spike = postsynaptic_spiked(idx, current_time_in_timesteps + g);
+
+          if (per_neuron_traces){
+            stdp_pre_memory_trace_val = neuron_trace(pre_trace_history, pre_neuron_key(idx), current_time_in_timesteps + g, delays[idx]);
+            stdp_post_memory_trace_val = neuron_trace(post_trace_history, postsynaptic_neuron_indices[idx], current_time_in_timesteps + g);
+          } else {
+            // Decaying STDP traces
+            stdp_post_memory_trace_val *= post_decay;
+            stdp_pre_memory_trace_val *= pre_decay;
+
+            // OnPre Trace Update
+            if (pre_spike){
+              stdp_pre_memory_trace_val += stdp_vars.a_plus;
+              if (stdp_vars.nearest_spike_only)
+                stdp_pre_memory_trace_val = stdp_vars.a_plus;
+            }
+            // OnPost Trace Update
+            if (post_spike){
+              stdp_post_memory_trace_val += stdp_vars.a_minus;
+              if (stdp_vars.nearest_spike_only)
+                stdp_post_memory_trace_val = stdp_vars.a_minus;
+            }
+          }
+
+          float syn_update_val = 0.0f;
+          old_synaptic_weight = new_synaptic_weight;
+          // OnPre Weight Update
+          if (pre_spike){
+            syn_update_val -= stdp_vars.learning_rate * (powf((old_synaptic_weight / stdp_vars.w_max), stdp_vars.weight_dependence_power_ltd)) * stdp_post_memory_trace_val + stdp_vars.learning_rate*stdp_vars.a_star;
+          }
+          // OnPost Weight Update
+          if (post_spike){
+            syn_update_val += stdp_vars.learning_rate * (powf((1.0 - (old_synaptic_weight / stdp_vars.w_max)), stdp_vars.weight_dependence_power_ltp)) * stdp_pre_memory_trace_val;
+          }
+
+          new_synaptic_weight = old_synaptic_weight + syn_update_val;
+          if (new_synaptic_weight < 0.0f)
+            new_synaptic_weight = 0.0f;
+        }
+
+        if (new_synaptic_weight > stdp_vars.w_max)
+          new_synaptic_weight = stdp_vars.w_max;
+
+        // Weight Update
+        weights[idx] = new_synaptic_weight;
+
+        // Correctly set the trace values
+        if (!per_neuron_traces){
+          stdp_pre_memory_trace[indx] = stdp_pre_memory_trace_val;
+          stdp_post_memory_trace[indx] = stdp_post_memory_trace_val;
+        }
+      });
+    }
+
+    void CustomSTDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      STDPPlasticity::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/stdp_pre_memory_trace", stdp_pre_memory_trace);
+      checkpoint.write_vector(prefix + "/stdp_post_memory_trace", stdp_post_memory_trace);
+      checkpoint.write_vector(prefix + "/pre_trace_history", pre_trace_history);
+      checkpoint.write_vector(prefix + "/post_trace_history", post_trace_history);
+    }
+
+    void CustomSTDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      STDPPlasticity::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/stdp_pre_memory_trace", stdp_pre_memory_trace);
+      checkpoint.read_vector_of_same_size(prefix + "/stdp_post_memory_trace", stdp_post_memory_trace);
+      checkpoint.read_vector_of_same_size(prefix + "/pre_trace_history", pre_trace_history);
+      checkpoint.read_vector_of_same_size(prefix + "/post_trace_history", post_trace_history);
+    }
+  }
+}
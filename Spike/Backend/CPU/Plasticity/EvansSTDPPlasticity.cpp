@@ -0,0 +1,91 @@
+#include "EvansSTDPPlasticity.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, EvansSTDPPlasticity);
+
+namespace Backend {
+  namespace CPU {
+    void EvansSTDPPlasticity::prepare() {
+      STDPPlasticity::prepare();
+      recent_postsynaptic_activities_D.resize(total_number_of_plastic_synapses);
+      recent_presynaptic_activities_C.resize(total_number_of_plastic_synapses);
+    }
+
+    void EvansSTDPPlasticity::reset_state() {
+      STDPPlasticity::reset_state();
+      std::copy(frontend()->recent_presynaptic_activities_C,
+                frontend()->recent_presynaptic_activities_C + total_number_of_plastic_synapses,
+                recent_presynaptic_activities_C.begin());
+      std::copy(frontend()->recent_postsynaptic_activities_D,
+                frontend()->recent_postsynaptic_activities_D + total_number_of_plastic_synapses,
+                recent_postsynaptic_activities_D.begin());
+    }
+
+    void EvansSTDPPlasticity::update_synaptic_efficacies_or_weights(unsigned int current_time_in_timesteps, float timestep) {
+      const evans_stdp_plasticity_parameters_struct stdp_vars = *(frontend()->stdp_params);
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      float* weights = synapses_backend->frontend()->synaptic_efficacies_or_weights;
+
+      for_each_plastic_synapse(current_time_in_timesteps, timestep_grouping, [&](int indx, int skipped_timesteps){
+        int idx = plastic_synapse_indices[indx];
+
+        float recent_presynaptic_activity_C = recent_presynaptic_activities_C[indx];
+        float recent_postsynaptic_activity_D = recent_postsynaptic_activities_D[indx];
+        if (skipped_timesteps > 0){
+          recent_presynaptic_activity_C *= powf(1 - (timestep/stdp_vars.decay_term_tau_C), skipped_timesteps);
+          recent_postsynaptic_activity_D *= powf(1 - (timestep/stdp_vars.decay_term_tau_D), skipped_timesteps);
+        }
+        float old_synaptic_weight = weights[idx];
+        float new_synaptic_weight = old_synaptic_weight;
+
+        for (int g = 0; g < timestep_grouping; g++){
+          // Decay the activities
+          recent_presynaptic_activity_C = (1 - (timestep/stdp_vars.decay_term_tau_C)) * recent_presynaptic_activity_C;
+          recent_postsynaptic_activity_D = (1 - (timestep/stdp_vars.decay_term_tau_D)) * recent_postsynaptic_activity_D;
+
+          bool pre_spike = presynaptic_spiked(idx, current_time_in_timesteps + g);
+          bool post_spike = postsynaptic_spiked(idx, current_time_in_timesteps + g);
+
+          // Update the activities
+          if (pre_spike){
+            recent_presynaptic_activity_C += timestep * stdp_vars.synaptic_neurotransmitter_concentration_alpha_C * (1 - recent_presynaptic_activity_C);
+          }
+          if (post_spike){
+            recent_postsynaptic_activity_D += timestep * stdp_vars.model_parameter_alpha_D * (1 - recent_postsynaptic_activity_D);
+          }
+
+          float syn_update_val = 0.0f;
+          old_synaptic_weight = new_synaptic_weight;
+          if (pre_spike){
+            syn_update_val -= (old_synaptic_weight * recent_postsynaptic_activity_D);
+          }
+          if (post_spike){
+            syn_update_val += ((1 - old_synaptic_weight) * recent_presynaptic_activity_C);
+          }
+
+          new_synaptic_weight = old_synaptic_weight + stdp_vars.learning_rate_rho*syn_update_val;
+          if (new_synaptic_weight < 0.0f)
+            new_synaptic_weight = 0.0f;
+          if (new_synaptic_weight > 1.0f)
+            new_synaptic_weight = 1.0f;
+        }
+
+        weights[idx] = new_synaptic_weight;
+        recent_presynaptic_activities_C[indx] = recent_presynaptic_activity_C;
+        recent_postsynaptic_activities_D[indx] = recent_postsynaptic_activity_D;
+      });
+    }
+
+    void EvansSTDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      STDPPlasticity::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/recent_postsynaptic_activities_D", recent_postsynaptic_activities_D);
+      checkpoint.write_vector(prefix + "/recent_presynaptic_activities_C", recent_presynaptic_activities_C);
+    }
+
+    void EvansSTDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      STDPPlasticity::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/recent_postsynaptic_activities_D", recent_postsynaptic_activities_D);
+      checkpoint.read_vector_of_same_size(prefix + "/recent_presynaptic_activities_C", recent_presynaptic_activities_C);
+    }
+  }
+}
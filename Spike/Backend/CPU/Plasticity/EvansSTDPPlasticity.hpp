@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Spike/Plasticity/EvansSTDPPlasticity.hpp"
+#include "STDPPlasticity.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class EvansSTDPPlasticity : public virtual ::Backend::CPU::STDPPlasticity,
+                                public virtual ::Backend::EvansSTDPPlasticity {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(EvansSTDPPlasticity);
+      using ::Backend::EvansSTDPPlasticity::frontend;
+
+      std::vector<float> recent_postsynaptic_activities_D;
+      std::vector<float> recent_presynaptic_activities_C;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      void update_synaptic_efficacies_or_weights(unsigned int current_time_in_timesteps, float timestep) override;
+    };
+  }
+}
@@ -0,0 +1,89 @@
+#include "InhibitorySTDPPlasticity.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, InhibitorySTDPPlasticity);
+
+namespace Backend {
+  namespace CPU {
+    void InhibitorySTDPPlasticity::prepare() {
+      STDPPlasticity::prepare();
+      vogels_pre_memory_trace.resize(total_number_of_plastic_synapses);
+      vogels_post_memory_trace.resize(total_number_of_plastic_synapses);
+    }
+
+    void InhibitorySTDPPlasticity::reset_state() {
+      STDPPlasticity::reset_state();
+      std::fill(vogels_pre_memory_trace.begin(), vogels_pre_memory_trace.end(), 0.0f);
+      std::fill(vogels_post_memory_trace.begin(), vogels_post_memory_trace.end(), 0.0f);
+    }
+
+    void InhibitorySTDPPlasticity::apply_stdp_to_synapse_weights(unsigned int current_time_in_timesteps, float timestep) {
+      const inhibitory_stdp_plasticity_parameters_struct stdp_vars = *(frontend()->stdp_params);
+      float trace_decay = expf(- timestep / stdp_vars.tau_istdp);
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      float* weights = synapses_backend->frontend()->synaptic_efficacies_or_weights;
+
+      for_each_plastic_synapse(current_time_in_timesteps, timestep_grouping, [&](int indx, int skipped_timesteps){
+        int idx = plastic_synapse_indices[indx];
+
+        float vogels_pre_memory_trace_val = vogels_pre_memory_trace[indx];
+        float vogels_post_memory_trace_val = vogels_post_memory_trace[indx];
+        if (skipped_timesteps > 0){
+          vogels_pre_memory_trace_val *= powf(trace_decay, skipped_timesteps);
+          vogels_post_memory_trace_val *= powf(trace_decay, skipped_timesteps);
+        }
+        float old_synaptic_weight = weights[idx];
+        float new_synaptic_weight = old_synaptic_weight;
+
+        for (int g = 0; g < timestep_grouping; g++){
+          // Decay the traces
+          vogels_pre_memory_trace_val *= trace_decay;
+          vogels_post_memory_trace_val *= trace_decay;
+
+          bool pre_spike = presynaptic_spiked(idx, current_time_in_timesteps + g);
+          bool post_spike = postsynaptic_spiked(idx, current_time_in_timesteps + g);
+
+          if (pre_spike)
+            vogels_pre_memory_trace_val += 1.0f;
+          if (post_spike)
+            vogels_post_memory_trace_val += 1.0f;
+
+          float syn_update_val = 0.0f;
+          old_synaptic_weight = new_synaptic_weight;
+          // OnPre Weight Update
+          if (pre_spike){
+            syn_update_val += stdp_vars.learningrate*(vogels_post_memory_trace_val);
+            syn_update_val += -stdp_vars.learningrate*(2.0*stdp_vars.targetrate*stdp_vars.tau_istdp);
+          }
+          // OnPost Weight Update
+          if (post_spike){
+            syn_update_val += stdp_vars.learningrate*(vogels_pre_memory_trace_val);
+          }
+
+          new_synaptic_weight = old_synaptic_weight + syn_update_val;
+          if (new_synaptic_weight < 0.0f)
+            new_synaptic_weight = 0.0f;
+        }
+
+        if (new_synaptic_weight > stdp_vars.w_max)
+          new_synaptic_weight = stdp_vars.w_max;
+
+        weights[idx] = new_synaptic_weight;
+        vogels_pre_memory_trace[indx] = vogels_pre_memory_trace_val;
+        vogels_post_memory_trace[indx] = vogels_post_memory_trace_val;
+      });
+    }
+
+    void InhibitorySTDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      STDPPlasticity::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/vogels_pre_memory_trace", vogels_pre_memory_trace);
+      checkpoint.write_vector(prefix + "/vogels_post_memory_trace", vogels_post_memory_trace);
+    }
+
+    void InhibitorySTDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      STDPPlasticity::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/vogels_pre_memory_trace", vogels_pre_memory_trace);
+      checkpoint.read_vector_of_same_size(prefix + "/vogels_post_memory_trace", vogels_post_memory_trace);
+    }
+  }
+}
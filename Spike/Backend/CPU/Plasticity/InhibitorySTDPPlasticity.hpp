@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Spike/Plasticity/InhibitorySTDPPlasticity.hpp"
+#include "STDPPlasticity.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class InhibitorySTDPPlasticity : public virtual ::Backend::CPU::STDPPlasticity,
+                                     public virtual ::Backend::InhibitorySTDPPlasticity {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(InhibitorySTDPPlasticity);
+      using ::Backend::InhibitorySTDPPlasticity::frontend;
+
+      // One pair of traces per plastic synapse
+      std::vector<float> vogels_pre_memory_trace;
+      std::vector<float> vogels_post_memory_trace;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      void apply_stdp_to_synapse_weights(unsigned int current_time_in_timesteps, float timestep) override;
+    };
+  }
+}
@@ -0,0 +1,14 @@
+#include "Plasticity.hpp"
+
+// SPIKE_EXPORT_BACKEND_TYPE(CPU, Plasticity);
+
+namespace Backend {
+  namespace CPU {
+    void Plasticity::prepare() {
+      pool = thread_pool(context);
+    }
+
+    void Plasticity::reset_state() {
+    }
+  }
+}
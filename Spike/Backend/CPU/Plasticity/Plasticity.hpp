@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Spike/Plasticity/Plasticity.hpp"
+#include "Spike/Backend/CPU/CPUBackend.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class Plasticity : public virtual ::Backend::Plasticity {
+    public:
+      ~Plasticity() override = default;
+      using ::Backend::Plasticity::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      std::shared_ptr<ThreadPool> pool;
+    };
+  }
+}
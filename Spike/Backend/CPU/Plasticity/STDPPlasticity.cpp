@@ -0,0 +1,178 @@
+#include "STDPPlasticity.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+#include <algorithm>
+#include <climits>
+
+// SPIKE_EXPORT_BACKEND_TYPE(CPU, STDPPlasticity);
+
+namespace Backend {
+  namespace CPU {
+    void STDPPlasticity::prepare() {
+      Plasticity::prepare();
+
+      input_neurons_backend = dynamic_cast<::Backend::CPU::SpikingNeurons*>
+        (frontend()->model->input_spiking_neurons->backend());
+      neurons_backend = dynamic_cast<::Backend::CPU::SpikingNeurons*>
+        (frontend()->model->spiking_neurons->backend());
+      synapses_backend = dynamic_cast<::Backend::CPU::SpikingSynapses*>
+        (frontend()->model->spiking_synapses->backend());
+
+      // Get the correct ID
+      int plasticity_id = frontend()->plasticity_rule_id;
+      if (plasticity_id >= 0){
+        total_number_of_plastic_synapses = frontend()->plastic_synapses.size();
+        plastic_synapse_indices = frontend()->plastic_synapses.data();
+      } else {
+        total_number_of_plastic_synapses = 0;
+      }
+
+      number_of_input_neurons = input_neurons_backend->frontend()->total_number_of_neurons;
+      event_driven = frontend()->event_driven;
+      if (!event_driven)
+        return;
+
+      // Counting sort of the plastic synapses by pre and by postsynaptic neuron
+      const int* presynaptic_neuron_indices = synapses_backend->frontend()->presynaptic_neuron_indices;
+      const int* postsynaptic_neuron_indices = synapses_backend->frontend()->postsynaptic_neuron_indices;
+      const int* delays = synapses_backend->frontend()->delays;
+      int number_of_pre_neurons = number_of_input_neurons + neurons_backend->frontend()->total_number_of_neurons;
+      int number_of_post_neurons = neurons_backend->frontend()->total_number_of_neurons;
+
+      plastic_synapses_by_pre_start.assign(number_of_pre_neurons + 1, 0);
+      plastic_synapses_by_post_start.assign(number_of_post_neurons + 1, 0);
+      plastic_synapses_by_pre_min_delay.assign(number_of_pre_neurons, INT_MAX);
+      plastic_synapses_by_pre_max_delay.assign(number_of_pre_neurons, 0);
+      for (int indx = 0; indx < total_number_of_plastic_synapses; indx++){
+        int idx = plastic_synapse_indices[indx];
+        int key = number_of_input_neurons + presynaptic_neuron_indices[idx];
+        plastic_synapses_by_pre_start[key + 1]++;
+        plastic_synapses_by_post_start[postsynaptic_neuron_indices[idx] + 1]++;
+        plastic_synapses_by_pre_min_delay[key] = std::min(plastic_synapses_by_pre_min_delay[key], delays[idx]);
+        plastic_synapses_by_pre_max_delay[key] = std::max(plastic_synapses_by_pre_max_delay[key], delays[idx]);
+      }
+      for (int n = 0; n < number_of_pre_neurons; n++)
+        plastic_synapses_by_pre_start[n + 1] += plastic_synapses_by_pre_start[n];
+      for (int n = 0; n < number_of_post_neurons; n++)
+        plastic_synapses_by_post_start[n + 1] += plastic_synapses_by_post_start[n];
+
+      plastic_synapses_by_pre.resize(total_number_of_plastic_synapses);
+      plastic_synapses_by_post.resize(total_number_of_plastic_synapses);
+      std::vector<int> pre_location(plastic_synapses_by_pre_start.begin(), plastic_synapses_by_pre_start.end() - 1);
+      std::vector<int> post_location(plastic_synapses_by_post_start.begin(), plastic_synapses_by_post_start.end() - 1);
+      for (int indx = 0; indx < total_number_of_plastic_synapses; indx++){
+        int idx = plastic_synapse_indices[indx];
+        plastic_synapses_by_pre[pre_location[number_of_input_neurons + presynaptic_neuron_indices[idx]]++] = indx;
+        plastic_synapses_by_post[post_location[postsynaptic_neuron_indices[idx]]++] = indx;
+      }
+
+      last_update_timestep.resize(total_number_of_plastic_synapses);
+      active_blocks.resize(pool->size());
+      post_active_blocks.resize(pool->size());
+    }
+
+    void STDPPlasticity::prepare_neuron_traces(std::vector<float>& pre_trace_history,
+                                               std::vector<float>& post_trace_history) {
+      // Delayed lookups need at least maximum delay + timestep_grouping timesteps,
+      // which the spike bitbuffers already cover
+      trace_history_length = neurons_backend->neuron_spike_time_bitbuffer_bytesize*8;
+      int number_of_pre_neurons = number_of_input_neurons + neurons_backend->frontend()->total_number_of_neurons;
+      pre_trace_history.assign((size_t)number_of_pre_neurons*trace_history_length, 0.0f);
+      post_trace_history.assign((size_t)neurons_backend->frontend()->total_number_of_neurons*trace_history_length, 0.0f);
+    }
+
+    void STDPPlasticity::reset_state() {
+      Plasticity::reset_state();
+      elapsed_plasticity_timesteps = 0;
+      next_trace_timestep = 0;
+      std::fill(last_update_timestep.begin(), last_update_timestep.end(), 0);
+    }
+
+    long long STDPPlasticity::last_step_active_synapses() {
+      long long count = updated_synapses;
+      updated_synapses = 0;
+      return count;
+    }
+
+    void STDPPlasticity::collect_active_synapses(unsigned int current_time_in_timesteps, int timestep_grouping) {
+      int number_of_pre_neurons = plastic_synapses_by_pre_start.size() - 1;
+      int number_of_post_neurons = plastic_synapses_by_post_start.size() - 1;
+      for (auto& block_list : active_blocks)
+        block_list.clear();
+      for (auto& block_list : post_active_blocks)
+        block_list.clear();
+
+      // Presynaptic neurons: only those with a spike which could arrive
+      // at one of their plastic synapses during this step are inspected
+      pool->parallel_for(number_of_pre_neurons, [&](int begin, int end, int block){
+        for (int key = begin; key < end; key++){
+          if (plastic_synapses_by_pre_start[key] == plastic_synapses_by_pre_start[key + 1])
+            continue;
+          bool is_input = (key < number_of_input_neurons);
+          ::Backend::CPU::SpikingNeurons* pre_backend = is_input ? input_neurons_backend : neurons_backend;
+          int preid = is_input ? CORRECTED_PRESYNAPTIC_ID(key - number_of_input_neurons, true) : (key - number_of_input_neurons);
+          int bufbits = pre_backend->neuron_spike_time_bitbuffer_bytesize*8;
+          int currentloc = (int)(current_time_in_timesteps % bufbits);
+
+          bool spiked = false;
+          for (int offset = -plastic_synapses_by_pre_max_delay[key]; offset < timestep_grouping - plastic_synapses_by_pre_min_delay[key]; offset++){
+            int loc = (currentloc + offset + bufbits) % bufbits;
+            if (pre_backend->spiked(preid, loc)){
+              spiked = true;
+              break;
+            }
+          }
+          if (!spiked)
+            continue;
+
+          for (int i = plastic_synapses_by_pre_start[key]; i < plastic_synapses_by_pre_start[key + 1]; i++){
+            int indx = plastic_synapses_by_pre[i];
+            if (presynaptic_arrives(plastic_synapse_indices[indx], current_time_in_timesteps, timestep_grouping))
+              active_blocks[block].push_back(indx);
+          }
+        }
+      }, 256);
+
+      // Postsynaptic neurons which spiked, skipping synapses already added above
+      pool->parallel_for(number_of_post_neurons, [&](int begin, int end, int block){
+        for (int postid = begin; postid < end; postid++){
+          if (plastic_synapses_by_post_start[postid] == plastic_synapses_by_post_start[postid + 1])
+            continue;
+          bool spiked = false;
+          for (int g = 0; g < timestep_grouping; g++){
+            if (neurons_backend->spiked(postid, neurons_backend->bitloc(current_time_in_timesteps + g))){
+              spiked = true;
+              break;
+            }
+          }
+          if (!spiked)
+            continue;
+
+          for (int i = plastic_synapses_by_post_start[postid]; i < plastic_synapses_by_post_start[postid + 1]; i++){
+            int indx = plastic_synapses_by_post[i];
+            if (!presynaptic_arrives(plastic_synapse_indices[indx], current_time_in_timesteps, timestep_grouping))
+              post_active_blocks[block].push_back(indx);
+          }
+        }
+      }, 256);
+
+      active_plastic_synapses.clear();
+      for (auto& block_list : active_blocks)
+        active_plastic_synapses.insert(active_plastic_synapses.end(), block_list.begin(), block_list.end());
+      for (auto& block_list : post_active_blocks)
+        active_plastic_synapses.insert(active_plastic_synapses.end(), block_list.begin(), block_list.end());
+    }
+
+    void STDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      checkpoint.write_value(prefix + "/elapsed_plasticity_timesteps", elapsed_plasticity_timesteps);
+      checkpoint.write_vector(prefix + "/last_update_timestep", last_update_timestep);
+      checkpoint.write_value(prefix + "/next_trace_timestep", next_trace_timestep);
+    }
+
+    void STDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      elapsed_plasticity_timesteps = checkpoint.read_value<unsigned int>(prefix + "/elapsed_plasticity_timesteps");
+      checkpoint.read_vector_of_same_size(prefix + "/last_update_timestep", last_update_timestep);
+      next_trace_timestep = checkpoint.read_value<unsigned int>(prefix + "/next_trace_timestep");
+    }
+  }
+}
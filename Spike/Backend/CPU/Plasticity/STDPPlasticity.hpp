@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Plasticity.hpp"
+#include "Spike/Plasticity/STDPPlasticity.hpp"
+#include "Spike/Backend/CPU/Neurons/SpikingNeurons.hpp"
+#include "Spike/Backend/CPU/Synapses/SpikingSynapses.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class STDPPlasticity : public virtual ::Backend::CPU::Plasticity,
+                           public virtual ::Backend::STDPPlasticity {
+    public:
+      ~STDPPlasticity() override = default;
+      using ::Backend::STDPPlasticity::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      int total_number_of_plastic_synapses = 0;
+      const int* plastic_synapse_indices = nullptr;
+
+      long long last_step_active_synapses() override;
+
+    protected:
+      // Event driven mode: only synapses listed in active_plastic_synapses
+      // are updated each step, their traces having been decayed lazily over
+      // the timesteps skipped since their last update. Plasticity time only
+      // advances while plasticity is on, as for the clock driven rules.
+      bool event_driven = false;
+      unsigned int elapsed_plasticity_timesteps = 0;
+      std::vector<unsigned int> last_update_timestep;    // Per plastic synapse
+      std::vector<int> active_plastic_synapses;          // Indices into plastic_synapse_indices
+      long long updated_synapses = 0;                    // Since the last call of last_step_active_synapses
+
+      // Fills active_plastic_synapses with every plastic synapse at which a
+      // presynaptic spike arrives, or whose postsynaptic neuron spikes,
+      // within [current_time_in_timesteps, current_time_in_timesteps + timestep_grouping)
+      void collect_active_synapses(unsigned int current_time_in_timesteps, int timestep_grouping);
+
+      // Calls update(indx, skipped_timesteps) for every plastic synapse when
+      // clock driven, or only for the active ones when event driven
+      template <typename F>
+      void for_each_plastic_synapse(unsigned int current_time_in_timesteps, int timestep_grouping, const F& update) {
+        if (!event_driven){
+          updated_synapses += total_number_of_plastic_synapses;
+          pool->parallel_for(total_number_of_plastic_synapses, [&](int begin, int end, int block){
+            for (int indx = begin; indx < end; indx++)
+              update(indx, 0);
+          }, 1024);
+          return;
+        }
+        collect_active_synapses(current_time_in_timesteps, timestep_grouping);
+        updated_synapses += active_plastic_synapses.size();
+        pool->parallel_for(active_plastic_synapses.size(), [&](int begin, int end, int block){
+          for (int i = begin; i < end; i++){
+            int indx = active_plastic_synapses[i];
+            update(indx, skipped_timesteps(indx, timestep_grouping));
+          }
+        }, 256);
+        elapsed_plasticity_timesteps += timestep_grouping;
+      }
+
+      // Timesteps over which a synapse's traces must be decayed before this
+      // step, and marks it as updated until the end of the step
+      inline int skipped_timesteps(int indx, int timestep_grouping) {
+        int skipped = (int)(elapsed_plasticity_timesteps - last_update_timestep[indx]);
+        last_update_timestep[indx] = elapsed_plasticity_timesteps + timestep_grouping;
+        return (skipped > 0) ? skipped : 0;
+      }
+
+
+      ::Backend::CPU::SpikingNeurons* neurons_backend = nullptr;
+      ::Backend::CPU::SpikingNeurons* input_neurons_backend = nullptr;
+      ::Backend::CPU::SpikingSynapses* synapses_backend = nullptr;
+
+      // Plastic synapses grouped by presynaptic (input neurons first) and postsynaptic neuron
+      int number_of_input_neurons = 0;
+      std::vector<int> plastic_synapses_by_pre_start;
+      std::vector<int> plastic_synapses_by_pre;
+      std::vector<int> plastic_synapses_by_pre_min_delay;
+      std::vector<int> plastic_synapses_by_pre_max_delay;
+      std::vector<int> plastic_synapses_by_post_start;
+      std::vector<int> plastic_synapses_by_post;
+      std::vector<std::vector<int>> active_blocks;
+      std::vector<std::vector<int>> post_active_blocks;
+
+      // Per-neuron traces: every presynaptic (keyed as number_of_input_neurons
+      // + presynaptic id) and postsynaptic neuron keeps its trace for each of
+      // the last trace_history_length timesteps, so that a synapse reads its
+      // presynaptic trace as it was delays[synapse] timesteps ago.
+      int trace_history_length = 0;
+      unsigned int next_trace_timestep = 0;
+
+      void prepare_neuron_traces(std::vector<float>& pre_trace_history,
+                                 std::vector<float>& post_trace_history);
+
+      // Advances every neuron's trace over [current_time_in_timesteps,
+      // current_time_in_timesteps + timestep_grouping) with
+      // value = step(neuron, value, t). If plasticity was off since the last
+      // call, the history is first filled with each neuron's last value.
+      template <typename F>
+      void advance_neuron_traces(std::vector<float>& history, unsigned int current_time_in_timesteps, int timestep_grouping, const F& step) {
+        int number_of_neurons = history.size() / trace_history_length;
+        bool resumed = (current_time_in_timesteps != next_trace_timestep);
+        int last_location = ((int)(next_trace_timestep % trace_history_length) + trace_history_length - 1) % trace_history_length;
+        int location = (int)(current_time_in_timesteps % trace_history_length);
+        pool->parallel_for(number_of_neurons, [&](int begin, int end, int block){
+          for (int n = begin; n < end; n++){
+            float* neuron_history = &history[(size_t)n*trace_history_length];
+            float value = neuron_history[last_location];
+            if (resumed)
+              std::fill(neuron_history, neuron_history + trace_history_length, value);
+            for (int g = 0; g < timestep_grouping; g++){
+              value = step(n, value, current_time_in_timesteps + g);
+              neuron_history[(location + g) % trace_history_length] = value;
+            }
+          }
+        }, 1024);
+      }
+
+      // Trace of neuron n as it was delay timesteps before timestep t
+      inline float neuron_trace(const std::vector<float>& history, int n, unsigned int t, int delay = 0) const {
+        int location = (int)(t % trace_history_length) - delay;
+        location = (location < 0) ? (trace_history_length + location) : location;
+        return history[(size_t)n*trace_history_length + location];
+      }
+
+      inline bool pre_neuron_spiked(int key, unsigned int t) const {
+        bool is_input = (key < number_of_input_neurons);
+        ::Backend::CPU::SpikingNeurons* pre_backend = is_input ? input_neurons_backend : neurons_backend;
+        int preid = is_input ? CORRECTED_PRESYNAPTIC_ID(key - number_of_input_neurons, true) : (key - number_of_input_neurons);
+        return pre_backend->spiked(preid, pre_backend->bitloc(t));
+      }
+      inline bool post_neuron_spiked(int postid, unsigned int t) const {
+        return neurons_backend->spiked(postid, neurons_backend->bitloc(t));
+      }
+      inline int pre_neuron_key(int synapse_id) const {
+        return number_of_input_neurons + synapses_backend->frontend()->presynaptic_neuron_indices[synapse_id];
+      }
+
+      inline bool presynaptic_arrives(int synapse_id, unsigned int t, int timestep_grouping) const {
+        for (int g = 0; g < timestep_grouping; g++)
+          if (presynaptic_spiked(synapse_id, t + g))
+            return true;
+        return false;
+      }
+
+      // Spike bit locations of the pre and postsynaptic neuron of synapse_id at timestep t
+      inline bool presynaptic_spiked(int synapse_id, unsigned int t) const {
+        int preid = synapses_backend->frontend()->presynaptic_neuron_indices[synapse_id];
+        bool is_input = PRESYNAPTIC_IS_INPUT(preid);
+        ::Backend::CPU::SpikingNeurons* pre_backend = is_input ? input_neurons_backend : neurons_backend;
+        int bufbits = pre_backend->neuron_spike_time_bitbuffer_bytesize*8;
+        int prebitloc = (int)(t % bufbits) - synapses_backend->frontend()->delays[synapse_id];
+        prebitloc = (prebitloc < 0) ? (bufbits + prebitloc) : prebitloc;
+        return pre_backend->spiked(CORRECTED_PRESYNAPTIC_ID(preid, is_input), prebitloc);
+      }
+      inline bool postsynaptic_spiked(int synapse_id, unsigned int t) const {
+        int postid = synapses_backend->frontend()->postsynaptic_neuron_indices[synapse_id];
+        return neurons_backend->spiked(postid, neurons_backend->bitloc(t));
+      }
+    };
+  }
+}
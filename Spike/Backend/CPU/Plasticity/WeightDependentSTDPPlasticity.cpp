@@ -0,0 +1,141 @@
+#include "WeightDependentSTDPPlasticity.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, WeightDependentSTDPPlasticity);
+
+namespace Backend {
+  namespace CPU {
+    void WeightDependentSTDPPlasticity::prepare() {
+      STDPPlasticity::prepare();
+      if (frontend()->stdp_params->per_neuron_traces){
+        prepare_neuron_traces(pre_trace_history, post_trace_history);
+      } else {
+        stdp_pre_memory_trace.resize(total_number_of_plastic_synapses);
+        stdp_post_memory_trace.resize(total_number_of_plastic_synapses);
+      }
+    }
+
+    void WeightDependentSTDPPlasticity::reset_state() {
+      STDPPlasticity::reset_state();
+      std::fill(stdp_pre_memory_trace.begin(), stdp_pre_memory_trace.end(), 0.0f);
+      std::fill(stdp_post_memory_trace.begin(), stdp_post_memory_trace.end(), 0.0f);
+      std::fill(pre_trace_history.begin(), pre_trace_history.end(), 0.0f);
+      std::fill(post_trace_history.begin(), post_trace_history.end(), 0.0f);
+    }
+
+    void WeightDependentSTDPPlasticity::apply_stdp_to_synapse_weights(unsigned int current_time_in_timesteps, float timestep) {
+      const weightdependent_stdp_plasticity_parameters_struct stdp_vars = *(frontend()->stdp_params);
+      float post_decay = stdp_vars.tau_minus;
+      float pre_decay = stdp_vars.tau_plus;
+      int timestep_grouping = frontend()->model->timestep_grouping;
+      float current_time_in_seconds = current_time_in_timesteps*timestep;
+      const int* presynaptic_neuron_indices = synapses_backend->frontend()->presynaptic_neuron_indices;
+      const int* postsynaptic_neuron_indices = synapses_backend->frontend()->postsynaptic_neuron_indices;
+      const int* delays = synapses_backend->frontend()->delays;
+      float* weights = synapses_backend->frontend()->synaptic_efficacies_or_weights;
+      bool per_neuron_traces = stdp_vars.per_neuron_traces;
+
+      // Per-neuron traces hold, at timestep t, the spikes emitted before t
+      // decayed to t, which is what the per-synapse traces hold at the end of
+      // each group of timesteps
+      if (per_neuron_traces){
+        float pre_step_decay = expf(-timestep / pre_decay);
+        float post_step_decay = expf(-timestep / post_decay);
+        advance_neuron_traces(pre_trace_history, current_time_in_timesteps + 1, timestep_grouping, [&](int key, float trace, unsigned int t){
+          return (trace + (pre_neuron_spiked(key, t - 1) ? stdp_vars.a_plus : 0.0f))*pre_step_decay;
+        });
+        advance_neuron_traces(post_trace_history, current_time_in_timesteps + 1, timestep_grouping, [&](int postid, float trace, unsigned int t){
+          return (trace + (post_neuron_spiked(postid, t - 1) ? stdp_vars.a_minus : 0.0f))*post_step_decay;
+        });
+        next_trace_timestep = current_time_in_timesteps + 1 + timestep_grouping;
+      }
+
+      for_each_plastic_synapse(current_time_in_timesteps, timestep_grouping, [&](int indx, int skipped_timesteps){
+        int idx = plastic_synapse_indices[indx];
+
+        float stdp_pre_memory_trace_val = 0.0f;
+        float stdp_post_memory_trace_val = 0.0f;
+        if (!per_neuron_traces){
+          stdp_pre_memory_trace_val = stdp_pre_memory_trace[indx];
+          stdp_post_memory_trace_val = stdp_post_memory_trace[indx];
+          if (skipped_timesteps > 0){
+            stdp_post_memory_trace_val *= expf(-(skipped_timesteps*timestep) / post_decay);
+            stdp_pre_memory_trace_val *= expf(-(skipped_timesteps*timestep) / pre_decay);
+          }
+        }
+        int postid = postsynaptic_neuron_indices[idx];
+        int preid = presynaptic_neuron_indices[idx];
+        float old_synaptic_weight = weights[idx];
+        float new_synaptic_weight = old_synaptic_weight;
+
+        // Correcting for input vs output neuron types
+        bool is_input = PRESYNAPTIC_IS_INPUT(preid);
+        int corr_preid = CORRECTED_PRESYNAPTIC_ID(preid, is_input);
+        const float* pre_last_spike_times = is_input ? input_neurons_backend->last_spike_time_of_each_neuron.data() : neurons_backend->last_spike_time_of_each_neuron.data();
+
+        // Spike arrival within this group of timesteps, or negative if none
+        int pre_spike_g = ((int)roundf((pre_last_spike_times[corr_preid] - current_time_in_seconds) / timestep)) + delays[idx];
+        int post_spike_g = ((int)roundf((neurons_backend->last_spike_time_of_each_neuron[postid] - current_time_in_seconds) / timestep));
+        if (pre_spike_g >= timestep_grouping)
+          pre_spike_g *= -1;
+
+        if (per_neuron_traces){
+          unsigned int group_end = current_time_in_timesteps + timestep_grouping;
+          stdp_pre_memory_trace_val = neuron_trace(pre_trace_history, pre_neuron_key(idx), group_end, delays[idx]);
+          stdp_post_memory_trace_val = neuron_trace(post_trace_history, postid, group_end);
+        } else {
+          stdp_post_memory_trace_val *= expf(-(timestep_grouping*timestep) / post_decay);
+          stdp_pre_memory_trace_val *= expf(-(timestep_grouping*timestep) / pre_decay);
+
+          stdp_post_memory_trace_val += (post_spike_g >= 0) ? stdp_vars.a_minus*expf(-((timestep_grouping - post_spike_g)*timestep) / post_decay) : 0.0f;
+          stdp_pre_memory_trace_val += (pre_spike_g >= 0) ? stdp_vars.a_plus*expf(-((timestep_grouping - pre_spike_g)*timestep) / pre_decay) : 0.0f;
+        }
+
+        float syn_update_val = 0.0f;
+        // OnPre Weight Update
+        if (pre_spike_g >= 0){
+          float temp_post_trace = stdp_post_memory_trace_val;
+          temp_post_trace += (post_spike_g > pre_spike_g) ? -stdp_vars.a_minus*expf(-((timestep_grouping - post_spike_g)*timestep) / post_decay): 0.0f;
+          temp_post_trace *= (1.0f / (expf(-(timestep_grouping - pre_spike_g)*timestep / post_decay)));
+          syn_update_val -= stdp_vars.lambda * stdp_vars.alpha * old_synaptic_weight * temp_post_trace;
+        }
+        // OnPost Weight Update
+        if (post_spike_g >= 0){
+          float temp_pre_trace = stdp_pre_memory_trace_val;
+          temp_pre_trace += (pre_spike_g > post_spike_g) ? -stdp_vars.a_plus*expf(-((timestep_grouping - pre_spike_g)*timestep) / pre_decay): 0.0f;
+          temp_pre_trace *= (1.0f / (expf(-(timestep_grouping - post_spike_g)*timestep / pre_decay)));
+          syn_update_val += stdp_vars.lambda * (stdp_vars.w_max - old_synaptic_weight) * temp_pre_trace;
+        }
+
+        new_synaptic_weight = old_synaptic_weight + syn_update_val;
+        if (new_synaptic_weight < 0.0f)
+          new_synaptic_weight = 0.0f;
+
+        // Weight Update
+        weights[idx] = new_synaptic_weight;
+
+        // Correctly set the trace values
+        if (!per_neuron_traces){
+          stdp_pre_memory_trace[indx] = stdp_pre_memory_trace_val;
+          stdp_post_memory_trace[indx] = stdp_post_memory_trace_val;
+        }
+      });
+    }
+
+    void WeightDependentSTDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      STDPPlasticity::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/stdp_pre_memory_trace", stdp_pre_memory_trace);
+      checkpoint.write_vector(prefix + "/stdp_post_memory_trace", stdp_post_memory_trace);
+      checkpoint.write_vector(prefix + "/pre_trace_history", pre_trace_history);
+      checkpoint.write_vector(prefix + "/post_trace_history", post_trace_history);
+    }
+
+    void WeightDependentSTDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      STDPPlasticity::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/stdp_pre_memory_trace", stdp_pre_memory_trace);
+      checkpoint.read_vector_of_same_size(prefix + "/stdp_post_memory_trace", stdp_post_memory_trace);
+      checkpoint.read_vector_of_same_size(prefix + "/pre_trace_history", pre_trace_history);
+      checkpoint.read_vector_of_same_size(prefix + "/post_trace_history", post_trace_history);
+    }
+  }
+}
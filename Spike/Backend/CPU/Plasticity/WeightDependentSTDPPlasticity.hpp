@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Spike/Plasticity/WeightDependentSTDPPlasticity.hpp"
+#include "STDPPlasticity.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class WeightDependentSTDPPlasticity : public virtual ::Backend::CPU::STDPPlasticity,
+                                          public virtual ::Backend::WeightDependentSTDPPlasticity {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(WeightDependentSTDPPlasticity);
+      using ::Backend::WeightDependentSTDPPlasticity::frontend;
+
+      // One pair of traces per plastic synapse
+      std::vector<float> stdp_pre_memory_trace;
+      std::vector<float> stdp_post_memory_trace;
+      // Or, with per_neuron_traces, one trace history per neuron
+      std::vector<float> pre_trace_history;
+      std::vector<float> post_trace_history;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      void apply_stdp_to_synapse_weights(unsigned int current_time_in_timesteps, float timestep) override;
+    };
+  }
+}
@@ -0,0 +1,94 @@
+#include "WeightNormSTDPPlasticity.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, WeightNormSTDPPlasticity);
+
+namespace Backend {
+  namespace CPU {
+    void WeightNormSTDPPlasticity::prepare() {
+      // Only the synapses are required, see the CUDA backend
+      Plasticity::prepare();
+      synapses_backend = dynamic_cast<::Backend::CPU::SpikingSynapses*>
+        (frontend()->model->spiking_synapses->backend());
+      total_number_of_plastic_synapses = frontend()->total_number_of_plastic_synapses;
+      plastic_synapse_indices = frontend()->plastic_synapses.data();
+
+      int total_number_of_neurons = frontend()->model->spiking_neurons->total_number_of_neurons;
+      afferent_weight_change_updater.resize(total_number_of_neurons);
+      weight_divisor.resize(total_number_of_neurons);
+      initial_weights.resize(total_number_of_plastic_synapses);
+    }
+
+    void WeightNormSTDPPlasticity::reset_state() {
+      if (total_number_of_plastic_synapses > 0){
+        std::copy(frontend()->initial_weights,
+                  frontend()->initial_weights + total_number_of_plastic_synapses,
+                  initial_weights.begin());
+        std::copy(frontend()->afferent_weight_change_updater,
+                  frontend()->afferent_weight_change_updater + afferent_weight_change_updater.size(),
+                  afferent_weight_change_updater.begin());
+      }
+    }
+
+    void WeightNormSTDPPlasticity::weight_normalization() {
+      if (total_number_of_plastic_synapses == 0)
+        return;
+
+      const int* postsynaptic_neuron_indices = synapses_backend->frontend()->postsynaptic_neuron_indices;
+      float* weights = synapses_backend->frontend()->synaptic_efficacies_or_weights;
+      const float* sum_squared_afferent_values = frontend()->sum_squared_afferent_values;
+      const bool* neuron_in_plasticity_set = frontend()->neuron_in_plasticity_set;
+
+      std::copy(frontend()->afferent_weight_change_updater,
+                frontend()->afferent_weight_change_updater + afferent_weight_change_updater.size(),
+                afferent_weight_change_updater.begin());
+
+      // Serial, so that the sums do not depend upon the number of threads
+      for (int indx = 0; indx < total_number_of_plastic_synapses; indx++){
+        int idx = plastic_synapse_indices[indx];
+        float weight_change = weights[idx] - initial_weights[indx];
+        if (weight_change != 0.0){
+          float update_value = weight_change*weight_change + 2.0f*initial_weights[indx]*weight_change;
+          afferent_weight_change_updater[postsynaptic_neuron_indices[idx]] += update_value;
+        }
+      }
+
+      pool->parallel_for(weight_divisor.size(), [&](int begin, int end, int block){
+        for (int idx = begin; idx < end; idx++){
+          if (neuron_in_plasticity_set[idx]){
+            if ((sum_squared_afferent_values[idx] - afferent_weight_change_updater[idx] < (sum_squared_afferent_values[idx]*0.01)))
+              printf("NORMALIZATION DIFF VERY LARGE. DANGER OF SYNAPSES ALL -> ZERO: %f, %f \n",
+                     sum_squared_afferent_values[idx],
+                     afferent_weight_change_updater[idx]);
+            weight_divisor[idx] = sqrtf(sum_squared_afferent_values[idx] + afferent_weight_change_updater[idx]) / sqrtf(sum_squared_afferent_values[idx]);
+          }
+        }
+      }, 1024);
+
+      updated_synapses += total_number_of_plastic_synapses;
+      pool->parallel_for(total_number_of_plastic_synapses, [&](int begin, int end, int block){
+        for (int indx = begin; indx < end; indx++){
+          int idx = plastic_synapse_indices[indx];
+          int postneuron = postsynaptic_neuron_indices[idx];
+          if (neuron_in_plasticity_set[postneuron]){
+            float division_value = weight_divisor[postneuron];
+            if (division_value != 1.0)
+              weights[idx] /= division_value;
+          }
+        }
+      }, 1024);
+    }
+
+    void WeightNormSTDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      checkpoint.write_vector(prefix + "/afferent_weight_change_updater", afferent_weight_change_updater);
+      checkpoint.write_vector(prefix + "/initial_weights", initial_weights);
+      checkpoint.write_vector(prefix + "/weight_divisor", weight_divisor);
+    }
+
+    void WeightNormSTDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      checkpoint.read_vector_of_same_size(prefix + "/afferent_weight_change_updater", afferent_weight_change_updater);
+      checkpoint.read_vector_of_same_size(prefix + "/initial_weights", initial_weights);
+      checkpoint.read_vector_of_same_size(prefix + "/weight_divisor", weight_divisor);
+    }
+  }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Spike/Plasticity/WeightNormSTDPPlasticity.hpp"
+#include "STDPPlasticity.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class WeightNormSTDPPlasticity : public virtual ::Backend::CPU::STDPPlasticity,
+                                     public virtual ::Backend::WeightNormSTDPPlasticity {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(WeightNormSTDPPlasticity);
+      using ::Backend::WeightNormSTDPPlasticity::frontend;
+
+      std::vector<float> afferent_weight_change_updater;
+      std::vector<float> initial_weights;
+      std::vector<float> weight_divisor;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      void weight_normalization() override;
+    };
+  }
+}
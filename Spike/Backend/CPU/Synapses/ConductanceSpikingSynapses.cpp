@@ -0,0 +1,31 @@
+#include "ConductanceSpikingSynapses.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, ConductanceSpikingSynapses);
+
+namespace Backend {
+  namespace CPU {
+    void ConductanceSpikingSynapses::prepare() {
+      SpikingSynapses::prepare();
+      neuron_wise_conductance_trace.resize(neuron_pop_size*frontend()->num_syn_labels);
+      decay_factors_g.resize(frontend()->num_syn_labels);
+      for (int syn_label = 0; syn_label < frontend()->num_syn_labels; syn_label++)
+        decay_factors_g[syn_label] = expf(-frontend()->model->timestep / frontend()->decay_terms_tau_g[syn_label]);
+    }
+
+    void ConductanceSpikingSynapses::reset_state() {
+      SpikingSynapses::reset_state();
+      std::fill(neuron_wise_conductance_trace.begin(), neuron_wise_conductance_trace.end(), 0.0f);
+    }
+
+    void ConductanceSpikingSynapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      SpikingSynapses::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/neuron_wise_conductance_trace", neuron_wise_conductance_trace);
+    }
+
+    void ConductanceSpikingSynapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      SpikingSynapses::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/neuron_wise_conductance_trace", neuron_wise_conductance_trace);
+    }
+  }
+}
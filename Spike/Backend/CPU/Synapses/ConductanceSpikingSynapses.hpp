@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Spike/Synapses/ConductanceSpikingSynapses.hpp"
+#include "SpikingSynapses.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class ConductanceSpikingSynapses : public virtual ::Backend::CPU::SpikingSynapses,
+                                       public virtual ::Backend::ConductanceSpikingSynapses {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(ConductanceSpikingSynapses);
+      using ::Backend::ConductanceSpikingSynapses::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      // One conductance per (postsynaptic neuron, synapse label)
+      std::vector<float> neuron_wise_conductance_trace;
+      std::vector<float> decay_factors_g;
+
+      float input_injection(float multiplication_to_volts,
+                            float current_membrane_voltage,
+                            unsigned int current_time_in_timesteps,
+                            float timestep,
+                            int idx,
+                            int g) override final {
+        int num_syn_labels = frontend()->num_syn_labels;
+        float* inputs = &circular_input_buffer[((current_time_in_timesteps + g) % buffersize)*input_buffersize + idx*num_syn_labels];
+        float* traces = &neuron_wise_conductance_trace[idx*num_syn_labels];
+
+        float total_current = 0.0f;
+        for (int syn_label = 0; syn_label < num_syn_labels; syn_label++){
+          // Update the synaptic conductance and reset the conductance update
+          float synaptic_conductance_g = decay_factors_g[syn_label]*traces[syn_label] + inputs[syn_label];
+          inputs[syn_label] = 0.0f;
+          total_current += synaptic_conductance_g*(frontend()->reversal_potentials_Vhat[syn_label] - current_membrane_voltage);
+          traces[syn_label] = synaptic_conductance_g;
+        }
+        return total_current*multiplication_to_volts;
+      }
+    };
+  }
+}
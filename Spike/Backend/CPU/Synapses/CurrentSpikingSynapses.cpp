@@ -0,0 +1,31 @@
+#include "CurrentSpikingSynapses.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, CurrentSpikingSynapses);
+
+namespace Backend {
+  namespace CPU {
+    void CurrentSpikingSynapses::prepare() {
+      SpikingSynapses::prepare();
+      neuron_wise_current_trace.resize(neuron_pop_size*frontend()->num_syn_labels);
+      decay_factors.resize(frontend()->num_syn_labels);
+      for (int syn_label = 0; syn_label < frontend()->num_syn_labels; syn_label++)
+        decay_factors[syn_label] = expf(-frontend()->model->timestep / frontend()->decay_terms_tau[syn_label]);
+    }
+
+    void CurrentSpikingSynapses::reset_state() {
+      SpikingSynapses::reset_state();
+      std::fill(neuron_wise_current_trace.begin(), neuron_wise_current_trace.end(), 0.0f);
+    }
+
+    void CurrentSpikingSynapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      SpikingSynapses::save_state(checkpoint, prefix);
+      checkpoint.write_vector(prefix + "/neuron_wise_current_trace", neuron_wise_current_trace);
+    }
+
+    void CurrentSpikingSynapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      SpikingSynapses::load_state(checkpoint, prefix);
+      checkpoint.read_vector_of_same_size(prefix + "/neuron_wise_current_trace", neuron_wise_current_trace);
+    }
+  }
+}
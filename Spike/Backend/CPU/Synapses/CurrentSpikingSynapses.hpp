@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Spike/Synapses/CurrentSpikingSynapses.hpp"
+#include "SpikingSynapses.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class CurrentSpikingSynapses : public virtual ::Backend::CPU::SpikingSynapses,
+                                   public virtual ::Backend::CurrentSpikingSynapses {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(CurrentSpikingSynapses);
+      using ::Backend::CurrentSpikingSynapses::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      // One current per (postsynaptic neuron, synapse label)
+      std::vector<float> neuron_wise_current_trace;
+      std::vector<float> decay_factors;
+
+      float input_injection(float multiplication_to_volts,
+                            float current_membrane_voltage,
+                            unsigned int current_time_in_timesteps,
+                            float timestep,
+                            int idx,
+                            int g) override final {
+        int num_syn_labels = frontend()->num_syn_labels;
+        float* inputs = &circular_input_buffer[((current_time_in_timesteps + g) % buffersize)*input_buffersize + idx*num_syn_labels];
+        float* traces = &neuron_wise_current_trace[idx*num_syn_labels];
+
+        float total_current = 0.0f;
+        for (int syn_label = 0; syn_label < num_syn_labels; syn_label++){
+          float synaptic_current = decay_factors[syn_label]*traces[syn_label] + inputs[syn_label];
+          inputs[syn_label] = 0.0f;
+          total_current += synaptic_current;
+          traces[syn_label] = synaptic_current;
+        }
+        return total_current*multiplication_to_volts;
+      }
+    };
+  }
+}
@@ -0,0 +1,354 @@
+#include "SpikingSynapses.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
+#include <algorithm>
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, SpikingSynapses);
+
+namespace Backend {
+  namespace CPU {
+    void SpikingSynapses::prepare() {
+      Synapses::prepare();
+
+      // Every neuron must have a row, even those without afferent synapses
+      neuron_pop_size = std::max(frontend()->neuron_pop_size, frontend()->model->spiking_neurons->total_number_of_neurons);
+      buffersize = frontend()->maximum_axonal_delay_in_timesteps + 2*frontend()->model->timestep_grouping + 1;
+      input_buffersize = neuron_pop_size*frontend()->num_syn_labels;
+      circular_input_buffer.resize(buffersize*input_buffersize);
+
+      // Synapses are already sorted by presynaptic neuron (see SpikingSynapses::prepare_backend_early)
+      std::vector<bool> synapse_is_dense;
+      std::vector<dense_synapse_row> rows;
+      find_dense_groups(synapse_is_dense, rows);
+      index_efferent_synapses(neuron_efferents, frontend()->model->spiking_neurons, false, synapse_is_dense, rows);
+      index_efferent_synapses(input_neuron_efferents, frontend()->model->input_spiking_neurons, true, synapse_is_dense, rows);
+      procedural_synaptic_events.assign(pool->size(), 0);
+      procedural_targets.resize(pool->size());
+    }
+
+    void SpikingSynapses::find_dense_groups(std::vector<bool>& synapse_is_dense, std::vector<dense_synapse_row>& rows) {
+      int total_number_of_synapses = frontend()->total_number_of_synapses;
+      const int* presynaptic_neuron_indices = frontend()->presynaptic_neuron_indices;
+      const int* postsynaptic_neuron_indices = frontend()->postsynaptic_neuron_indices;
+      const int* delays = frontend()->delays;
+      const int* syn_labels = frontend()->syn_labels;
+      const float* weight_scaling_constants = frontend()->weight_scaling_constants;
+      // Maps the order in which synapses were added to their sorted ids
+      const int* sorted_ids = frontend()->synapse_reversesort_indices;
+      const std::vector<int>& last_index_of_synapse_per_group = frontend()->last_index_of_synapse_per_group;
+
+      dense_row_groups.clear();
+      synapse_is_dense.assign(total_number_of_synapses, false);
+      // A group is dense if its synapses, in the order they were added, are rows of
+      // one presynaptic neuron each, every row has the same postsynaptic neurons
+      // (consecutive, in order), and they all have one delay, label and scaling
+      // constant. Each row must also be consecutive once sorted.
+      for (int group_id = 0; group_id < (int)last_index_of_synapse_per_group.size(); group_id++){
+        int first = (group_id > 0) ? last_index_of_synapse_per_group[group_id - 1] : 0;
+        int count = last_index_of_synapse_per_group[group_id] - first;
+        if (count == 0)
+          continue;
+
+        int first_id = sorted_ids[first];
+        dense_row_group group;
+        group.postsynaptic_start = postsynaptic_neuron_indices[first_id];
+        group.delay = delays[first_id];
+        group.syn_label = syn_labels[first_id];
+        group.weight_scaling_constant = weight_scaling_constants[first_id];
+        group.weight_matrix = -1;
+        int row_length = 1;
+        while ((row_length < count) && (presynaptic_neuron_indices[sorted_ids[first + row_length]] == presynaptic_neuron_indices[first_id]))
+          row_length++;
+        group.number_of_postsynaptic_neurons = row_length;
+        if (count % row_length != 0)
+          continue;
+
+        bool dense = true;
+        for (int row = 0; dense && (row < count / row_length); row++){
+          int row_start = sorted_ids[first + row*row_length];
+          for (int column = 0; column < row_length; column++){
+            int synapse_id = sorted_ids[first + row*row_length + column];
+            if ((synapse_id != row_start + column) ||
+                synapse_is_dense[synapse_id] ||
+                (presynaptic_neuron_indices[synapse_id] != presynaptic_neuron_indices[row_start]) ||
+                (postsynaptic_neuron_indices[synapse_id] != group.postsynaptic_start + column) ||
+                (delays[synapse_id] != group.delay) ||
+                (syn_labels[synapse_id] != group.syn_label) ||
+                (weight_scaling_constants[synapse_id] != group.weight_scaling_constant)){
+              dense = false;
+              break;
+            }
+          }
+        }
+        if (!dense)
+          continue;
+
+        for (int row = 0; row < count / row_length; row++){
+          int row_start = sorted_ids[first + row*row_length];
+          std::fill(synapse_is_dense.begin() + row_start, synapse_is_dense.begin() + row_start + row_length, true);
+          rows.push_back({presynaptic_neuron_indices[row_start], row_start, (int)dense_row_groups.size()});
+        }
+        dense_row_groups.push_back(group);
+      }
+      // In synapse order, so that each neuron's rows are in the order of its efferent synapses
+      std::sort(rows.begin(), rows.end(), [](const dense_synapse_row& a, const dense_synapse_row& b){ return a.start < b.start; });
+
+      // The rows of the frontend's weight matrices follow, in group order
+      const std::vector<dense_synapse_group>& weight_matrices = frontend()->dense_groups;
+      for (int m = 0; m < (int)weight_matrices.size(); m++){
+        const dense_synapse_group& matrix = weight_matrices[m];
+        dense_row_group group;
+        group.postsynaptic_start = matrix.postsynaptic_start;
+        group.number_of_postsynaptic_neurons = matrix.number_of_postsynaptic_neurons;
+        group.delay = matrix.delay;
+        group.syn_label = matrix.syn_label;
+        group.weight_scaling_constant = matrix.weight_scaling_constant;
+        group.weight_matrix = m;
+        for (int pre = 0; pre < matrix.number_of_presynaptic_neurons; pre++)
+          rows.push_back({CORRECTED_PRESYNAPTIC_ID(matrix.presynaptic_start + pre, matrix.presynaptic_group_is_input), pre, (int)dense_row_groups.size()});
+        dense_row_groups.push_back(group);
+      }
+    }
+
+    void SpikingSynapses::index_efferent_synapses(efferent_synapse_index& efferents,
+                                                  ::SpikingNeurons* presynaptic_neurons,
+                                                  bool presynaptic_neurons_are_input,
+                                                  const std::vector<bool>& synapse_is_dense,
+                                                  const std::vector<dense_synapse_row>& rows) {
+      efferents = efferent_synapse_index();
+      if (!presynaptic_neurons)
+        return;
+      int number_of_neurons = presynaptic_neurons->total_number_of_neurons;
+      const int* starts = presynaptic_neurons->per_neuron_efferent_synapse_start;
+      const int* counts = presynaptic_neurons->per_neuron_efferent_synapse_count;
+      const int* postsynaptic_neuron_indices = frontend()->postsynaptic_neuron_indices;
+
+      // Rows are bucketed by neuron (input neurons are sorted in descending order)
+      efferents.dense_offsets.assign(number_of_neurons + 1, 0);
+      for (const auto& row : rows){
+        int presynaptic_id = row.presynaptic_neuron_id;
+        if ((presynaptic_id < 0) == presynaptic_neurons_are_input)
+          efferents.dense_offsets[CORRECTED_PRESYNAPTIC_ID(presynaptic_id, presynaptic_neurons_are_input) + 1]++;
+      }
+      for (int neuron_id = 0; neuron_id < number_of_neurons; neuron_id++)
+        efferents.dense_offsets[neuron_id + 1] += efferents.dense_offsets[neuron_id];
+      efferents.dense_rows.resize(efferents.dense_offsets[number_of_neurons]);
+      std::vector<int> positions(efferents.dense_offsets.begin(), efferents.dense_offsets.end() - 1);
+      for (const auto& row : rows){
+        int presynaptic_id = row.presynaptic_neuron_id;
+        if ((presynaptic_id < 0) == presynaptic_neurons_are_input)
+          efferents.dense_rows[positions[CORRECTED_PRESYNAPTIC_ID(presynaptic_id, presynaptic_neurons_are_input)]++] = row;
+      }
+
+      const std::vector<convolutional_synapse_group>& convolutional_groups = frontend()->convolutional_groups;
+      for (int c = 0; c < (int)convolutional_groups.size(); c++)
+        if (convolutional_groups[c].presynaptic_group_is_input == presynaptic_neurons_are_input)
+          efferents.convolutional_groups.push_back(c);
+      const std::vector<procedural_synapse_group>& procedural_groups = frontend()->procedural_groups;
+      for (int p = 0; p < (int)procedural_groups.size(); p++)
+        if (procedural_groups[p].presynaptic_group_is_input == presynaptic_neurons_are_input)
+          efferents.procedural_groups.push_back(p);
+
+      efferents.sparse_offsets.assign(number_of_neurons + 1, 0);
+      for (int neuron_id = 0; neuron_id < number_of_neurons; neuron_id++){
+        int sparse_start = efferents.sparse_synapses.size();
+        for (int synapse_id = starts[neuron_id]; synapse_id < starts[neuron_id] + counts[neuron_id]; synapse_id++)
+          if (!synapse_is_dense[synapse_id])
+            efferents.sparse_synapses.push_back(synapse_id);
+        std::stable_sort(efferents.sparse_synapses.begin() + sparse_start, efferents.sparse_synapses.end(),
+                         [&](int a, int b){ return postsynaptic_neuron_indices[a] < postsynaptic_neuron_indices[b]; });
+        efferents.sparse_offsets[neuron_id + 1] = efferents.sparse_synapses.size();
+      }
+    }
+
+    void SpikingSynapses::reset_state() {
+      Synapses::reset_state();
+      std::fill(circular_input_buffer.begin(), circular_input_buffer.end(), 0.0f);
+      active_synapses.clear();
+    }
+
+    void SpikingSynapses::copy_weights_to_host() {
+    }
+
+    float SpikingSynapses::input_injection(float multiplication_to_volts,
+                                           float current_membrane_voltage,
+                                           unsigned int current_time_in_timesteps,
+                                           float timestep,
+                                           int idx,
+                                           int g) {
+      return 0.0f;
+    }
+
+    void SpikingSynapses::collect_activations(::Backend::CPU::SpikingNeurons* neurons_backend, const efferent_synapse_index& efferents) {
+      if (!neurons_backend)
+        return;
+      const int* counts = neurons_backend->frontend()->per_neuron_efferent_synapse_count;
+      // Blocks are in ascending neuron order, whatever the number of threads
+      for (auto& block_activations : neurons_backend->activations){
+        for (auto& activation : block_activations){
+          int neuron_id = activation.neuron_id;
+          int sparse_offset = efferents.sparse_offsets[neuron_id];
+          int dense_offset = efferents.dense_offsets[neuron_id];
+          active_synapses.push_back({efferents.sparse_synapses.data() + sparse_offset,
+                                     efferents.sparse_offsets[neuron_id + 1] - sparse_offset,
+                                     efferents.dense_rows.data() + dense_offset,
+                                     efferents.dense_offsets[neuron_id + 1] - dense_offset,
+                                     counts[neuron_id],
+                                     activation.group_index,
+                                     neuron_id,
+                                     &efferents.convolutional_groups,
+                                     &efferents.procedural_groups});
+        }
+        block_activations.clear();
+      }
+    }
+
+    void SpikingSynapses::state_update(unsigned int current_time_in_timesteps, float timestep) {
+      // The neuron backends are made after this one, so are only looked up on the first step
+      if (!presynaptic_backends_resolved){
+        neurons_backend = dynamic_cast<::Backend::CPU::SpikingNeurons*>
+          (frontend()->model->spiking_neurons->backend());
+        input_neurons_backend = dynamic_cast<::Backend::CPU::SpikingNeurons*>
+          (frontend()->model->input_spiking_neurons->backend());
+        presynaptic_backends_resolved = true;
+      }
+
+      active_synapses.clear();
+      std::fill(procedural_synaptic_events.begin(), procedural_synaptic_events.end(), 0);
+      collect_activations(neurons_backend, neuron_efferents);
+      collect_activations(input_neurons_backend, input_neuron_efferents);
+      if (active_synapses.empty())
+        return;
+
+      int bufferloc = current_time_in_timesteps % buffersize;
+      int num_syn_labels = frontend()->num_syn_labels;
+      const int* postsynaptic_neuron_indices = frontend()->postsynaptic_neuron_indices;
+      const int* delays = frontend()->delays;
+      const int* syn_labels = frontend()->syn_labels;
+      const float* weights = frontend()->synaptic_efficacies_or_weights;
+      const float* weight_scaling_constants = frontend()->weight_scaling_constants;
+      const std::vector<dense_synapse_group>& weight_matrices = frontend()->dense_groups;
+      const std::vector<convolutional_synapse_group>& convolutional_groups = frontend()->convolutional_groups;
+      const std::vector<procedural_synapse_group>& procedural_groups = frontend()->procedural_groups;
+
+      // Each block owns a range of postsynaptic neurons: no two blocks write the same
+      // location and every location sums its inputs in the same order.
+      pool->parallel_for(neuron_pop_size, [&](int begin, int end, int block){
+        bool all_neurons = (begin == 0) && (end == neuron_pop_size);
+        long long procedural_events = 0;
+        auto post_less = [&](int synapse_id, int post){ return postsynaptic_neuron_indices[synapse_id] < post; };
+        for (const auto& activation : active_synapses){
+          const int* first = activation.sparse_synapses;
+          const int* last = first + activation.sparse_synapse_count;
+          if (!all_neurons){
+            first = std::lower_bound(first, last, begin, post_less);
+            last = std::lower_bound(first, last, end, post_less);
+          }
+          for (const int* s = first; s < last; s++){
+            int synapse_id = *s;
+            int postneuron = postsynaptic_neuron_indices[synapse_id];
+            int targetloc = (bufferloc + delays[synapse_id] + activation.group_index) % buffersize;
+            circular_input_buffer[targetloc*input_buffersize + syn_labels[synapse_id] + postneuron*num_syn_labels] += weights[synapse_id]*weight_scaling_constants[synapse_id];
+          }
+
+          // Dense rows are added to the block's part of their postsynaptic range
+          for (int r = 0; r < activation.dense_row_count; r++){
+            const dense_synapse_row& row = activation.dense_rows[r];
+            const dense_row_group& group = dense_row_groups[row.group];
+            int first_post = std::max(begin, group.postsynaptic_start);
+            int last_post = std::min(end, group.postsynaptic_start + group.number_of_postsynaptic_neurons);
+            if (first_post >= last_post)
+              continue;
+            int targetloc = (bufferloc + group.delay + activation.group_index) % buffersize;
+            int length = last_post - first_post;
+            const float* row_weights = (group.weight_matrix < 0) ?
+              weights + row.start :
+              weight_matrices[group.weight_matrix].weights.data() + (size_t)row.start*group.number_of_postsynaptic_neurons;
+            row_weights += first_post - group.postsynaptic_start;
+            float* row_input = circular_input_buffer.data() + targetloc*input_buffersize + group.syn_label + first_post*num_syn_labels;
+            float weight_scaling_constant = group.weight_scaling_constant;
+            if (num_syn_labels == 1){
+              for (int j = 0; j < length; j++)
+                row_input[j] += row_weights[j]*weight_scaling_constant;
+            } else {
+              for (int j = 0; j < length; j++)
+                row_input[j*num_syn_labels] += row_weights[j]*weight_scaling_constant;
+            }
+          }
+
+          // Convolutional synapses are found from the group shapes
+          for (int c : *activation.convolutional_groups){
+            const convolutional_synapse_group& group = convolutional_groups[c];
+            int pre = activation.presynaptic_neuron_id - group.presynaptic_start;
+            if ((pre < 0) || (pre >= group.presynaptic_shape[0]*group.presynaptic_shape[1]) ||
+                (group.postsynaptic_start >= end) ||
+                (group.postsynaptic_start + group.postsynaptic_shape[0]*group.postsynaptic_shape[1] <= begin))
+              continue;
+            int targetloc = (bufferloc + group.delay + activation.group_index) % buffersize;
+            float* group_input = circular_input_buffer.data() + targetloc*input_buffersize + group.syn_label;
+            const float* kernel_weights = group.kernel_weights.data();
+            float weight_scaling_constant = group.weight_scaling_constant;
+            group.for_each_target(pre, [&](int postneuron, int kernel_index){
+                if ((postneuron >= begin) && (postneuron < end))
+                  group_input[postneuron*num_syn_labels] += kernel_weights[kernel_index]*weight_scaling_constant;
+              });
+          }
+
+          // Procedural synapses are regenerated, for the block's postsynaptic neurons only
+          for (int p : *activation.procedural_groups){
+            const procedural_synapse_group& group = procedural_groups[p];
+            int pre = activation.presynaptic_neuron_id - group.presynaptic_start;
+            if ((pre < 0) || (pre >= group.number_of_presynaptic_neurons))
+              continue;
+            float* group_input = circular_input_buffer.data() + group.syn_label;
+            float weight_scaling_constant = group.weight_scaling_constant;
+            int timestep_offset = bufferloc + activation.group_index;
+            std::vector<procedural_target>& targets = procedural_targets[block];
+            targets.clear();
+            group.for_each_target(pre, begin, end, [&](int postneuron, float weight, int delay){
+                targets.push_back({postneuron, weight, delay});
+              });
+            // Added once all are generated, so that the scattered writes overlap as those of stored synapses do
+            for (const auto& target : targets){
+              int targetloc = (timestep_offset + target.delay) % buffersize;
+              group_input[targetloc*input_buffersize + target.postsynaptic_neuron_id*num_syn_labels] += target.weight*weight_scaling_constant;
+            }
+            procedural_events += targets.size();
+          }
+        }
+        procedural_synaptic_events[block] = procedural_events;
+      }, 256);
+    }
+
+    void SpikingSynapses::last_step_activity(long long& presynaptic_spikes, long long& synaptic_events) {
+      presynaptic_spikes = active_synapses.size();
+      synaptic_events = 0;
+      for (const auto& activation : active_synapses){
+        synaptic_events += activation.synapse_count;
+        // Rows of weight matrices are not counted in synapse_count (which is of stored synapses)
+        for (int r = 0; r < activation.dense_row_count; r++){
+          const dense_row_group& group = dense_row_groups[activation.dense_rows[r].group];
+          if (group.weight_matrix >= 0)
+            synaptic_events += group.number_of_postsynaptic_neurons;
+        }
+        for (int c : *activation.convolutional_groups){
+          const convolutional_synapse_group& group = frontend()->convolutional_groups[c];
+          int pre = activation.presynaptic_neuron_id - group.presynaptic_start;
+          if ((pre >= 0) && (pre < group.presynaptic_shape[0]*group.presynaptic_shape[1]))
+            group.for_each_target(pre, [&](int postneuron, int kernel_index){ synaptic_events++; });
+        }
+      }
+      // Procedural synapses were counted as they were generated
+      for (long long events : procedural_synaptic_events)
+        synaptic_events += events;
+    }
+
+
+    void SpikingSynapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+      checkpoint.write_vector(prefix + "/circular_input_buffer", circular_input_buffer);
+    }
+
+    void SpikingSynapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+      checkpoint.read_vector_of_same_size(prefix + "/circular_input_buffer", circular_input_buffer);
+    }
+  } // namespace CPU
+} // namespace Backend
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Spike/Synapses/SpikingSynapses.hpp"
+#include "Synapses.hpp"
+#include "Spike/Backend/CPU/Neurons/SpikingNeurons.hpp"
+
+namespace Backend {
+  namespace CPU {
+    /**
+     *  A synapse group which connects every presynaptic neuron of a range to
+     *  every postsynaptic neuron of a range, with one delay, label and weight
+     *  scaling constant. Its weights are the rows of a row-major matrix: that of
+     *  a frontend dense group, or the group's stored synapses once sorted by
+     *  presynaptic neuron (for CONNECTIVITY_TYPE_ALL_TO_ALL groups stored
+     *  synapse by synapse, e.g. plastic ones). It is propagated row by row
+     *  without reading per-synapse indices, delays or labels.
+     */
+    struct dense_row_group {
+      int postsynaptic_start;
+      int number_of_postsynaptic_neurons;
+      int delay;
+      int syn_label;
+      float weight_scaling_constant;
+      int weight_matrix;    /**< Index in the frontend's dense_groups, or -1 if the rows are stored synapses */
+    };
+
+    // The synapses of one presynaptic neuron in a dense group
+    struct dense_synapse_row {
+      int presynaptic_neuron_id;    /**< As in the frontend's presynaptic_neuron_indices */
+      int start;                    /**< Synapse id of its first synapse (the rest follow in postsynaptic order), or its row of the weight matrix */
+      int group;                    /**< Index in SpikingSynapses::dense_row_groups */
+    };
+
+    // The efferent synapses of the neurons of one presynaptic population
+    struct efferent_synapse_index {
+      std::vector<int> sparse_offsets;              /**< Neuron i's sparse synapses are sparse_synapses[sparse_offsets[i]:sparse_offsets[i+1]] */
+      std::vector<int> sparse_synapses;             /**< Synapse ids, sorted by postsynaptic neuron within each neuron's range */
+      std::vector<int> dense_offsets;               /**< Likewise for dense_rows */
+      std::vector<dense_synapse_row> dense_rows;
+      std::vector<int> convolutional_groups;        /**< Indices in the frontend's convolutional_groups of those from this population */
+      std::vector<int> procedural_groups;           /**< Likewise for the frontend's procedural_groups */
+    };
+
+    // The efferent synapses of one spiking neuron
+    struct synaptic_activation {
+      const int* sparse_synapses;
+      int sparse_synapse_count;
+      const dense_synapse_row* dense_rows;
+      int dense_row_count;
+      int synapse_count;
+      int group_index;
+      int presynaptic_neuron_id;
+      const std::vector<int>* convolutional_groups;
+      const std::vector<int>* procedural_groups;
+    };
+
+    // A synapse of a procedural group, as generated when its presynaptic neuron spikes
+    struct procedural_target {
+      int postsynaptic_neuron_id;
+      float weight;
+      int delay;
+    };
+
+    class SpikingSynapses : public virtual ::Backend::CPU::Synapses,
+                            public virtual ::Backend::SpikingSynapses {
+    public:
+      SpikingSynapses() = default;
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(SpikingSynapses);
+      using ::Backend::SpikingSynapses::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+      void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+      void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+      void copy_weights_to_host() override;
+      void state_update(unsigned int current_time_in_timesteps, float timestep) override;
+      void last_step_activity(long long& presynaptic_spikes, long long& synaptic_events) override;
+
+      // Circular buffer of synaptic input, one row of input_buffersize per timestep
+      int neuron_pop_size = 0;
+      int buffersize = 0;
+      int input_buffersize = 0;
+      std::vector<float> circular_input_buffer;
+
+      // Dense groups are found when the backend is prepared. Sparse synapses are
+      // sorted by postsynaptic neuron so that each block of postsynaptic neurons
+      // finds its own synapses.
+      std::vector<dense_row_group> dense_row_groups;
+      efferent_synapse_index neuron_efferents;
+      efferent_synapse_index input_neuron_efferents;
+
+      std::vector<synaptic_activation> active_synapses;
+      std::vector<long long> procedural_synaptic_events;   /**< Per thread pool block, in the last step */
+      std::vector<std::vector<procedural_target>> procedural_targets;   /**< Per thread pool block, re-used */
+
+      /**
+       *  Returns the input to postsynaptic neuron idx for timestep (t + g) and clears
+       *  the corresponding buffer entries. Called by the neuron backends, once per
+       *  neuron and timestep: the synapse types define it inline and final, so
+       *  that a neuron backend which knows the type calls it without dispatch.
+       */
+      virtual float input_injection(float multiplication_to_volts,
+                                    float current_membrane_voltage,
+                                    unsigned int current_time_in_timesteps,
+                                    float timestep,
+                                    int idx,
+                                    int g);
+
+    protected:
+      void collect_activations(::Backend::CPU::SpikingNeurons* neurons_backend, const efferent_synapse_index& efferents);
+
+    private:
+      void find_dense_groups(std::vector<bool>& synapse_is_dense, std::vector<dense_synapse_row>& rows);
+      void index_efferent_synapses(efferent_synapse_index& efferents,
+                                   ::SpikingNeurons* presynaptic_neurons,
+                                   bool presynaptic_neurons_are_input,
+                                   const std::vector<bool>& synapse_is_dense,
+                                   const std::vector<dense_synapse_row>& rows);
+
+      bool presynaptic_backends_resolved = false;
+      ::Backend::CPU::SpikingNeurons* neurons_backend = nullptr;
+      ::Backend::CPU::SpikingNeurons* input_neurons_backend = nullptr;
+    };
+  } // namespace CPU
+} // namespace Backend
@@ -0,0 +1,21 @@
+#include "Synapses.hpp"
+
+// SPIKE_EXPORT_BACKEND_TYPE(CPU, Synapses);
+
+namespace Backend {
+  namespace CPU {
+    void Synapses::prepare() {
+      pool = thread_pool(context);
+    }
+
+    void Synapses::reset_state() {
+    }
+
+    void Synapses::copy_to_frontend() {
+    }
+
+    void Synapses::copy_to_backend() {
+    }
+
+  } // namespace CPU
+} // namespace Backend
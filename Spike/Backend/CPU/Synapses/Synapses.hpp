@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Spike/Synapses/Synapses.hpp"
+#include "Spike/Backend/CPU/CPUBackend.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class Synapses : public virtual ::Backend::Synapses {
+    public:
+      ~Synapses() override = default;
+      using ::Backend::Synapses::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      // The CPU backend works directly upon the frontend arrays
+      void copy_to_frontend() override;
+      void copy_to_backend() override;
+
+      std::shared_ptr<ThreadPool> pool;
+    };
+  } // namespace CPU
+} // namespace Backend
@@ -0,0 +1,15 @@
+#include "VoltageSpikingSynapses.hpp"
+
+SPIKE_EXPORT_BACKEND_TYPE(CPU, VoltageSpikingSynapses);
+
+namespace Backend {
+  namespace CPU {
+    void VoltageSpikingSynapses::prepare() {
+      SpikingSynapses::prepare();
+    }
+
+    void VoltageSpikingSynapses::reset_state() {
+      SpikingSynapses::reset_state();
+    }
+  }
+}
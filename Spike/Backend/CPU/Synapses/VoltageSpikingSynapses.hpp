@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Spike/Synapses/VoltageSpikingSynapses.hpp"
+#include "SpikingSynapses.hpp"
+
+namespace Backend {
+  namespace CPU {
+    class VoltageSpikingSynapses : public virtual ::Backend::CPU::SpikingSynapses,
+                                   public virtual ::Backend::VoltageSpikingSynapses {
+    public:
+      SPIKE_MAKE_BACKEND_CONSTRUCTOR(VoltageSpikingSynapses);
+      using ::Backend::VoltageSpikingSynapses::frontend;
+
+      void prepare() override;
+      void reset_state() override;
+
+      float input_injection(float multiplication_to_volts,
+                            float current_membrane_voltage,
+                            unsigned int current_time_in_timesteps,
+                            float timestep,
+                            int idx,
+                            int g) override final {
+        int num_syn_labels = frontend()->num_syn_labels;
+        float* inputs = &circular_input_buffer[((current_time_in_timesteps + g) % buffersize)*input_buffersize + idx*num_syn_labels];
+
+        float total_current = 0.0f;
+        for (int syn_label = 0; syn_label < num_syn_labels; syn_label++){
+          total_current += inputs[syn_label];
+          inputs[syn_label] = 0.0f;
+        }
+        // This is already in volts, no conversion necessary
+        return total_current;
+      }
+    };
+  }
+}
@@ -11,6 +11,8 @@ namespace Backend {
     GeneratorInputSpikingNeurons::~GeneratorInputSpikingNeurons() {
       CudaSafeCall(cudaFree(neuron_ids_for_stimulus));
       CudaSafeCall(cudaFree(spike_times_for_stimulus));
+      CudaSafeCall(cudaFree(streamed_neuron_ids));
+      CudaSafeCall(cudaFree(streamed_spike_times));
     }
     
     // Allocate device pointers for the longest stimulus so that they do not need to be replaced
@@ -30,6 +32,11 @@ namespace Backend {
     }
     
     void GeneratorInputSpikingNeurons::setup_stimulus() {
+      first_spike_not_yet_past = 0;
+      num_spikes_in_current_stimulus = frontend()->number_of_spikes_in_stimuli[frontend()->current_stimulus_index];
+      // Streamed stimuli are copied to the device a timestep group at a time
+      if (frontend()->stimulus_is_streamed(frontend()->current_stimulus_index))
+        return;
       CudaSafeCall(cudaMemcpy(neuron_ids_for_stimulus,
                               frontend()->neuron_id_matrix_for_stimuli[frontend()->current_stimulus_index],
                               sizeof(int)*frontend()->number_of_spikes_in_stimuli[frontend()->current_stimulus_index],
@@ -38,7 +45,6 @@ namespace Backend {
                               frontend()->spike_times_matrix_for_stimuli[frontend()->current_stimulus_index],
                               sizeof(float)*frontend()->number_of_spikes_in_stimuli[frontend()->current_stimulus_index],
                               cudaMemcpyHostToDevice));
-      num_spikes_in_current_stimulus = frontend()->number_of_spikes_in_stimuli[frontend()->current_stimulus_index];
     }
 
 
@@ -53,22 +59,47 @@ namespace Backend {
            frontend()->total_number_of_neurons);
         CudaCheckError();
 
-        check_for_generator_spikes_kernel<<<number_of_neuron_blocks_per_grid, threads_per_block>>>(
-           synapses_backend->host_syn_activation_kernel,
-           synapses_backend->d_synaptic_data,
-           d_neuron_data,
-           neuron_ids_for_stimulus,
-           spike_times_for_stimulus,
-           last_spike_time_of_each_neuron,
-           current_time_in_timesteps*timestep,
-           frontend()->stimulus_onset_adjustment,
-           timestep,
-           current_time_in_timesteps,
-           frontend()->model->timestep_grouping,
-           frontend()->total_number_of_neurons,
-           num_spikes_in_current_stimulus);
+        // The cursor is kept on the host (the stimulus is sorted by time), so
+        // the kernel is only given the spikes which are due in these timesteps
+        int number_of_spikes_due = 0;
+        const int* host_neuron_ids_due = nullptr;
+        const float* host_spike_times_due = nullptr;
+        if (num_spikes_in_current_stimulus > 0)
+          number_of_spikes_due = frontend()->spikes_due(current_time_in_timesteps, timestep, first_spike_not_yet_past,
+                                                        host_neuron_ids_due, host_spike_times_due);
+        if (number_of_spikes_due > 0){
+          int* neuron_ids_due = neuron_ids_for_stimulus + first_spike_not_yet_past;
+          float* spike_times_due = spike_times_for_stimulus + first_spike_not_yet_past;
+          if (frontend()->stimulus_is_streamed(frontend()->current_stimulus_index)){
+            if (number_of_spikes_due > streamed_buffer_length){
+              streamed_buffer_length = number_of_spikes_due;
+              CudaSafeCall(cudaFree(streamed_neuron_ids));
+              CudaSafeCall(cudaFree(streamed_spike_times));
+              CudaSafeCall(cudaMalloc((void **)&streamed_neuron_ids, sizeof(int)*streamed_buffer_length));
+              CudaSafeCall(cudaMalloc((void **)&streamed_spike_times, sizeof(float)*streamed_buffer_length));
+            }
+            CudaSafeCall(cudaMemcpy(streamed_neuron_ids, host_neuron_ids_due, sizeof(int)*number_of_spikes_due, cudaMemcpyHostToDevice));
+            CudaSafeCall(cudaMemcpy(streamed_spike_times, host_spike_times_due, sizeof(float)*number_of_spikes_due, cudaMemcpyHostToDevice));
+            neuron_ids_due = streamed_neuron_ids;
+            spike_times_due = streamed_spike_times;
+          }
+          check_for_generator_spikes_kernel<<<number_of_neuron_blocks_per_grid, threads_per_block>>>(
+             synapses_backend->host_syn_activation_kernel,
+             synapses_backend->d_synaptic_data,
+             d_neuron_data,
+             neuron_ids_due,
+             spike_times_due,
+             last_spike_time_of_each_neuron,
+             current_time_in_timesteps*timestep,
+             frontend()->stimulus_onset_adjustment,
+             timestep,
+             current_time_in_timesteps,
+             frontend()->model->timestep_grouping,
+             frontend()->total_number_of_neurons,
+             number_of_spikes_due);
 
-        CudaCheckError();
+          CudaCheckError();
+        }
       }
     }
 
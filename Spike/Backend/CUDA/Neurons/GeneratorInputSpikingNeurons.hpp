@@ -28,6 +28,12 @@ namespace Backend {
       int* neuron_ids_for_stimulus = nullptr;
       float* spike_times_for_stimulus = nullptr;
       int num_spikes_in_current_stimulus = 0;
+      // Cursor into the (time sorted) stimulus, see spikes_due
+      int first_spike_not_yet_past = 0;
+      // Spikes of a streamed stimulus which are due, copied each timestep group
+      int* streamed_neuron_ids = nullptr;
+      float* streamed_spike_times = nullptr;
+      int streamed_buffer_length = 0;
 
       void allocate_device_pointers(); // Not virtual
 
@@ -1,5 +1,6 @@
 // -*- mode: c++ -*-
 #include "Spike/Backend/CUDA/Plasticity/STDPPlasticity.hpp"
+#include "Spike/Helpers/TerminalHelpers.hpp"
 #include <iostream>
 
 // SPIKE_EXPORT_BACKEND_TYPE(CUDA, STDPPlasticity);
@@ -11,6 +12,9 @@ namespace Backend {
     }
 
     void STDPPlasticity::prepare() {
+      // The CUDA kernels always update every plastic synapse
+      if (frontend()->event_driven)
+        print_message_and_exit("Error: Event-driven STDP (event_driven) is only supported by the CPU backend.");
 
       input_neurons_backend = dynamic_cast<::Backend::CUDA::SpikingNeurons*>
         (frontend()->model->input_spiking_neurons->backend());
@@ -1,5 +1,6 @@
 // -*- mode: c++ -*-
 #include "Spike/Backend/CUDA/Plasticity/WeightDependentSTDPPlasticity.hpp"
+#include "Spike/Helpers/TerminalHelpers.hpp"
 
 SPIKE_EXPORT_BACKEND_TYPE(CUDA, WeightDependentSTDPPlasticity);
 
@@ -27,6 +28,9 @@ namespace Backend {
 
     void WeightDependentSTDPPlasticity::prepare() {
       STDPPlasticity::prepare();
+      // The CUDA kernels keep a trace per synapse only
+      if (frontend()->stdp_params->per_neuron_traces)
+        print_message_and_exit("Error: Per-neuron STDP traces (per_neuron_traces) are only supported by the CPU backend.");
       allocate_device_pointers();
     }
 
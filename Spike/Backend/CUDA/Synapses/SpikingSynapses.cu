@@ -1,5 +1,6 @@
 // -*- mode: c++ -*-
 #include "Spike/Backend/CUDA/Synapses/SpikingSynapses.hpp"
+#include "Spike/Helpers/TerminalHelpers.hpp"
 
 SPIKE_EXPORT_BACKEND_TYPE(CUDA, SpikingSynapses);
 
@@ -43,6 +44,13 @@ namespace Backend {
 
     void SpikingSynapses::prepare() {
       Synapses::prepare();
+
+      if (frontend()->dense_groups.size() > 0)
+        print_message_and_exit("Error: All-to-all synapse groups stored as weight matrices are only supported by the CPU backend (unset all_to_all_weight_matrix in their parameters).");
+      if (frontend()->convolutional_groups.size() > 0)
+        print_message_and_exit("Error: Convolutional synapse groups are only supported by the CPU backend.");
+      if (frontend()->procedural_groups.size() > 0)
+        print_message_and_exit("Error: Procedural synapse groups are only supported by the CPU backend.");
      
       // Extra buffer size for current time and extra to reset before last
       buffersize = frontend()->maximum_axonal_delay_in_timesteps + 2*frontend()->model->timestep_grouping + 1;
@@ -9,6 +9,8 @@ struct DeviceParameters {
   int threads_per_block_neurons = 32;
   int threads_per_block_synapses = 32;
   int maximum_axonal_delay_in_timesteps = 0;
+  // Worker threads used by the CPU backend (0 = all hardware threads)
+  int threads = 0;
 };
 
 struct Context {
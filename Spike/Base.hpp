@@ -17,4 +17,8 @@ public:
 
   virtual void prepare_backend_early() {}
   virtual void prepare_backend_late() {}
+
+  // Frontend state for checkpoints, alongside that of the backend
+  virtual void save_state(CheckpointWriter& checkpoint, const std::string& prefix) {}
+  virtual void load_state(const CheckpointReader& checkpoint, const std::string& prefix) {}
 };
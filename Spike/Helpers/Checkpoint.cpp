@@ -0,0 +1,132 @@
+#include "Checkpoint.hpp"
+#include "TerminalHelpers.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char checkpoint_magic[8] = {'S','P','K','C','H','K','P','T'};
+static const uint32_t checkpoint_version = 1;
+static const uint64_t checkpoint_alignment = 64;
+static const uint64_t checkpoint_header_size = 8 + 2*sizeof(uint32_t) + sizeof(uint64_t);
+
+CheckpointWriter::CheckpointWriter(std::string filename_parameter) {
+  filename = filename_parameter;
+  file.open(filename, std::ios::out | std::ios::binary);
+  if (!file.is_open())
+    print_message_and_exit(("Could not open checkpoint " + filename + " for writing.").c_str());
+  // The header is completed by close()
+  std::vector<char> header(checkpoint_header_size, 0);
+  file.write(header.data(), header.size());
+  offset = checkpoint_header_size;
+}
+
+CheckpointWriter::~CheckpointWriter() {
+  close();
+}
+
+void CheckpointWriter::write(const std::string& name, const void* data, size_t bytes) {
+  static const char padding[checkpoint_alignment] = {0};
+  uint64_t aligned_offset = ((offset + checkpoint_alignment - 1) / checkpoint_alignment) * checkpoint_alignment;
+  file.write(padding, aligned_offset - offset);
+  file.write((const char*)data, bytes);
+  sections.push_back({name, aligned_offset, bytes});
+  offset = aligned_offset + bytes;
+}
+
+void CheckpointWriter::close() {
+  if (closed)
+    return;
+  closed = true;
+
+  uint64_t table_offset = offset;
+  for (auto& entry : sections){
+    uint32_t name_length = entry.name.size();
+    file.write((const char*)&name_length, sizeof(name_length));
+    file.write(entry.name.data(), name_length);
+    file.write((const char*)&entry.offset, sizeof(entry.offset));
+    file.write((const char*)&entry.bytes, sizeof(entry.bytes));
+  }
+
+  uint32_t number_of_sections = sections.size();
+  file.seekp(0);
+  file.write(checkpoint_magic, 8);
+  file.write((const char*)&checkpoint_version, sizeof(checkpoint_version));
+  file.write((const char*)&number_of_sections, sizeof(number_of_sections));
+  file.write((const char*)&table_offset, sizeof(table_offset));
+  file.close();
+  if (!file)
+    print_message_and_exit(("Failed writing checkpoint " + filename + ".").c_str());
+}
+
+
+CheckpointReader::CheckpointReader(std::string filename_parameter) {
+  filename = filename_parameter;
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat file_status;
+  if ((fd < 0) || (fstat(fd, &file_status) != 0))
+    print_message_and_exit(("Could not open checkpoint " + filename + ".").c_str());
+  mapped_bytes = file_status.st_size;
+  if (mapped_bytes < checkpoint_header_size)
+    print_message_and_exit((filename + " is not a Spike checkpoint.").c_str());
+  void* mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+    print_message_and_exit(("Could not map checkpoint " + filename + ".").c_str());
+  size_t length = mapped_bytes;
+  mapped_file = std::shared_ptr<void>(mapping, [length](void* address){ munmap(address, length); });
+  mapped = (const unsigned char*)mapping;
+
+  uint32_t version, number_of_sections;
+  uint64_t table_offset;
+  memcpy(&version, mapped + 8, sizeof(version));
+  memcpy(&number_of_sections, mapped + 8 + sizeof(uint32_t), sizeof(number_of_sections));
+  memcpy(&table_offset, mapped + 8 + 2*sizeof(uint32_t), sizeof(table_offset));
+  if (memcmp(mapped, checkpoint_magic, 8) != 0)
+    print_message_and_exit((filename + " is not a Spike checkpoint.").c_str());
+  if (version != checkpoint_version)
+    print_message_and_exit(("Unsupported checkpoint version in " + filename + ".").c_str());
+
+  uint64_t position = table_offset;
+  for (uint32_t s = 0; s < number_of_sections; s++){
+    uint32_t name_length;
+    if (position + sizeof(name_length) > mapped_bytes)
+      print_message_and_exit(("Corrupt checkpoint " + filename + ".").c_str());
+    memcpy(&name_length, mapped + position, sizeof(name_length));
+    position += sizeof(name_length);
+    if (position + name_length + 2*sizeof(uint64_t) > mapped_bytes)
+      print_message_and_exit(("Corrupt checkpoint " + filename + ".").c_str());
+    std::string name((const char*)mapped + position, name_length);
+    position += name_length;
+    section entry;
+    memcpy(&entry.offset, mapped + position, sizeof(uint64_t));
+    memcpy(&entry.bytes, mapped + position + sizeof(uint64_t), sizeof(uint64_t));
+    position += 2*sizeof(uint64_t);
+    if (entry.offset + entry.bytes > table_offset)
+      print_message_and_exit(("Corrupt checkpoint " + filename + ".").c_str());
+    sections[name] = entry;
+  }
+}
+
+bool CheckpointReader::has(const std::string& name) const {
+  return sections.count(name) > 0;
+}
+
+const void* CheckpointReader::data(const std::string& name, size_t& bytes) const {
+  auto entry = sections.find(name);
+  if (entry == sections.end())
+    print_message_and_exit(("Checkpoint " + filename + " has no " + name + " section.").c_str());
+  bytes = entry->second.bytes;
+  return mapped + entry->second.offset;
+}
+
+void CheckpointReader::read(const std::string& name, void* destination, size_t bytes) const {
+  size_t section_bytes;
+  const void* section_data = data(name, section_bytes);
+  if (section_bytes != bytes)
+    print_message_and_exit(("Checkpoint section " + name + " does not match the model (wrong size).").c_str());
+  if (bytes > 0)
+    memcpy(destination, section_data, bytes);
+}
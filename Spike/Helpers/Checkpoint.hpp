@@ -0,0 +1,102 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <vector>
+
+/**
+ * Checkpoint files (see SpikingModel::save_checkpoint).
+ *
+ * A checkpoint is a set of named byte sections. Every section starts on a 64
+ * byte boundary and a table of sections is written at the end of the file, so
+ * a checkpoint can be memory-mapped and its arrays read in place.
+ * The mapping is private (copy-on-write), so arrays used in place may be
+ * modified without changing the file.
+ *
+ * Layout (little endian):
+ *   header: "SPKCHKPT", uint32 version, uint32 number_of_sections, uint64 table_offset
+ *   sections
+ *   table:  per section {uint32 name_length, name, uint64 offset, uint64 bytes}
+ */
+
+class CheckpointWriter {
+public:
+  CheckpointWriter(std::string filename);
+  ~CheckpointWriter();
+
+  void write(const std::string& name, const void* data, size_t bytes);
+  template <typename T>
+  void write_vector(const std::string& name, const std::vector<T>& values) {
+    write(name, values.data(), values.size()*sizeof(T));
+  }
+  template <typename T>
+  void write_value(const std::string& name, const T& value) {
+    write(name, &value, sizeof(T));
+  }
+
+  // Writes the table of sections
+  void close();
+
+private:
+  std::ofstream file;
+  std::string filename;
+  uint64_t offset = 0;
+  bool closed = false;
+  struct section {
+    std::string name;
+    uint64_t offset;
+    uint64_t bytes;
+  };
+  std::vector<section> sections;
+};
+
+
+class CheckpointReader {
+public:
+  CheckpointReader(std::string filename);
+
+  bool has(const std::string& name) const;
+  // Pointer into the mapped file, exits if there is no such section
+  const void* data(const std::string& name, size_t& bytes) const;
+
+  // Keeps the mapped file alive, for arrays which are used in place
+  std::shared_ptr<void> mapping() const { return mapped_file; }
+
+  // Copies a section of exactly bytes bytes
+  void read(const std::string& name, void* destination, size_t bytes) const;
+  template <typename T>
+  void read_vector(const std::string& name, std::vector<T>& values) const {
+    size_t bytes;
+    const T* section_data = (const T*)data(name, bytes);
+    values.assign(section_data, section_data + bytes/sizeof(T));
+  }
+  // As read_vector, but the vector must already have the saved length
+  template <typename T>
+  void read_vector_of_same_size(const std::string& name, std::vector<T>& values) const {
+    read(name, values.data(), values.size()*sizeof(T));
+  }
+  template <typename T>
+  T read_value(const std::string& name) const {
+    T value;
+    read(name, &value, sizeof(T));
+    return value;
+  }
+
+private:
+  std::string filename;
+  std::shared_ptr<void> mapped_file;
+  const unsigned char* mapped = nullptr;
+  size_t mapped_bytes = 0;
+  struct section {
+    uint64_t offset;
+    uint64_t bytes;
+  };
+  std::map<std::string, section> sections;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 64 bit FNV-1a hash of a sequence of values, used to name cached
+ * construction results (see SpikingModel::SetConnectivityCache).
+ * Values are hashed by their bytes, so floats and doubles must be bit-equal
+ * to give the same hash.
+ */
+class ContentHash {
+public:
+  uint64_t value = 14695981039346656037ULL;
+
+  void add(const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < bytes; i++){
+      value ^= p[i];
+      value *= 1099511628211ULL;
+    }
+  }
+  template <typename T>
+  void add_value(const T& v) {
+    add(&v, sizeof(T));
+  }
+  // The length is hashed too, so that consecutive vectors cannot alias
+  template <typename T>
+  void add_vector(const std::vector<T>& values) {
+    add_value((uint64_t)values.size());
+    add(values.data(), values.size()*sizeof(T));
+  }
+  void add_string(const std::string& s) {
+    add_value((uint64_t)s.size());
+    add(s.data(), s.size());
+  }
+};
+
+#endif
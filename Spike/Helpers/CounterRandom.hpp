@@ -0,0 +1,111 @@
+#ifndef COUNTERRANDOM_H
+#define COUNTERRANDOM_H
+
+#include <stdint.h>
+
+#ifdef __CUDACC__
+#define SPIKE_HOST_DEVICE __host__ __device__
+#else
+#define SPIKE_HOST_DEVICE
+#endif
+
+/**
+ * Counter-based random numbers (Philox4x32-10, Salmon et al. 2011,
+ * "Parallel random numbers: as easy as 1, 2, 3").
+ *
+ * The n-th number of a stream is a function of (seed, purpose, stream, n)
+ * alone, so numbers can be drawn in any order, by any thread, on the host or
+ * on the device, and a network comes out the same whatever the parallelism.
+ * Streams are usually numbered by the object they belong to (a synapse
+ * group, a synapse, a neuron) and the purpose keeps streams used for
+ * different things (e.g. the weights and the delays of a synapse) apart.
+ * Network construction and the CPU backend draw from these streams. The
+ * CUDA Poisson inputs still draw from their curand states.
+ */
+
+enum random_stream_purpose : uint32_t {
+  RANDOM_STREAM_CONNECTIVITY = 1,
+  RANDOM_STREAM_WEIGHTS,
+  RANDOM_STREAM_DELAYS,
+  RANDOM_STREAM_MEMBRANE_POTENTIALS,
+  RANDOM_STREAM_POISSON_INPUT
+};
+
+// Philox4x32-10, in place on counter
+SPIKE_HOST_DEVICE inline void philox4x32_10(uint32_t counter[4], uint32_t key0, uint32_t key1) {
+  for (int round = 0; round < 10; round++){
+    uint64_t product0 = (uint64_t)0xD2511F53u * counter[0];
+    uint64_t product1 = (uint64_t)0xCD9E8D57u * counter[2];
+    uint32_t c0 = (uint32_t)(product1 >> 32) ^ counter[1] ^ key0;
+    uint32_t c1 = (uint32_t)product1;
+    uint32_t c2 = (uint32_t)(product0 >> 32) ^ counter[3] ^ key1;
+    uint32_t c3 = (uint32_t)product0;
+    counter[0] = c0; counter[1] = c1; counter[2] = c2; counter[3] = c3;
+    key0 += 0x9E3779B9u;
+    key1 += 0xBB67AE85u;
+  }
+}
+
+class CounterRandom {
+public:
+  // A UniformRandomBitGenerator, so it can drive the <random> distributions
+  typedef uint32_t result_type;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+  uint32_t seed = 0;
+  uint32_t purpose = 0;
+  uint64_t stream = 0;
+  uint64_t position = 0;  /**< The number of numbers drawn so far */
+
+  SPIKE_HOST_DEVICE CounterRandom() {}
+  SPIKE_HOST_DEVICE CounterRandom(uint32_t seed_parameter, uint32_t purpose_parameter, uint64_t stream_parameter, uint64_t position_parameter = 0)
+    : seed(seed_parameter), purpose(purpose_parameter), stream(stream_parameter), position(position_parameter) {}
+
+  SPIKE_HOST_DEVICE result_type operator()() {
+    // Every block of the counter gives four numbers
+    uint64_t block = position >> 2;
+    if ((block != cached_block) || !cached){
+      generate_block(block, numbers);
+      cached_block = block;
+      cached = true;
+    }
+    return numbers[(position++) & 3];
+  }
+  // The n-th number of the stream, without drawing it
+  SPIKE_HOST_DEVICE result_type number_at(uint64_t n) const {
+    uint32_t block_numbers[4];
+    generate_block(n >> 2, block_numbers);
+    return block_numbers[n & 3];
+  }
+
+  // Uniform on (0, 1], like curand_uniform, so its log is finite
+  SPIKE_HOST_DEVICE float uniform_float() {
+    return (((*this)() >> 8) + 1) * (1.0f / 16777216.0f);
+  }
+  // The n-th number of the stream as uniform_float() would give it
+  SPIKE_HOST_DEVICE float uniform_float_at(uint64_t n) const {
+    return ((number_at(n) >> 8) + 1) * (1.0f / 16777216.0f);
+  }
+  // Uniform on (0, 1] with 53 bits, from two numbers
+  SPIKE_HOST_DEVICE double uniform_double() {
+    uint64_t high = (*this)() >> 5;
+    uint64_t low = (*this)() >> 6;
+    return ((high << 26) + low + 1) * (1.0 / 9007199254740992.0);
+  }
+
+private:
+  uint32_t numbers[4];
+  uint64_t cached_block = 0;
+  bool cached = false;
+
+  SPIKE_HOST_DEVICE void generate_block(uint64_t block, uint32_t block_numbers[4]) const {
+    block_numbers[0] = (uint32_t)block;
+    block_numbers[1] = (uint32_t)(block >> 32);
+    block_numbers[2] = (uint32_t)stream;
+    block_numbers[3] = (uint32_t)(stream >> 32);
+    philox4x32_10(block_numbers, seed, purpose);
+  }
+};
+
+#endif
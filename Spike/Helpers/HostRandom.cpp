@@ -0,0 +1,19 @@
+#include "HostRandom.hpp"
+
+static unsigned int seed_of_host_random = 1;
+
+void seed_host_random(unsigned int seed) {
+  seed_of_host_random = seed;
+}
+
+unsigned int host_random_seed() {
+  return seed_of_host_random;
+}
+
+CounterRandom host_random_stream(random_stream_purpose purpose, uint64_t stream) {
+  return CounterRandom(seed_of_host_random, purpose, stream);
+}
+
+CounterRandom host_random_stream(random_stream_purpose purpose, uint32_t first_index, uint32_t second_index) {
+  return CounterRandom(seed_of_host_random, purpose, ((uint64_t)first_index << 32) | second_index);
+}
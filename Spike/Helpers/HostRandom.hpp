@@ -0,0 +1,24 @@
+#ifndef HOSTRANDOM_H
+#define HOSTRANDOM_H
+
+#include "CounterRandom.hpp"
+
+/**
+ * The random streams used by network construction (connectivity, synapse
+ * weights and delays, initial membrane potentials).
+ *
+ * Every stream is a CounterRandom keyed by the construction seed (set by the
+ * Synapses constructor) and by what it is drawn for, such as the synapse
+ * group and synapse index. Construction results therefore depend on the seed
+ * and the network only, not on the order in which things are drawn or on the
+ * number of threads drawing them.
+ */
+
+void seed_host_random(unsigned int seed);
+unsigned int host_random_seed();
+
+CounterRandom host_random_stream(random_stream_purpose purpose, uint64_t stream);
+// For streams numbered by two indices, e.g. (synapse group, synapse)
+CounterRandom host_random_stream(random_stream_purpose purpose, uint32_t first_index, uint32_t second_index);
+
+#endif
@@ -0,0 +1,40 @@
+#include "Parallel.hpp"
+#include "Spike/Backend/Context.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int construction_thread_count() {
+  int number_of_threads = _global_ctx ? _global_ctx->params.threads : 0;
+  if (number_of_threads <= 0)
+    number_of_threads = std::thread::hardware_concurrency();
+  if (number_of_threads <= 0)
+    number_of_threads = 1;
+  return number_of_threads;
+}
+
+void parallel_for_blocks(int number_of_blocks, const std::function<void(int)>& fn) {
+  int number_of_threads = construction_thread_count();
+  if (number_of_threads > number_of_blocks)
+    number_of_threads = number_of_blocks;
+
+  if (number_of_threads <= 1) {
+    for (int block = 0; block < number_of_blocks; block++)
+      fn(block);
+    return;
+  }
+
+  std::atomic<int> next_block(0);
+  auto worker = [&]() {
+    for (int block = next_block++; block < number_of_blocks; block = next_block++)
+      fn(block);
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < number_of_threads; t++)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads)
+    thread.join();
+}
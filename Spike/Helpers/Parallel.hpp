@@ -0,0 +1,21 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+/**
+ * Threading helpers for the (frontend) network construction code.
+ *
+ * Work is described as a fixed number of blocks whose size does not depend
+ * upon the number of threads. Any randomness used by a block should be seeded
+ * from the block index alone, so that results are identical however the
+ * blocks happen to be scheduled.
+ */
+
+// Number of threads used for construction (Context::params.threads, 0 = all hardware threads)
+int construction_thread_count();
+
+// Calls fn(block) once for every block in [0, number_of_blocks)
+void parallel_for_blocks(int number_of_blocks, const std::function<void(int)>& fn);
+
+#endif
@@ -0,0 +1,84 @@
+#include "StepProfiler.hpp"
+#include "TerminalHelpers.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+void StepProfiler::reset() {
+  for (auto& stage_time : stages)
+    stage_time.seconds = 0.0;
+  number_of_steps = 0;
+  number_of_timesteps = 0;
+  wall_seconds = 0.0;
+  presynaptic_spikes = 0;
+  synaptic_events = 0;
+  maximum_synaptic_events_in_a_step = 0;
+  active_synapses = 0;
+  maximum_active_synapses_in_a_step = 0;
+}
+
+int StepProfiler::stage(const std::string& name) {
+  for (int s = 0; s < (int)stages.size(); s++)
+    if (stages[s].name == name)
+      return s;
+  stage_time new_stage;
+  new_stage.name = name;
+  stages.push_back(new_stage);
+  return stages.size() - 1;
+}
+
+void StepProfiler::print_summary() const {
+  double steps = (number_of_steps > 0) ? number_of_steps : 1;
+  printf("Profile of %lld steps (%lld timesteps), %f s wall time:\n", number_of_steps, number_of_timesteps, wall_seconds);
+  for (const auto& stage_time : stages)
+    printf("  %-32s %12.6f s %10.3f us/step %6.2f%%\n",
+           stage_time.name.c_str(),
+           stage_time.seconds,
+           1.0e6*stage_time.seconds / steps,
+           (wall_seconds > 0.0) ? 100.0*stage_time.seconds / wall_seconds : 0.0);
+  printf("  %lld presynaptic spikes (%f per step), %lld synaptic events (%f per step, at most %lld)\n",
+         presynaptic_spikes, presynaptic_spikes / steps,
+         synaptic_events, synaptic_events / steps, maximum_synaptic_events_in_a_step);
+  printf("  %lld active plastic synapses (%f per step, at most %lld)\n",
+         active_synapses, active_synapses / steps, maximum_active_synapses_in_a_step);
+  if (wall_seconds > 0.0)
+    printf("  %f synaptic events per second of wall time\n", synaptic_events / wall_seconds);
+}
+
+std::string StepProfiler::as_json() const {
+  double steps = (number_of_steps > 0) ? number_of_steps : 1;
+  std::ostringstream json;
+  json.precision(9);
+  json << "{\n";
+  json << "  \"steps\": " << number_of_steps << ",\n";
+  json << "  \"timesteps\": " << number_of_timesteps << ",\n";
+  json << "  \"timestep\": " << timestep << ",\n";
+  json << "  \"simulated_seconds\": " << number_of_timesteps*(double)timestep << ",\n";
+  json << "  \"wall_seconds\": " << wall_seconds << ",\n";
+  json << "  \"stages\": [";
+  for (int s = 0; s < (int)stages.size(); s++){
+    json << ((s > 0) ? ",\n" : "\n");
+    // Stage names are made by SpikingModel and need no escaping
+    json << "    {\"name\": \"" << stages[s].name << "\", "
+         << "\"seconds\": " << stages[s].seconds << ", "
+         << "\"microseconds_per_step\": " << 1.0e6*stages[s].seconds / steps << "}";
+  }
+  json << "\n  ],\n";
+  json << "  \"presynaptic_spikes\": " << presynaptic_spikes << ",\n";
+  json << "  \"synaptic_events\": " << synaptic_events << ",\n";
+  json << "  \"synaptic_events_per_step\": " << synaptic_events / steps << ",\n";
+  json << "  \"maximum_synaptic_events_in_a_step\": " << maximum_synaptic_events_in_a_step << ",\n";
+  json << "  \"active_synapses\": " << active_synapses << ",\n";
+  json << "  \"active_synapses_per_step\": " << active_synapses / steps << ",\n";
+  json << "  \"maximum_active_synapses_in_a_step\": " << maximum_active_synapses_in_a_step << "\n";
+  json << "}\n";
+  return json.str();
+}
+
+void StepProfiler::save_as_json(std::string filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open())
+    print_message_and_exit(("Could not open " + filename + " to save the profile.").c_str());
+  file << as_json();
+}
@@ -0,0 +1,64 @@
+#ifndef STEPPROFILER_H
+#define STEPPROFILER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * Wall clock (steady_clock) time of each stage of the simulation loop, with
+ * counts of the activity in it (see SpikingModel::enable_profiling).
+ *
+ * The stages are those of SpikingModel's step plan plus "host copies" (the
+ * monitors' final updates, which bring their data back to the host). Times
+ * are of the calls from the host: with the CUDA backend, a stage whose kernels
+ * are still running when the next stage starts is partly counted against that
+ * stage.
+ */
+class StepProfiler {
+public:
+  typedef std::chrono::steady_clock clock;
+
+  struct stage_time {
+    std::string name;
+    double seconds = 0.0;
+  };
+  std::vector<stage_time> stages;
+
+  long long number_of_steps = 0;
+  long long number_of_timesteps = 0;
+  float timestep = 0.0f;
+  double wall_seconds = 0.0;                  /**< Of the whole run, profiling included */
+
+  // From the synapse backend, zero where it does not count them (CUDA)
+  long long presynaptic_spikes = 0;           /**< Spikes of neurons with efferent synapses */
+  long long synaptic_events = 0;
+  long long maximum_synaptic_events_in_a_step = 0;
+  // From the plasticity backends, in steps with plasticity on
+  long long active_synapses = 0;              /**< Plastic synapses updated, summed over the rules */
+  long long maximum_active_synapses_in_a_step = 0;
+
+  // Forgets everything but the stages, whose times are zeroed
+  void reset();
+  // Returns the index of the stage named name, adding it if necessary
+  int stage(const std::string& name);
+
+  inline void add_time(int stage_index, clock::time_point start, clock::time_point end) {
+    stages[stage_index].seconds += std::chrono::duration<double>(end - start).count();
+  }
+  inline void add_step_activity(long long spikes, long long events, long long active) {
+    presynaptic_spikes += spikes;
+    synaptic_events += events;
+    if (events > maximum_synaptic_events_in_a_step)
+      maximum_synaptic_events_in_a_step = events;
+    active_synapses += active;
+    if (active > maximum_active_synapses_in_a_step)
+      maximum_active_synapses_in_a_step = active;
+  }
+
+  void print_summary() const;
+  std::string as_json() const;
+  void save_as_json(std::string filename) const;
+};
+
+#endif
@@ -4,19 +4,19 @@
 
 // TimerWithMessages Constructor
 TimerWithMessages::TimerWithMessages(const char * start_message) {
-  clock_start = clock();
+  clock_start = std::chrono::steady_clock::now();
   printf("%s", start_message);
 }
 
 TimerWithMessages::TimerWithMessages() {
-  clock_start = clock();
+  clock_start = std::chrono::steady_clock::now();
 }
 
 void TimerWithMessages::stop_timer_and_log_time_and_message(const char * end_message, bool print_line_of_dashes) {
 
-  clock_t clock_end = clock();
+  std::chrono::steady_clock::time_point clock_end = std::chrono::steady_clock::now();
 
-  float time_elapsed = float(clock_end - clock_start) / CLOCKS_PER_SEC;
+  float time_elapsed = std::chrono::duration<float>(clock_end - clock_start).count();
 
   printf("%s Time taken: %f\n", end_message, time_elapsed);
 
@@ -1,7 +1,7 @@
 #ifndef TIMERWITHMESSAGES_H
 #define TIMERWITHMESSAGES_H
 
-#include <time.h>
+#include <chrono>
 
 
 class TimerWithMessages {
@@ -12,7 +12,8 @@ public:
 	TimerWithMessages(const char * start_message);
 	TimerWithMessages();
 
-	clock_t clock_start;
+	// Wall time: clock() would count the CPU time of every thread
+	std::chrono::steady_clock::time_point clock_start;
 
 	void stop_timer_and_log_time_and_message(const char * end_message, bool print_line_of_dashes);
 	
@@ -2,7 +2,15 @@
 
 #include "../Neurons/InputSpikingNeurons.hpp"
 #include "Spike/Helpers/TerminalHelpers.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
 #include "Spike/Backend/Context.hpp"
+#include "Spike/Helpers/HostRandom.hpp"
+#include "Spike/Helpers/ContentHash.hpp"
+
+#include <cerrno>
+#include <typeinfo>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 // SpikingModel Constructor
@@ -45,6 +53,11 @@ int SpikingModel::AddSynapseGroup(int presynaptic_group_id,
               synapse_parameters_struct * synapse_params) {
   if (spiking_synapses == nullptr) print_message_and_exit("Please set synapse pointer before adding synapses.");
 
+  // Weight matrix, convolutional and procedural groups store no synapses, so are not cached
+  if (!connectivity_cache_directory.empty() && (synapse_params->connectivity_type != CONNECTIVITY_TYPE_CONVOLUTIONAL) && !synapse_params->procedural_connectivity &&
+      !spiking_synapses->stores_weight_matrix(timestep, synapse_params))
+    return add_synapse_group_through_cache(presynaptic_group_id, postsynaptic_group_id, synapse_params);
+
   int groupID = spiking_synapses->AddGroup(presynaptic_group_id, 
               postsynaptic_group_id, 
               spiking_neurons,
@@ -56,6 +69,106 @@ int SpikingModel::AddSynapseGroup(int presynaptic_group_id,
 }
 
 
+void SpikingModel::SetConnectivityCache(std::string directory) {
+  if (!directory.empty() && (mkdir(directory.c_str(), 0777) != 0) && (errno != EEXIST))
+    print_message_and_exit(("Could not create the connectivity cache directory " + directory + ".").c_str());
+  connectivity_cache_directory = directory;
+}
+
+
+static void add_neurons_to_hash(ContentHash& hash, Neurons* neurons) {
+  if (neurons == nullptr){
+    hash.add_value(-1);
+    return;
+  }
+  int n = neurons->total_number_of_neurons;
+  int groups = neurons->total_number_of_groups;
+  hash.add_value(n);
+  hash.add_value(groups);
+  hash.add(neurons->start_neuron_indices_for_each_group, groups*sizeof(int));
+  hash.add(neurons->last_neuron_indices_for_each_group, groups*sizeof(int));
+  for (int g = 0; g < groups; g++)
+    hash.add(neurons->group_shapes[g], 2*sizeof(int));
+  hash.add(neurons->per_neuron_afferent_synapse_count, n*sizeof(int));
+  hash.add(neurons->per_neuron_efferent_synapse_count, n*sizeof(int));
+  hash.add_value(neurons->max_num_efferent_synapses);
+}
+
+
+// The key covers everything that AddGroup reads: its parameters, the host
+// random seed and the group number (which key its random streams), the
+// neuron groups and the synapse and neuron counts left by earlier groups.
+uint64_t SpikingModel::connectivity_cache_key(int presynaptic_group_id,
+              int postsynaptic_group_id,
+              synapse_parameters_struct * synapse_params) {
+  const uint32_t connectivity_cache_version = 2;
+  ContentHash hash;
+  hash.add_value(connectivity_cache_version);
+  hash.add_string(typeid(*spiking_synapses).name());
+  SynapseStore& store = spiking_synapses->synapse_store;
+  hash.add_value(store.number_of_columns());
+  for (int c = 0; c < store.number_of_columns(); c++)
+    hash.add_value((uint64_t)store.column_element_size(c));
+
+  hash.add_value(host_random_seed());
+  hash.add_value((uint64_t)spiking_synapses->last_index_of_synapse_per_group.size());
+  hash.add_value(spiking_synapses->total_number_of_synapses);
+  hash.add_value(spiking_synapses->maximum_number_of_afferent_synapses);
+  hash.add_value(spiking_synapses->largest_synapse_group_size);
+  add_neurons_to_hash(hash, spiking_neurons);
+  add_neurons_to_hash(hash, input_spiking_neurons);
+
+  spiking_synapses->add_group_parameters_to_hash(hash, presynaptic_group_id, postsynaptic_group_id, timestep, synapse_params);
+  return hash.value;
+}
+
+
+int SpikingModel::add_synapse_group_through_cache(int presynaptic_group_id,
+              int postsynaptic_group_id,
+              synapse_parameters_struct * synapse_params) {
+  char key[17];
+  snprintf(key, sizeof(key), "%016llx", (unsigned long long)connectivity_cache_key(presynaptic_group_id, postsynaptic_group_id, synapse_params));
+  std::string filename = connectivity_cache_directory + "/" + key + ".bin";
+
+  int groupID;
+  if (access(filename.c_str(), R_OK) == 0) {
+    CheckpointReader cache(filename);
+    spiking_synapses->cached_group = &cache;
+    groupID = spiking_synapses->AddGroup(presynaptic_group_id,
+                postsynaptic_group_id,
+                spiking_neurons,
+                input_spiking_neurons,
+                timestep,
+                synapse_params);
+    spiking_synapses->cached_group = nullptr;
+    return(groupID);
+  }
+
+  groupID = spiking_synapses->AddGroup(presynaptic_group_id,
+              postsynaptic_group_id,
+              spiking_neurons,
+              input_spiking_neurons,
+              timestep,
+              synapse_params);
+
+  // Written under a temporary name so that a concurrent or interrupted run never sees a partial entry
+  std::string temporary_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+  CheckpointWriter cache(temporary_filename);
+  spiking_synapses->save_last_group(cache, spiking_neurons, input_spiking_neurons);
+  cache.close();
+  if (rename(temporary_filename.c_str(), filename.c_str()) != 0)
+    print_message_and_exit(("Could not write the connectivity cache entry " + filename + ".").c_str());
+
+  return(groupID);
+}
+
+
+void SpikingModel::reserve(int number_of_synapses) {
+  if (spiking_synapses == nullptr) print_message_and_exit("Please set synapse pointer before reserving synapses.");
+  spiking_synapses->reserve(number_of_synapses);
+}
+
+
 void SpikingModel::AddSynapseGroupsForNeuronGroupAndEachInputGroup(int postsynaptic_group_id, 
               synapse_parameters_struct * synapse_params) {
 
@@ -110,6 +223,12 @@ void SpikingModel::finalise_model() {
       printf("  %d Neuron(s)\n", spiking_neurons->total_number_of_neurons);
     if (spiking_synapses->total_number_of_synapses > 0)
       printf("  %d Synapse(s)\n", spiking_synapses->total_number_of_synapses);
+    for (auto& group : spiking_synapses->dense_groups)
+      printf("  %lld Synapse(s) of group %d, as a %dx%d weight matrix\n", group.number_of_synapses(), group.group_id, group.number_of_presynaptic_neurons, group.number_of_postsynaptic_neurons);
+    for (auto& group : spiking_synapses->convolutional_groups)
+      printf("  %lld Convolutional Synapse(s) of group %d, with a %dx%d kernel\n", group.number_of_synapses(), group.group_id, group.kernel_shape[0], group.kernel_shape[1]);
+    for (auto& group : spiking_synapses->procedural_groups)
+      printf("  About %.0f Procedural Synapse(s) of group %d\n", group.expected_number_of_synapses(), group.group_id);
     if (plasticity_rule_vec.size() > 0)
       printf("  %d Plasticity Rule(s)\n", (int)plasticity_rule_vec.size());
     if (monitors_vec.size() > 0)
@@ -117,6 +236,9 @@ void SpikingModel::finalise_model() {
     printf("\n");
 
 
+    // No more synapses can be added, release any spare capacity
+    spiking_synapses->shrink_to_fit();
+
     spiking_synapses->model = this;
     spiking_neurons->model = this;
     input_spiking_neurons->model = this;
@@ -155,6 +277,7 @@ void SpikingModel::init_backend() {
   for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++){
     monitors_vec[monitor_id]->init_backend(context);
   }
+  build_step_plan();
 
   #ifndef SILENCE_MODEL_SETUP
   timer->stop_timer_and_log_time_and_message("Network set up.", true);
@@ -195,42 +318,307 @@ void SpikingModel::reset_time() {
 }
 
 
-void SpikingModel::perform_per_step_model_instructions(bool plasticity_on){
-  
-  spiking_neurons->state_update(current_time_in_timesteps, timestep);
-  input_spiking_neurons->state_update(current_time_in_timesteps, timestep);
-  
-  if (plasticity_on){
-    for (int plasticity_id = 0; plasticity_id < plasticity_rule_vec.size(); plasticity_id++)
-      plasticity_rule_vec[plasticity_id]->state_update(current_time_in_timesteps, timestep);
-  }
+void SpikingModel::build_step_plan(){
+  ::Backend::SpikingNeurons* neurons_backend = spiking_neurons->backend();
+  ::Backend::SpikingNeurons* input_neurons_backend = input_spiking_neurons->backend();
+  ::Backend::SpikingSynapses* synapses_backend = spiking_synapses->backend();
+
+  for (bool plasticity_on : {true, false}){
+    std::vector<model_step_stage>& plan = plasticity_on ? step_plan_with_plasticity : step_plan_without_plasticity;
+    plan.clear();
+
+    plan.push_back({[neurons_backend](unsigned int current_time_in_timesteps, float timestep){
+      neurons_backend->state_update(current_time_in_timesteps, timestep);
+    }, profiler.stage("neurons")});
+    plan.push_back({[input_neurons_backend](unsigned int current_time_in_timesteps, float timestep){
+      input_neurons_backend->state_update(current_time_in_timesteps, timestep);
+    }, profiler.stage("input neurons")});
+
+    if (plasticity_on){
+      for (int plasticity_id = 0; plasticity_id < plasticity_rule_vec.size(); plasticity_id++){
+        STDPPlasticity* plasticity_rule = plasticity_rule_vec[plasticity_id];
+        plan.push_back({[plasticity_rule](unsigned int current_time_in_timesteps, float timestep){
+          plasticity_rule->state_update(current_time_in_timesteps, timestep);
+        }, profiler.stage("plasticity rule " + std::to_string(plasticity_id))});
+      }
+    }
 
-  spiking_synapses->state_update(current_time_in_timesteps, timestep);
-  
-  for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++)
-    monitors_vec[monitor_id]->state_update(current_time_in_timesteps, timestep);
+    plan.push_back({[synapses_backend](unsigned int current_time_in_timesteps, float timestep){
+      synapses_backend->state_update(current_time_in_timesteps, timestep);
+    }, profiler.stage("synapses")});
 
+    for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++){
+      ActivityMonitor* monitor = monitors_vec[monitor_id];
+      plan.push_back({[monitor](unsigned int current_time_in_timesteps, float timestep){
+        monitor->state_update(current_time_in_timesteps, timestep);
+      }, profiler.stage("monitor " + std::to_string(monitor_id))});
+    }
+  }
+  host_copies_profiler_stage = profiler.stage("host copies");
 }
 
-void SpikingModel::run(float seconds, bool plasticity_on){
-  // Finalise the model if not already done
-  finalise_model();
+int SpikingModel::number_of_steps_for(float seconds){
   // Calculate the number of computational steps we need to do
   int number_of_timesteps = ceil(seconds / timestep);
-  int number_of_steps = ceil(number_of_timesteps / timestep_grouping);
+  return ceil(number_of_timesteps / timestep_grouping);
+}
 
-  printf("Running model for %f units of time (%d Timesteps) \n", seconds, (number_of_steps*timestep_grouping));
+void SpikingModel::run_steps(int number_of_steps, bool plasticity_on){
+  if (profiling){
+    run_steps_profiled(number_of_steps, plasticity_on);
+    return;
+  }
+
+  const std::vector<model_step_stage>& plan = plasticity_on ? step_plan_with_plasticity : step_plan_without_plasticity;
+  const model_step_stage* first_stage = plan.data();
+  const model_step_stage* last_stage = first_stage + plan.size();
 
   // Run the simulation for the given number of steps
   for (int s = 0; s < number_of_steps; s++){
     current_time_in_seconds = current_time_in_timesteps*timestep;
-    perform_per_step_model_instructions(plasticity_on);
+    for (const model_step_stage* stage = first_stage; stage < last_stage; stage++)
+      stage->update(current_time_in_timesteps, timestep);
+    current_time_in_timesteps += timestep_grouping;
+  }
+}
+
+void SpikingModel::run_steps_profiled(int number_of_steps, bool plasticity_on){
+  const std::vector<model_step_stage>& plan = plasticity_on ? step_plan_with_plasticity : step_plan_without_plasticity;
+  ::Backend::SpikingSynapses* synapses_backend = spiking_synapses->backend();
+  // Drained first, so that unprofiled steps are not counted
+  std::vector<::Backend::STDPPlasticity*> plasticity_backends;
+  for (STDPPlasticity* plasticity_rule : plasticity_rule_vec){
+    plasticity_backends.push_back(plasticity_rule->backend());
+    plasticity_backends.back()->last_step_active_synapses();
+  }
+
+  for (int s = 0; s < number_of_steps; s++){
+    current_time_in_seconds = current_time_in_timesteps*timestep;
+    StepProfiler::clock::time_point stage_start = StepProfiler::clock::now();
+    for (const model_step_stage& stage : plan){
+      stage.update(current_time_in_timesteps, timestep);
+      StepProfiler::clock::time_point stage_end = StepProfiler::clock::now();
+      profiler.add_time(stage.profiler_stage, stage_start, stage_end);
+      stage_start = stage_end;
+    }
+    long long presynaptic_spikes = 0, synaptic_events = 0, active_synapses = 0;
+    synapses_backend->last_step_activity(presynaptic_spikes, synaptic_events);
+    for (::Backend::STDPPlasticity* plasticity_backend : plasticity_backends)
+      active_synapses += plasticity_backend->last_step_active_synapses();
+    profiler.add_step_activity(presynaptic_spikes, synaptic_events, active_synapses);
+    profiler.number_of_steps++;
+    profiler.number_of_timesteps += timestep_grouping;
     current_time_in_timesteps += timestep_grouping;
   }
+}
 
+void SpikingModel::enable_profiling(bool on){
+  profiling = on;
+}
+
+void SpikingModel::begin_profile(){
+  profiler.reset();
+  profiler.timestep = timestep;
+  profile_start = StepProfiler::clock::now();
+}
+
+void SpikingModel::end_profile(){
+  profiler.wall_seconds = std::chrono::duration<double>(StepProfiler::clock::now() - profile_start).count();
+  profiler.print_summary();
+}
+
+void SpikingModel::final_update_monitors(){
   // Carry out any final checks and outputs from recording electrodes
+  StepProfiler::clock::time_point start = StepProfiler::clock::now();
   for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++)
     monitors_vec[monitor_id]->final_update(current_time_in_timesteps, timestep);
+  if (profiling)
+    profiler.add_time(host_copies_profiler_stage, start, StepProfiler::clock::now());
+}
 
+void SpikingModel::run(float seconds, bool plasticity_on){
+  // Finalise the model if not already done
+  finalise_model();
+  int number_of_steps = number_of_steps_for(seconds);
+
+  printf("Running model for %f units of time (%d Timesteps) \n", seconds, (number_of_steps*timestep_grouping));
+
+  if (profiling)
+    begin_profile();
+  run_steps(number_of_steps, plasticity_on);
+  final_update_monitors();
+  if (profiling)
+    end_profile();
 }
 
+void SpikingModel::run_schedule(const std::vector<stimulus_presentation>& schedule){
+  finalise_model();
+  InputSpikingNeurons* inputs = dynamic_cast<InputSpikingNeurons*>(input_spiking_neurons);
+  if (!inputs)
+    print_message_and_exit("A stimulus schedule needs input neurons with stimuli.");
+  for (auto& presentation : schedule)
+    if ((presentation.stimulus_index < 0) || (presentation.stimulus_index >= inputs->total_number_of_input_stimuli))
+      print_message_and_exit("Stimulus number exceeds number of stimuli loaded\n");
+
+  printf("Running a schedule of %d stimulus presentations\n", (int)schedule.size());
+
+  if (profiling)
+    begin_profile();
+  for (int p = 0; p < (int)schedule.size(); p++){
+    const stimulus_presentation& presentation = schedule[p];
+    if (presentation.reset_state_before)
+      reset_state();
+    if (presentation.reset_time_before)
+      reset_time();
+    inputs->select_stimulus(presentation.stimulus_index);
+    StepProfiler::clock::time_point presentation_start = StepProfiler::clock::now();
+    for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++)
+      monitors_vec[monitor_id]->begin_presentation(current_time_in_timesteps, timestep);
+    if (profiling)
+      profiler.add_time(host_copies_profiler_stage, presentation_start, StepProfiler::clock::now());
+    if (p + 1 < (int)schedule.size())
+      inputs->prefetch_stimulus(schedule[p + 1].stimulus_index);
+
+    run_steps(number_of_steps_for(presentation.duration), presentation.plasticity_on);
+  }
+
+  final_update_monitors();
+  if (profiling)
+    end_profile();
+}
+
+
+
+void SpikingModel::save_checkpoint_header(CheckpointWriter& checkpoint){
+  checkpoint.write_value("model/timestep", timestep);
+  checkpoint.write_value("model/timestep_grouping", timestep_grouping);
+  checkpoint.write_value("model/current_time_in_timesteps", current_time_in_timesteps);
+  checkpoint.write_value("model/current_time_in_seconds", current_time_in_seconds);
+  checkpoint.write_value("model/number_of_neurons", spiking_neurons->total_number_of_neurons);
+  checkpoint.write_value("model/number_of_input_neurons", input_spiking_neurons->total_number_of_neurons);
+  checkpoint.write_value("model/number_of_plasticity_rules", (int)plasticity_rule_vec.size());
+  checkpoint.write_value("model/number_of_monitors", (int)monitors_vec.size());
+}
+
+
+void SpikingModel::check_checkpoint_matches_model(const CheckpointReader& checkpoint){
+  if (checkpoint.read_value<float>("model/timestep") != timestep)
+    print_message_and_exit("The checkpoint was saved with a different timestep.");
+  if ((checkpoint.read_value<int>("model/number_of_neurons") != (spiking_neurons ? spiking_neurons->total_number_of_neurons : 0)) ||
+      (checkpoint.read_value<int>("model/number_of_input_neurons") != (input_spiking_neurons ? input_spiking_neurons->total_number_of_neurons : 0)) ||
+      (checkpoint.read_value<int>("model/number_of_plasticity_rules") != (int)plasticity_rule_vec.size()))
+    print_message_and_exit("The checkpoint does not match the neurons or plasticity rules of the model.");
+}
+
+
+void SpikingModel::load_connectivity(const CheckpointReader& checkpoint){
+  if (model_complete)
+    print_message_and_exit("Connectivity can only be loaded before the model is finalised.");
+  if (!spiking_synapses)
+    print_message_and_exit("Please set synapse pointer before loading connectivity.");
+
+  // The (sorted) synapses are mapped from the file, sort_synapses is skipped
+  spiking_synapses->load_state(checkpoint, "synapses");
+  if (spiking_neurons)
+    spiking_neurons->Neurons::load_state(checkpoint, "neurons");
+  if (input_spiking_neurons)
+    input_spiking_neurons->Neurons::load_state(checkpoint, "input_neurons");
+  for (int plasticity_id = 0; plasticity_id < plasticity_rule_vec.size(); plasticity_id++){
+    STDPPlasticity* rule = plasticity_rule_vec[plasticity_id];
+    rule->STDPPlasticity::load_state(checkpoint, "plasticity/" + std::to_string(plasticity_id));
+    if (rule->plasticity_rule_id >= (int)spiking_synapses->plasticity_rule_vec.size())
+      spiking_synapses->plasticity_rule_vec.resize(rule->plasticity_rule_id + 1, nullptr);
+    if (rule->plasticity_rule_id >= 0)
+      spiking_synapses->plasticity_rule_vec[rule->plasticity_rule_id] = rule;
+  }
+}
+
+
+void SpikingModel::save_connectivity_as_binary(std::string filename){
+  // Synapses are sorted when the model is finalised
+  finalise_model();
+
+  CheckpointWriter checkpoint(filename);
+  save_checkpoint_header(checkpoint);
+  spiking_synapses->save_state(checkpoint, "synapses");
+  spiking_neurons->Neurons::save_state(checkpoint, "neurons");
+  input_spiking_neurons->Neurons::save_state(checkpoint, "input_neurons");
+  for (int plasticity_id = 0; plasticity_id < plasticity_rule_vec.size(); plasticity_id++)
+    plasticity_rule_vec[plasticity_id]->STDPPlasticity::save_state(checkpoint, "plasticity/" + std::to_string(plasticity_id));
+  checkpoint.close();
+}
+
+
+void SpikingModel::load_connectivity_from_binary(std::string filename){
+  CheckpointReader checkpoint(filename);
+  check_checkpoint_matches_model(checkpoint);
+  load_connectivity(checkpoint);
+}
+
+
+void SpikingModel::save_checkpoint(std::string filename){
+  finalise_model();
+  if (context->backend != "CPU")
+    print_message_and_exit("Checkpoints are only supported by the CPU backend.");
+
+  CheckpointWriter checkpoint(filename);
+  save_checkpoint_header(checkpoint);
+
+  // Frontend state first, then that of the backend
+  spiking_synapses->save_state(checkpoint, "synapses");
+  spiking_synapses->backend()->save_state(checkpoint, "synapses/backend");
+  spiking_neurons->save_state(checkpoint, "neurons");
+  spiking_neurons->backend()->save_state(checkpoint, "neurons/backend");
+  input_spiking_neurons->save_state(checkpoint, "input_neurons");
+  input_spiking_neurons->backend()->save_state(checkpoint, "input_neurons/backend");
+  for (int plasticity_id = 0; plasticity_id < plasticity_rule_vec.size(); plasticity_id++){
+    std::string prefix = "plasticity/" + std::to_string(plasticity_id);
+    plasticity_rule_vec[plasticity_id]->save_state(checkpoint, prefix);
+    plasticity_rule_vec[plasticity_id]->backend()->save_state(checkpoint, prefix + "/backend");
+  }
+  for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++){
+    std::string prefix = "monitor/" + std::to_string(monitor_id);
+    monitors_vec[monitor_id]->save_state(checkpoint, prefix);
+    monitors_vec[monitor_id]->backend()->save_state(checkpoint, prefix + "/backend");
+  }
+  checkpoint.close();
+}
+
+
+void SpikingModel::load_checkpoint(std::string filename){
+  CheckpointReader checkpoint(filename);
+  check_checkpoint_matches_model(checkpoint);
+  if (checkpoint.read_value<int>("model/number_of_monitors") != (int)monitors_vec.size())
+    print_message_and_exit("The checkpoint does not match the monitors of the model.");
+
+  if (!model_complete){
+    // Take the connectivity from the checkpoint instead of AddSynapseGroup
+    load_connectivity(checkpoint);
+    finalise_model();
+  }
+  if (checkpoint.read_value<int>("model/timestep_grouping") != timestep_grouping)
+    print_message_and_exit("The checkpoint was saved with a different timestep grouping.");
+  if (context->backend != "CPU")
+    print_message_and_exit("Checkpoints are only supported by the CPU backend.");
+
+  // Preparing the backend may have changed the synapses (e.g. weight normalisation)
+  spiking_synapses->load_state(checkpoint, "synapses");
+  spiking_synapses->backend()->load_state(checkpoint, "synapses/backend");
+  spiking_neurons->load_state(checkpoint, "neurons");
+  spiking_neurons->backend()->load_state(checkpoint, "neurons/backend");
+  input_spiking_neurons->load_state(checkpoint, "input_neurons");
+  input_spiking_neurons->backend()->load_state(checkpoint, "input_neurons/backend");
+  for (int plasticity_id = 0; plasticity_id < plasticity_rule_vec.size(); plasticity_id++){
+    std::string prefix = "plasticity/" + std::to_string(plasticity_id);
+    plasticity_rule_vec[plasticity_id]->load_state(checkpoint, prefix);
+    plasticity_rule_vec[plasticity_id]->backend()->load_state(checkpoint, prefix + "/backend");
+  }
+  for (int monitor_id = 0; monitor_id < monitors_vec.size(); monitor_id++){
+    std::string prefix = "monitor/" + std::to_string(monitor_id);
+    monitors_vec[monitor_id]->load_state(checkpoint, prefix);
+    monitors_vec[monitor_id]->backend()->load_state(checkpoint, prefix + "/backend");
+  }
+
+  current_time_in_timesteps = checkpoint.read_value<unsigned int>("model/current_time_in_timesteps");
+  current_time_in_seconds = checkpoint.read_value<float>("model/current_time_in_seconds");
+}
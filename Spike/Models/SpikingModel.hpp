@@ -11,19 +11,54 @@ class SpikingModel; // Forward Declaration
 #include "../Neurons/Neurons.hpp"
 #include "../Neurons/SpikingNeurons.hpp"
 #include "../Helpers/TimerWithMessages.hpp"
+#include "../Helpers/StepProfiler.hpp"
 #include "../Helpers/RandomStateManager.hpp"
 #include "../ActivityMonitor/ActivityMonitor.hpp"
 #include <string>
 #include <fstream>
+#include <functional>
 #include <vector>
 
 #include <iostream>
 using namespace std;
 
 
+// One presentation of a stimulus schedule (see SpikingModel::run_schedule)
+struct stimulus_presentation {
+  int stimulus_index = 0;
+  float duration = 0.0f;            /**< In seconds */
+  bool plasticity_on = true;
+  bool reset_state_before = true;   /**< Calls reset_state() before the stimulus is selected */
+  bool reset_time_before = true;    /**< Calls reset_time() too, so that generator stimuli play from their start */
+};
+
+// One stage of a simulation step (see SpikingModel::build_step_plan)
+struct model_step_stage {
+  std::function<void(unsigned int current_time_in_timesteps, float timestep)> update;
+  int profiler_stage;   /**< Its index in SpikingModel::profiler.stages */
+};
+
 class SpikingModel {
 private:
-  void perform_per_step_model_instructions(bool plasticity_on);
+  /**
+   *  The stages of a step, with plasticity on and off, in the order neurons,
+   *  input neurons, plasticity rules, synapses and monitors. Built when the
+   *  backends are initialised: the neuron and synapse stages call their
+   *  backends directly (the frontends' state_update only forward to them).
+   */
+  std::vector<model_step_stage> step_plan_with_plasticity;
+  std::vector<model_step_stage> step_plan_without_plasticity;
+  void build_step_plan();
+  int number_of_steps_for(float seconds);
+  void run_steps(int number_of_steps, bool plasticity_on);
+
+  bool profiling = false;
+  int host_copies_profiler_stage = 0;
+  StepProfiler::clock::time_point profile_start;
+  void begin_profile();
+  void end_profile();
+  void run_steps_profiled(int number_of_steps, bool plasticity_on);
+  void final_update_monitors();
 public:
   unsigned int current_time_in_timesteps = 0;
   float current_time_in_seconds = 0.0f;
@@ -50,6 +85,17 @@ public:
   int AddInputNeuronGroup(neuron_parameters_struct * group_params);
 
   int AddSynapseGroup(int presynaptic_group_id, int postsynaptic_group_id, synapse_parameters_struct * synapse_params);
+  // Hint of the total number of synapses to be added, so that their storage is allocated once
+  void reserve(int number_of_synapses);
+  /**
+   *  Caches the synapses built by AddSynapseGroup in directory (which is
+   *  created if necessary). Each group is stored under a hash of everything
+   *  that determines its synapses (the group parameters, the neuron groups,
+   *  the synapses added before it and the host random seed), so a later run
+   *  which builds the same network reads the groups instead of generating
+   *  them. Pass "" to stop using the cache.
+   */
+  void SetConnectivityCache(std::string directory);
   void AddSynapseGroupsForNeuronGroupAndEachInputGroup(int postsynaptic_group_id, synapse_parameters_struct * synapse_params);
 
   void AddPlasticityRule(STDPPlasticity * plasticity_rule);
@@ -59,12 +105,68 @@ public:
   void reset_time();
   void run(float seconds, bool plasticity_on=true);
 
+  /**
+   *  Turns profiling of run() and run_schedule() on or off. When on, the
+   *  wall time of every stage of a step and the activity of the synapses
+   *  are collected in profiler, which is reset at the start of each run and
+   *  summarised at its end. When off, it costs one branch per run.
+   */
+  void enable_profiling(bool on=true);
+  StepProfiler profiler;
+  /**
+   *  Runs a whole schedule of stimulus presentations, as a loop of
+   *  reset_state, select_stimulus and run would, without handing back to the
+   *  caller in between. Monitors are only flushed once, at the end, and
+   *  mark the start of every presentation (see
+   *  ActivityMonitor::begin_presentation). While one stimulus is presented
+   *  the input neurons prefetch the next one.
+   */
+  void run_schedule(const std::vector<stimulus_presentation>& schedule);
+
+  /**
+   *  Writes the complete simulation state (connectivity, neuron, synapse,
+   *  plasticity and monitor state and the current time) to a checkpoint file.
+   *  Finalises the model if necessary. Only supported on the CPU backend.
+   */
+  void save_checkpoint(std::string filename);
+  /**
+   *  Restores a checkpoint written by save_checkpoint, after which run()
+   *  continues exactly as the saved simulation would have. The model must be
+   *  set up with the same components, neuron groups, plasticity rules and
+   *  monitors. If the model is not yet finalised, the synapses are taken from
+   *  the checkpoint and AddSynapseGroup need not be called.
+   */
+  void load_checkpoint(std::string filename);
+
+  /**
+   *  Writes the connectivity alone (the synapse arrays sorted by presynaptic
+   *  neuron, the per-neuron efferent offsets and the synapses of each
+   *  plasticity rule) in the checkpoint file format. Finalises the model.
+   */
+  void save_connectivity_as_binary(std::string filename);
+  /**
+   *  Replaces network construction by AddSynapseGroup: the synapse arrays are
+   *  mapped from a file written by save_connectivity_as_binary and used in
+   *  place. Neuron groups and plasticity rules must be added beforehand, in
+   *  the same order as when the file was saved.
+   */
+  void load_connectivity_from_binary(std::string filename);
+
   virtual void init_backend();
   virtual void prepare_backend();
   virtual void finalise_model();
 
 protected:
   virtual void create_parameter_arrays() {}
+
+private:
+  std::string connectivity_cache_directory;
+  uint64_t connectivity_cache_key(int presynaptic_group_id, int postsynaptic_group_id, synapse_parameters_struct * synapse_params);
+  int add_synapse_group_through_cache(int presynaptic_group_id, int postsynaptic_group_id, synapse_parameters_struct * synapse_params);
+
+  void save_checkpoint_header(CheckpointWriter& checkpoint);
+  void check_checkpoint_matches_model(const CheckpointReader& checkpoint);
+  void load_connectivity(const CheckpointReader& checkpoint);
 };
 
 #endif
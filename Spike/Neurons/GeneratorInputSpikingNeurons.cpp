@@ -2,6 +2,10 @@
 #include "../Helpers/TerminalHelpers.hpp"
 #include <stdlib.h>
 #include <stdio.h>
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <vector>
 
 GeneratorInputSpikingNeurons::~GeneratorInputSpikingNeurons() {
   free(neuron_id_matrix_for_stimuli);
@@ -21,34 +25,47 @@ int GeneratorInputSpikingNeurons::AddGroup(neuron_parameters_struct * group_para
 */
 
 
-int GeneratorInputSpikingNeurons::add_stimulus(int spikenumber, int* ids, float* spiketimes){
-
-
+int GeneratorInputSpikingNeurons::allocate_stimulus(){
   int stimulus_index = total_number_of_input_stimuli;
   total_number_of_input_stimuli++;
 
-  // If the number of spikes in this stimulus is larger than any other ...
-  if (spikenumber > length_of_longest_stimulus){
-    length_of_longest_stimulus = spikenumber;
-  }
-
   number_of_spikes_in_stimuli = (int*)realloc(number_of_spikes_in_stimuli, sizeof(int)*total_number_of_input_stimuli);
   temporal_lengths_of_stimuli = (float*)realloc(temporal_lengths_of_stimuli, sizeof(float)*total_number_of_input_stimuli);
   neuron_id_matrix_for_stimuli = (int**)realloc(neuron_id_matrix_for_stimuli, sizeof(int*)*total_number_of_input_stimuli);
   spike_times_matrix_for_stimuli = (float**)realloc(spike_times_matrix_for_stimuli, sizeof(float*)*total_number_of_input_stimuli);
+  streamed_stimuli.push_back(nullptr);
   
   // Initialize matrices
   neuron_id_matrix_for_stimuli[stimulus_index] = nullptr;
   spike_times_matrix_for_stimuli[stimulus_index] = nullptr;
   number_of_spikes_in_stimuli[stimulus_index] = 0;
-  
+  temporal_lengths_of_stimuli[stimulus_index] = 0.0f;
+
+  return stimulus_index;
+}
+
+
+int GeneratorInputSpikingNeurons::add_stimulus(int spikenumber, int* ids, float* spiketimes){
+
+
+  int stimulus_index = allocate_stimulus();
+
+  // If the number of spikes in this stimulus is larger than any other ...
+  if (spikenumber > length_of_longest_stimulus){
+    length_of_longest_stimulus = spikenumber;
+  }
+
   neuron_id_matrix_for_stimuli[stimulus_index] = (int*)realloc(neuron_id_matrix_for_stimuli[stimulus_index], sizeof(int)*(spikenumber));
   spike_times_matrix_for_stimuli[stimulus_index] = (float*)realloc(spike_times_matrix_for_stimuli[stimulus_index], sizeof(float)*(spikenumber));
   
-  // Assign the genid values according to how many neurons exist already
+  // Stored in time order (stable, so simultaneous spikes keep their order),
+  // which lets the backends find the spikes due in a timestep by bisection
+  std::vector<int> order(spikenumber);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b){ return spiketimes[a] < spiketimes[b]; });
   for (int i = 0; i < spikenumber; i++){
-    neuron_id_matrix_for_stimuli[stimulus_index][i] = ids[i];
-    spike_times_matrix_for_stimuli[stimulus_index][i] = spiketimes[i];
+    neuron_id_matrix_for_stimuli[stimulus_index][i] = ids[order[i]];
+    spike_times_matrix_for_stimuli[stimulus_index][i] = spiketimes[order[i]];
   }
 
   // Increment the number of entries the generator population
@@ -74,6 +91,48 @@ void GeneratorInputSpikingNeurons::select_stimulus(int stimulus_index){
   if (_backend) backend()->setup_stimulus();
 }
 
+void GeneratorInputSpikingNeurons::prefetch_stimulus(int stimulus_index){
+  if ((stimulus_index != current_stimulus_index) && streamed_stimuli[stimulus_index])
+    streamed_stimuli[stimulus_index]->rewind();
+}
+
+
+int GeneratorInputSpikingNeurons::add_stimulus_from_binary(std::string spike_ids_filename, std::string spike_times_filename, int spikes_per_chunk){
+  auto stream = std::make_shared<SpikeStreamReader>(spike_ids_filename, spike_times_filename, spikes_per_chunk);
+  int stimulus_index = allocate_stimulus();
+  streamed_stimuli[stimulus_index] = stream;
+  // Only used to tell whether the stimulus is empty
+  number_of_spikes_in_stimuli[stimulus_index] = (int)std::min<long long>(stream->total_number_of_spikes, INT_MAX);
+  temporal_lengths_of_stimuli[stimulus_index] = stream->time_of_last_spike;
+  return stimulus_index;
+}
+
+
+int GeneratorInputSpikingNeurons::spikes_due(unsigned int current_time_in_timesteps, float timestep, int& first, const int*& neuron_ids, const float*& spike_times){
+  // The same time as the backends compare spike times against. A whole
+  // timestep of margin (rather than the half a timestep a spike is matched
+  // within) keeps float rounding from excluding a spike which is due.
+  float now = current_time_in_timesteps*timestep - stimulus_onset_adjustment;
+  float last = now + (model->timestep_grouping - 1)*timestep;
+
+  if (streamed_stimuli[current_stimulus_index]){
+    first = 0;
+    return streamed_stimuli[current_stimulus_index]->spikes_due(now, last, timestep, neuron_ids, spike_times);
+  }
+
+  int number_of_spikes = number_of_spikes_in_stimuli[current_stimulus_index];
+  const float* stimulus_spike_times = spike_times_matrix_for_stimuli[current_stimulus_index];
+  if ((first < 0) || (first > number_of_spikes) || ((first > 0) && (now - stimulus_spike_times[first - 1] < timestep)))
+    first = 0;  // Time has gone backwards (or the stimulus changed)
+  first = std::partition_point(stimulus_spike_times + first, stimulus_spike_times + number_of_spikes,
+                               [&](float spike_time){ return now - spike_time >= timestep; }) - stimulus_spike_times;
+  int end = std::partition_point(stimulus_spike_times + first, stimulus_spike_times + number_of_spikes,
+                                 [&](float spike_time){ return spike_time - last < timestep; }) - stimulus_spike_times;
+  neuron_ids = neuron_id_matrix_for_stimuli[current_stimulus_index] + first;
+  spike_times = stimulus_spike_times + first;
+  return end - first;
+}
+
 
 int GeneratorInputSpikingNeurons::add_stimulus(std::vector<int> ids, std::vector<float> spiketimes){
   if (ids.size() != spiketimes.size())
@@ -2,6 +2,8 @@
 #define GeneratorInputSpikingNeurons_H
 
 #include "InputSpikingNeurons.hpp"
+#include "../ActivityMonitor/SpikeStreamReader.hpp"
+#include <memory>
 
 struct generator_input_spiking_neuron_parameters_struct : input_spiking_neuron_parameters_struct {
 	generator_input_spiking_neuron_parameters_struct() { input_spiking_neuron_parameters_struct(); }
@@ -25,7 +27,7 @@ public:
   SPIKE_ADD_BACKEND_GETSET(GeneratorInputSpikingNeurons, InputSpikingNeurons);
   
   // Variables
-  int length_of_longest_stimulus;
+  int length_of_longest_stimulus = 0;  /**< Of the stimuli held in memory */
   float stimulus_onset_adjustment = 0.0f;
 
   // Host Pointers
@@ -33,14 +35,41 @@ public:
   int** neuron_id_matrix_for_stimuli = nullptr;
   float** spike_times_matrix_for_stimuli = nullptr;
   float* temporal_lengths_of_stimuli = nullptr;
+  // Stimuli added by add_stimulus_from_binary, read from disk as they play (nullptr for stimuli held in memory)
+  std::vector<std::shared_ptr<SpikeStreamReader>> streamed_stimuli;
 
   int add_stimulus(int spikenumber, int* ids, float* spiketimes);
   int add_stimulus(std::vector<int> ids, std::vector<float> spiketimes);
+  /**
+   *  Adds a stimulus which is streamed from a SpikeIDs.bin/SpikeTimes.bin pair
+   *  (as written by SpikingActivityMonitor::save_spikes_as_binary, so earlier
+   *  runs can be replayed) rather than held in memory, see SpikeStreamReader.
+   *  Spike times are absolute, as for add_stimulus.
+   */
+  int add_stimulus_from_binary(std::string spike_ids_filename, std::string spike_times_filename, int spikes_per_chunk=(1 << 20));
+
+  /**
+   *  The spikes of a stimulus are kept sorted by time. Points neuron_ids and
+   *  spike_times at the spikes of the current stimulus which may fall into the
+   *  timesteps current_time_in_timesteps to current_time_in_timesteps +
+   *  timestep_grouping - 1, and returns their number.
+   *  For stimuli held in memory, first is the index of the first of these
+   *  spikes and should hold the value from the previous call (or 0): all spikes
+   *  before it are known to be in the past, so only the spikes which are due
+   *  are looked at while time moves forward. Streamed stimuli keep their own
+   *  position and set first to 0.
+   */
+  int spikes_due(unsigned int current_time_in_timesteps, float timestep, int& first, const int*& neuron_ids, const float*& spike_times);
+  bool stimulus_is_streamed(int stimulus_index) const { return streamed_stimuli[stimulus_index] != nullptr; }
 
   void select_stimulus(int stimulus_index) override;
+  // Streamed stimuli start reading their first chunk (unless in use)
+  void prefetch_stimulus(int stimulus_index) override;
 
 private:
   std::shared_ptr<::Backend::GeneratorInputSpikingNeurons> _backend;
+  // Extends the per-stimulus arrays by an empty stimulus
+  int allocate_stimulus();
 };
 
 #endif
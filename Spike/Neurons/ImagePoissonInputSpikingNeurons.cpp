@@ -7,7 +7,15 @@
 #include <fstream>
 #include <sstream>
 #include <string>
-#include "../Helpers/FstreamWrapper.hpp"
+#include "../Helpers/Checkpoint.hpp"
+#include "../Helpers/ContentHash.hpp"
+#include "../Helpers/Parallel.hpp"
+#include "../Helpers/TerminalHelpers.hpp"
+#include <cerrno>
+#include <climits>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -19,7 +27,14 @@ ImagePoissonInputSpikingNeurons::ImagePoissonInputSpikingNeurons() {
 }
 
 ImagePoissonInputSpikingNeurons::~ImagePoissonInputSpikingNeurons() {
-  free(gabor_input_rates);
+  free_rates();
+}
+
+void ImagePoissonInputSpikingNeurons::free_rates() {
+  if (!rate_cache_mapping)
+    free(gabor_input_rates);
+  rate_cache_mapping.reset();
+  gabor_input_rates = nullptr;
 }
 
 int ImagePoissonInputSpikingNeurons::AddGroup(neuron_parameters_struct * group_params){
@@ -61,13 +76,65 @@ void ImagePoissonInputSpikingNeurons::set_up_rates(const char * fileList, const
   filterWavelengths->clear();
   filterOrientations->clear();
   // Reset should also be done for gabor filtered images
-  if (gabor_input_rates)
-	  free(gabor_input_rates);
+  free_rates();
 	
   load_image_names_from_file_list(fileList, inputDirectory);
   load_gabor_filter_parameters(filterParameters, inputDirectory);
+
+  if (rate_cache_directory.empty()) {
+    load_rates_from_files(inputDirectory, max_rate_scaling_factor);
+    return;
+  }
+
+  char key[17];
+  snprintf(key, sizeof(key), "%016llx", (unsigned long long)rate_cache_key(fileList, filterParameters, inputDirectory, max_rate_scaling_factor));
+  string filename = rate_cache_directory + "/gabor_rates_" + key + ".bin";
+
+  if (access(filename.c_str(), R_OK) == 0) {
+    CheckpointReader cache(filename);
+    size_t bytes;
+    // The mapping is private, so the rates may be modified in place
+    gabor_input_rates = (float*)cache.data("gabor_input_rates", bytes);
+    if (bytes != (size_t)total_number_of_rates*sizeof(float))
+      print_message_and_exit(("The rate cache entry " + filename + " does not match the input.").c_str());
+    rate_cache_mapping = cache.mapping();
+    return;
+  }
+
   load_rates_from_files(inputDirectory, max_rate_scaling_factor);
+  // Written under a temporary name so that a concurrent or interrupted run never sees a partial entry
+  string temporary_filename = filename + "." + std::to_string(getpid()) + ".tmp";
+  CheckpointWriter cache(temporary_filename);
+  cache.write("gabor_input_rates", gabor_input_rates, (size_t)total_number_of_rates*sizeof(float));
+  cache.close();
+  if (rename(temporary_filename.c_str(), filename.c_str()) != 0)
+    print_message_and_exit(("Could not write the rate cache entry " + filename + ".").c_str());
+}
 
+void ImagePoissonInputSpikingNeurons::set_rate_cache(std::string directory) {
+  if (!directory.empty() && (mkdir(directory.c_str(), 0777) != 0) && (errno != EEXIST))
+    print_message_and_exit(("Could not create the rate cache directory " + directory + ".").c_str());
+  rate_cache_directory = directory;
+}
+
+// Called once the file list and the filter parameters are loaded, so that
+// the key covers their contents as well as their names
+uint64_t ImagePoissonInputSpikingNeurons::rate_cache_key(const char * fileList, const char * filterParameters, const char * inputDirectory, float max_rate_scaling_factor) {
+  const uint32_t rate_cache_version = 1;
+  ContentHash hash;
+  hash.add_value(rate_cache_version);
+  hash.add_string(fileList);
+  hash.add_string(filterParameters);
+  hash.add_string(inputDirectory);
+  hash.add_value(max_rate_scaling_factor);
+  hash.add_value((uint64_t)inputNames.size());
+  for (auto& name : inputNames)
+    hash.add_string(name);
+  hash.add_vector(*filterPhases);
+  hash.add_vector(*filterWavelengths);
+  hash.add_vector(*filterOrientations);
+  hash.add_value(image_width);
+  return hash.value;
 }
 
 void ImagePoissonInputSpikingNeurons::copy_rates_to_device() {
@@ -216,84 +283,60 @@ void ImagePoissonInputSpikingNeurons::load_gabor_filter_parameters(const char *
 
 void ImagePoissonInputSpikingNeurons::load_rates_from_files(const char * inputDirectory, float max_rate_scaling_factor) {
 
-
-  gabor_input_rates = (float *)malloc(total_number_of_rates*sizeof(float));
-  int zero_count = 0;
-
-  for(int image_index = 0; image_index < total_number_of_input_stimuli; image_index++) {
-
-    float total_activation_for_image = 0.0;
-
-    int image_starting_index = image_index * total_number_of_rates_per_image;
-    // printf("image_starting_index: %d\n", image_starting_index);
-		
-    // cout << "Loading Rates for Image #" << image_index << endl;
-		
-    for(int orientation_index = 0; orientation_index < total_number_of_orientations; orientation_index++) {
-
-      for(int wavelength_index = 0; wavelength_index < total_number_of_wavelengths; wavelength_index++) {
-
-        for(int phase_index = 0; phase_index < total_number_of_phases; phase_index++) {
-
-          int gabor_index = calculate_gabor_index(orientation_index,wavelength_index,phase_index);
-          int start_index_for_current_gabor_image = image_starting_index + gabor_index * image_width * image_width;
-
-          // printf("ORIENTATION: %d\n", orientation_index);
-          // printf("WAVELENGTH: %d\n", wavelength_index);
-          // printf("PHASE: %d\n\n", phase_index);
-          // printf("GABOR_INDEX: %d\n", gabor_index);
-					
-          // Read input to network
-          ostringstream dirStream;
-
-          dirStream << inputDirectory << "Filtered/" << inputNames[image_index] << ".flt" << "/"
-                    << inputNames[image_index] << '.' << filterWavelengths->at(wavelength_index) << '.' 
-                    << filterOrientations->at(orientation_index) << '.' << filterPhases->at(phase_index) << ".gbo";
-					
-          string t = dirStream.str();
-					
-          // Open&Read gabor filter file
-          fstreamWrapper gaborStream;
-					
-          try {
-						
-            gaborStream.open(t.c_str(), std::ios_base::in | std::ios_base::binary);
-
-            for(int image_x = 0; image_x < image_width; image_x++)
-              for(int image_y = 0; image_y < image_width; image_y++) {
-								
-                float rate;
-                gaborStream >> rate;
-
-                // printf("rate: %f\n", rate);
-                if (rate < 0.000001) zero_count++;
-
-                if(rate < 0) {
-                  cerr << "Negative firing loaded from filter!!!" << endl;
-                  exit(EXIT_FAILURE);
-                }
-
-                int element_index = start_index_for_current_gabor_image + image_x + image_y * image_width;
-								
-                total_activation_for_image += rate;
-
-                // Rates from Matlab lie between 0 and 1, so multiply by max number of spikes per second in cortex
-                gabor_input_rates[element_index] = rate * max_rate_scaling_factor;
-              }
-						
-          } catch (fstream::failure e) {
-            stringstream s;
-            s << "Unable to open/read from " << t << " for gabor input: " << e.what();
-            cerr << s.str();
-            exit(EXIT_FAILURE);
-          }
-        }
+  gabor_input_rates = (float *)malloc((size_t)total_number_of_rates*sizeof(float));
+
+  // Every (image, Gabor type) file is read in parallel with a single read
+  int number_of_pixels = image_width * image_width;
+  int number_of_files = total_number_of_input_stimuli * total_number_of_gabor_types;
+  std::mutex error_mutex;
+  int first_failed_file = INT_MAX;
+  string first_error;
+
+  parallel_for_blocks(number_of_files, [&](int file_index) {
+    int image_index = file_index / total_number_of_gabor_types;
+    int gabor_index = file_index % total_number_of_gabor_types;
+    int orientation_index = gabor_index / (total_number_of_wavelengths * total_number_of_phases);
+    int wavelength_index = (gabor_index / total_number_of_phases) % total_number_of_wavelengths;
+    int phase_index = gabor_index % total_number_of_phases;
+
+    // Read input to network
+    ostringstream dirStream;
+    dirStream << inputDirectory << "Filtered/" << inputNames[image_index] << ".flt" << "/"
+              << inputNames[image_index] << '.' << filterWavelengths->at(wavelength_index) << '.'
+              << filterOrientations->at(orientation_index) << '.' << filterPhases->at(phase_index) << ".gbo";
+    string t = dirStream.str();
+
+    vector<float> rates(number_of_pixels);
+    ifstream gaborStream(t.c_str(), std::ios_base::in | std::ios_base::binary);
+    gaborStream.read((char*)rates.data(), number_of_pixels*sizeof(float));
+
+    string error;
+    if (!gaborStream)
+      error = "Unable to open/read from " + t + " for gabor input.";
+    else if (std::any_of(rates.begin(), rates.end(), [](float rate){ return rate < 0; }))
+      error = "Negative firing loaded from filter!!!";
+    if (!error.empty()) {
+      // The first failing file is reported, however the files were scheduled
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (file_index < first_failed_file) {
+        first_failed_file = file_index;
+        first_error = error;
       }
+      return;
     }
-    // printf("total_activation_for_image: %f\n", total_activation_for_image);
-  }
 
-  // printf("--- --- Proportion of input rates 0.0: %f\n", (float)zero_count/(float)total_number_of_rates);
+    // The files are x major and the rates y major.
+    // Rates from Matlab lie between 0 and 1, so multiply by max number of spikes per second in cortex
+    float* gabor_rates = gabor_input_rates + (size_t)image_index*total_number_of_rates_per_image + (size_t)gabor_index*number_of_pixels;
+    for (int image_x = 0; image_x < image_width; image_x++)
+      for (int image_y = 0; image_y < image_width; image_y++)
+        gabor_rates[image_x + image_y * image_width] = rates[image_x * image_width + image_y] * max_rate_scaling_factor;
+  });
+
+  if (!first_error.empty()) {
+    cerr << first_error << endl;
+    exit(EXIT_FAILURE);
+  }
 }
 
 int ImagePoissonInputSpikingNeurons::calculate_gabor_index(int orientationIndex, int wavelengthIndex, int phaseIndex) {
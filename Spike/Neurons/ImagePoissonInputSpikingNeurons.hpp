@@ -7,6 +7,8 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <stdint.h>
 
 // using namespace std;
 
@@ -42,6 +44,15 @@ public:
   int AddGroup(neuron_parameters_struct * group_params) override;
   void AddGroupForEachGaborType(neuron_parameters_struct * group_params);
 
+  /**
+   *  Keeps the rates assembled by set_up_rates in directory (which is created
+   *  if necessary), under a hash of the file list, the filter parameters, the
+   *  input directory and the scaling factor. Later calls with the same
+   *  arguments map that file instead of reading the Gabor files, so the
+   *  cache must be cleared if the filtered images change. Pass "" to stop
+   *  using the cache.
+   */
+  void set_rate_cache(std::string directory);
   void set_up_rates(const char * fileList, const char * filterParameters, const char * inputDirectory, float max_rate_scaling_factor);
   void load_image_names_from_file_list(const char * fileList, const char * inputDirectory);
   void load_gabor_filter_parameters(const char * filterParameters, const char * inputDirectory);
@@ -71,6 +82,12 @@ public:
 
 private:
   std::shared_ptr<::Backend::ImagePoissonInputSpikingNeurons> _backend;
+
+  std::string rate_cache_directory;
+  // Set when gabor_input_rates points into a mapped cache file rather than malloc'd memory
+  std::shared_ptr<void> rate_cache_mapping;
+  uint64_t rate_cache_key(const char * fileList, const char * filterParameters, const char * inputDirectory, float max_rate_scaling_factor);
+  void free_rates();
 };
 
 #endif
@@ -1,4 +1,5 @@
 #include "InputSpikingNeurons.hpp"
+#include "../Helpers/Checkpoint.hpp"
 #include <stdlib.h>
 #include <algorithm>
 #include "../Helpers/TerminalHelpers.hpp"
@@ -19,3 +20,12 @@ void InputSpikingNeurons::select_stimulus(int stimulus_index){
 }
 
 
+void InputSpikingNeurons::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  SpikingNeurons::save_state(checkpoint, prefix);
+  checkpoint.write_value(prefix + "/current_stimulus_index", current_stimulus_index);
+}
+
+void InputSpikingNeurons::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  SpikingNeurons::load_state(checkpoint, prefix);
+  current_stimulus_index = checkpoint.read_value<int>(prefix + "/current_stimulus_index");
+}
@@ -24,7 +24,11 @@ public:
   int current_stimulus_index = 0;
   int total_number_of_input_stimuli = 0;
   virtual void select_stimulus(int stimulus_index);
+  // Hint that stimulus_index will be selected next, so that it can be made ready in the background
+  virtual void prefetch_stimulus(int stimulus_index) {}
   int AddGroup(neuron_parameters_struct * group_params) override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
 
 private:
   std::shared_ptr<::Backend::InputSpikingNeurons> _backend;
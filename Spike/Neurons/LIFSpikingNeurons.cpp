@@ -1,4 +1,5 @@
 #include "LIFSpikingNeurons.hpp"
+#include "../Helpers/HostRandom.hpp"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -63,7 +64,7 @@ int LIFSpikingNeurons::AddGroup(neuron_parameters_struct * group_params){
     if (!this_group_params->set_init_membrane){
       membrane_potentials_v.push_back(this_group_params->resting_potential_v0);
     } else {
-      membrane_potentials_v.push_back(this_group_params->membrane_potential_range[0] + ((float)(rand()) / RAND_MAX)*(this_group_params->membrane_potential_range[1] - this_group_params->membrane_potential_range[0]));
+      membrane_potentials_v.push_back(this_group_params->membrane_potential_range[0] + host_random_stream(RANDOM_STREAM_MEMBRANE_POTENTIALS, 0).uniform_float_at(i)*(this_group_params->membrane_potential_range[1] - this_group_params->membrane_potential_range[0]));
     }
   }
 
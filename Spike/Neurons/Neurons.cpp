@@ -1,4 +1,5 @@
 #include "Neurons.hpp"
+#include "../Helpers/Checkpoint.hpp"
 #include <cassert>
 #include <stdlib.h>
 #include "../Helpers/TerminalHelpers.hpp"
@@ -89,5 +90,20 @@ void Neurons::reset_state() {
   backend()->reset_state();
 }
 
+
+void Neurons::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  checkpoint.write(prefix + "/per_neuron_afferent_synapse_count", per_neuron_afferent_synapse_count, total_number_of_neurons*sizeof(int));
+  checkpoint.write(prefix + "/per_neuron_efferent_synapse_count", per_neuron_efferent_synapse_count, total_number_of_neurons*sizeof(int));
+  checkpoint.write(prefix + "/per_neuron_efferent_synapse_start", per_neuron_efferent_synapse_start, total_number_of_neurons*sizeof(int));
+  checkpoint.write_value(prefix + "/max_num_efferent_synapses", max_num_efferent_synapses);
+}
+
+void Neurons::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  checkpoint.read(prefix + "/per_neuron_afferent_synapse_count", per_neuron_afferent_synapse_count, total_number_of_neurons*sizeof(int));
+  checkpoint.read(prefix + "/per_neuron_efferent_synapse_count", per_neuron_efferent_synapse_count, total_number_of_neurons*sizeof(int));
+  checkpoint.read(prefix + "/per_neuron_efferent_synapse_start", per_neuron_efferent_synapse_start, total_number_of_neurons*sizeof(int));
+  max_num_efferent_synapses = checkpoint.read_value<int>(prefix + "/max_num_efferent_synapses");
+}
+
 SPIKE_MAKE_STUB_INIT_BACKEND(Neurons);
 
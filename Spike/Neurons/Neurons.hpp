@@ -86,6 +86,8 @@ public:
    *  Resets any undesired data which is dynamically reassigned during a simulation. 
    */
   void reset_state() override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
 
 
   /**
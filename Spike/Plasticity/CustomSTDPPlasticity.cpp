@@ -10,6 +10,7 @@
 
 CustomSTDPPlasticity::CustomSTDPPlasticity(SpikingSynapses* synapses, SpikingNeurons* neurons, SpikingNeurons* input_neurons, stdp_plasticity_parameters_struct* stdp_parameters){
   stdp_params = (custom_stdp_plasticity_parameters_struct *)stdp_parameters;
+  event_driven = stdp_parameters->event_driven;
 }
 
 CustomSTDPPlasticity::~CustomSTDPPlasticity() {
@@ -9,6 +9,7 @@
 
 EvansSTDPPlasticity::EvansSTDPPlasticity(SpikingSynapses* synapses, SpikingNeurons* neurons, SpikingNeurons* input_neurons, stdp_plasticity_parameters_struct* stdp_parameters){
   stdp_params = (evans_stdp_plasticity_parameters_struct *)stdp_parameters;
+  event_driven = stdp_parameters->event_driven;
 }
 
 EvansSTDPPlasticity::~EvansSTDPPlasticity() {
@@ -17,6 +18,7 @@ EvansSTDPPlasticity::~EvansSTDPPlasticity() {
 }
 
 void EvansSTDPPlasticity::prepare_backend_early() {
+  STDPPlasticity::prepare_backend_early();
   // Create extra LIF arrays
   recent_postsynaptic_activities_D = (float*)realloc(recent_postsynaptic_activities_D, sizeof(float)*total_number_of_plastic_synapses);
   recent_presynaptic_activities_C = (float*)realloc(recent_presynaptic_activities_C, sizeof(float)*total_number_of_plastic_synapses);
@@ -8,6 +8,7 @@
 
 InhibitorySTDPPlasticity::InhibitorySTDPPlasticity(SpikingSynapses* synapses, SpikingNeurons* neurons, SpikingNeurons* input_neurons, stdp_plasticity_parameters_struct* stdp_parameters){
   stdp_params = (inhibitory_stdp_plasticity_parameters_struct *)stdp_parameters;
+  event_driven = stdp_parameters->event_driven;
 }
 
 InhibitorySTDPPlasticity::~InhibitorySTDPPlasticity() {
@@ -1,4 +1,6 @@
 #include "STDPPlasticity.hpp"
+#include "../Helpers/Checkpoint.hpp"
+#include "../Helpers/TerminalHelpers.hpp"
 #include <vector>
 
 STDPPlasticity::~STDPPlasticity(){
@@ -20,3 +22,27 @@ void STDPPlasticity::prepare_backend_early() {
 void STDPPlasticity::reset_state() {
   backend()->reset_state();
 }
+
+
+void STDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  checkpoint.write_value(prefix + "/plasticity_rule_id", plasticity_rule_id);
+  // As synapse ids before sorting, which is what prepare_backend_early expects
+  std::vector<int> unsorted_plastic_synapses(total_number_of_plastic_synapses);
+  for (int s = 0; s < total_number_of_plastic_synapses; s++)
+    unsorted_plastic_synapses[s] = model->spiking_synapses->synapse_sort_indices[plastic_synapses[s]];
+  checkpoint.write_vector(prefix + "/plastic_synapses", unsorted_plastic_synapses);
+}
+
+void STDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  if ((model == nullptr) || !model->model_complete){
+    plasticity_rule_id = checkpoint.read_value<int>(prefix + "/plasticity_rule_id");
+    checkpoint.read_vector(prefix + "/plastic_synapses", plastic_synapses);
+    total_number_of_plastic_synapses = plastic_synapses.size();
+  } else {
+    // Already remapped by prepare_backend_early
+    size_t bytes;
+    checkpoint.data(prefix + "/plastic_synapses", bytes);
+    if (bytes != total_number_of_plastic_synapses*sizeof(int))
+      print_message_and_exit("Checkpoint plasticity rule does not match the model.");
+  }
+}
@@ -32,6 +32,9 @@ namespace Backend {
   public:
     SPIKE_ADD_BACKEND_FACTORY(STDPPlasticity);
     ~STDPPlasticity() override = default;
+    // The plastic synapses updated since the last call, for SpikingModel's
+    // profiler (which calls it once per step). Zero if not counted.
+    virtual long long last_step_active_synapses() { return 0; }
   };
 }
 
@@ -41,6 +44,8 @@ static_assert(std::has_virtual_destructor<Backend::STDPPlasticity>::value,
 // STDPPlasticity Parameters
 struct stdp_plasticity_parameters_struct : plasticity_parameters_struct {
 	stdp_plasticity_parameters_struct() {}
+	// Only update synapses whose pre- or postsynaptic neuron spiked (traces are decayed lazily)
+	bool event_driven = false;
 };
 
 
@@ -51,6 +56,8 @@ public:
   SPIKE_ADD_BACKEND_GETSET(STDPPlasticity, SpikeBase);
   void reset_state() override;
   void prepare_backend_early() override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
 
   SpikingModel* model = nullptr;
   
@@ -58,6 +65,8 @@ public:
   std::vector<int> plastic_synapses;
   int total_number_of_plastic_synapses = 0;
 
+  bool event_driven = false;  /**< Set from stdp_plasticity_parameters_struct::event_driven */
+
   virtual void AddSynapseIndices(int synapse_id_start, int num_synapses_to_add);
   virtual void state_update(unsigned int current_time_in_timesteps, float timestep) override = 0;
 
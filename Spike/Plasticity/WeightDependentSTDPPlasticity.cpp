@@ -10,6 +10,7 @@
 
 WeightDependentSTDPPlasticity::WeightDependentSTDPPlasticity(SpikingSynapses* synapses, SpikingNeurons* neurons, SpikingNeurons* input_neurons, stdp_plasticity_parameters_struct* stdp_parameters){
   stdp_params = (weightdependent_stdp_plasticity_parameters_struct *)stdp_parameters;
+  event_driven = stdp_parameters->event_driven;
 }
 
 WeightDependentSTDPPlasticity::~WeightDependentSTDPPlasticity() {
@@ -1,4 +1,5 @@
 #include "WeightNormSTDPPlasticity.hpp"
+#include "../Helpers/Checkpoint.hpp"
 
 WeightNormSTDPPlasticity::WeightNormSTDPPlasticity(SpikingSynapses* synapses, SpikingNeurons* neurons, SpikingNeurons* input_neurons, plasticity_parameters_struct* parameters){
   
@@ -70,4 +71,25 @@ void WeightNormSTDPPlasticity::prepare_backend_early(){
   }
 }
 
+
+void WeightNormSTDPPlasticity::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  STDPPlasticity::save_state(checkpoint, prefix);
+  if (initial_weights){
+    int total_number_of_neurons = model->spiking_neurons->total_number_of_neurons;
+    checkpoint.write(prefix + "/sum_squared_afferent_values", sum_squared_afferent_values, total_number_of_neurons*sizeof(float));
+    checkpoint.write(prefix + "/afferent_weight_change_updater", afferent_weight_change_updater, total_number_of_neurons*sizeof(float));
+    checkpoint.write(prefix + "/initial_weights", initial_weights, total_number_of_plastic_synapses*sizeof(float));
+  }
+}
+
+void WeightNormSTDPPlasticity::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  STDPPlasticity::load_state(checkpoint, prefix);
+  if (initial_weights){
+    int total_number_of_neurons = model->spiking_neurons->total_number_of_neurons;
+    checkpoint.read(prefix + "/sum_squared_afferent_values", sum_squared_afferent_values, total_number_of_neurons*sizeof(float));
+    checkpoint.read(prefix + "/afferent_weight_change_updater", afferent_weight_change_updater, total_number_of_neurons*sizeof(float));
+    checkpoint.read(prefix + "/initial_weights", initial_weights, total_number_of_plastic_synapses*sizeof(float));
+  }
+}
+
 SPIKE_MAKE_INIT_BACKEND(WeightNormSTDPPlasticity);
@@ -63,6 +63,8 @@ public:
 
   void init_backend(Context* ctx = _global_ctx) override;
   void prepare_backend_early() override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
   virtual void state_update(unsigned int current_time_in_timesteps, float timestep) override;
 
 private:
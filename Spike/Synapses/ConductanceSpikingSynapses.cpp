@@ -1,4 +1,5 @@
 #include "ConductanceSpikingSynapses.hpp"
+#include "../Helpers/Checkpoint.hpp"
 #include "../Helpers/TerminalHelpers.hpp"
 
 // ConductanceSpikingSynapses Destructor
@@ -7,12 +8,6 @@ ConductanceSpikingSynapses::~ConductanceSpikingSynapses() {
 #ifdef CRAZY_DEBUG
   std::cout << "@@@@@@@@@@ 0 " << synaptic_conductances_g << " \n";
 #endif
-
-  free(synaptic_conductances_g);
-
-#ifdef CRAZY_DEBUG
-  std::cout << "@@@@@@@@@@ 1\n";
-#endif
 }
 
 
@@ -33,9 +28,6 @@ int ConductanceSpikingSynapses::AddGroup(int presynaptic_group_id,
 
   conductance_spiking_synapse_parameters_struct * conductance_spiking_synapse_group_params = (conductance_spiking_synapse_parameters_struct*)synapse_params;
   
-  // Incrementing number of synapses
-  ConductanceSpikingSynapses::increment_number_of_synapses(temp_number_of_synapses_in_last_group);
-
   for (int i = (total_number_of_synapses - temp_number_of_synapses_in_last_group); i < total_number_of_synapses; i++) {
     synaptic_conductances_g[i] = 0.0f;
     //reversal_potentials_Vhat[i] = conductance_spiking_synapse_group_params->reversal_potential_Vhat;
@@ -69,21 +61,33 @@ int ConductanceSpikingSynapses::AddGroup(int presynaptic_group_id,
   	for (int i = (total_number_of_synapses - temp_number_of_synapses_in_last_group); i < total_number_of_synapses; i++) {
   		syn_labels[i] = indextoset;
   	}
+	if (!dense_groups.empty() && (dense_groups.back().group_id == groupID))
+		dense_groups.back().syn_label = indextoset;
+	if (synapse_params->connectivity_type == CONNECTIVITY_TYPE_CONVOLUTIONAL)
+		convolutional_groups.back().syn_label = indextoset;
+	if (synapse_params->procedural_connectivity)
+		procedural_groups.back().syn_label = indextoset;
   }
 
   return(groupID);
 }
 
-void ConductanceSpikingSynapses::increment_number_of_synapses(int increment) {
 
-  synaptic_conductances_g = (float*)realloc(synaptic_conductances_g, total_number_of_synapses * sizeof(float));
-  //reversal_potentials_Vhat = (float*)realloc(reversal_potentials_Vhat, total_number_of_synapses * sizeof(float));
-  //decay_terms_tau_g = (float*)realloc(decay_terms_tau_g, total_number_of_synapses * sizeof(float));
+void ConductanceSpikingSynapses::state_update(unsigned int current_time_in_timesteps, float timestep) {
+  backend()->state_update(current_time_in_timesteps, timestep);
 }
 
 
-void ConductanceSpikingSynapses::state_update(unsigned int current_time_in_timesteps, float timestep) {
-  backend()->state_update(current_time_in_timesteps, timestep);
+void ConductanceSpikingSynapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  SpikingSynapses::save_state(checkpoint, prefix);
+  checkpoint.write_vector(prefix + "/reversal_potentials_Vhat", reversal_potentials_Vhat);
+  checkpoint.write_vector(prefix + "/decay_terms_tau_g", decay_terms_tau_g);
+}
+
+void ConductanceSpikingSynapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  SpikingSynapses::load_state(checkpoint, prefix);
+  checkpoint.read_vector(prefix + "/reversal_potentials_Vhat", reversal_potentials_Vhat);
+  checkpoint.read_vector(prefix + "/decay_terms_tau_g", decay_terms_tau_g);
 }
 
 SPIKE_MAKE_INIT_BACKEND(ConductanceSpikingSynapses);
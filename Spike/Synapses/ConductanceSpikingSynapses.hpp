@@ -23,12 +23,14 @@ namespace Backend {
 class ConductanceSpikingSynapses : public SpikingSynapses {
 
 public:
-  ConductanceSpikingSynapses() : SpikingSynapses() {};
-  ConductanceSpikingSynapses(int seedval) : SpikingSynapses(seedval) {};
+  ConductanceSpikingSynapses() : ConductanceSpikingSynapses(42) {};
+  ConductanceSpikingSynapses(int seedval) : SpikingSynapses(seedval) { synapse_store.add_column(&synaptic_conductances_g); };
   ~ConductanceSpikingSynapses() override;
 
   SPIKE_ADD_BACKEND_GETSET(ConductanceSpikingSynapses, SpikingSynapses);
   void init_backend(Context* ctx = _global_ctx) override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
 
   float * synaptic_conductances_g = nullptr;
   vector<float> reversal_potentials_Vhat;
@@ -42,7 +44,6 @@ public:
                 float timestep,
                 synapse_parameters_struct * synapse_params) override;
 
-  void increment_number_of_synapses(int increment);
 
   void state_update(unsigned int current_time_in_timesteps, float timestep) override;
 
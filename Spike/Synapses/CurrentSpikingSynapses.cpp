@@ -1,4 +1,5 @@
 #include "CurrentSpikingSynapses.hpp"
+#include "Spike/Helpers/Checkpoint.hpp"
 #include "Spike/Helpers/TerminalHelpers.hpp"
 
 int CurrentSpikingSynapses::AddGroup(int presynaptic_group_id, 
@@ -42,6 +43,12 @@ int CurrentSpikingSynapses::AddGroup(int presynaptic_group_id,
   	for (int i = (total_number_of_synapses - temp_number_of_synapses_in_last_group); i < total_number_of_synapses; i++) {
   		syn_labels[i] = indextoset;
   	}
+	if (!dense_groups.empty() && (dense_groups.back().group_id == groupID))
+		dense_groups.back().syn_label = indextoset;
+	if (synapse_params->connectivity_type == CONNECTIVITY_TYPE_CONVOLUTIONAL)
+		convolutional_groups.back().syn_label = indextoset;
+	if (synapse_params->procedural_connectivity)
+		procedural_groups.back().syn_label = indextoset;
   }
 
   return(groupID);
@@ -52,5 +59,16 @@ void CurrentSpikingSynapses::state_update(unsigned int current_time_in_timesteps
   backend()->state_update(current_time_in_timesteps, timestep);
 }
 
+
+void CurrentSpikingSynapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  SpikingSynapses::save_state(checkpoint, prefix);
+  checkpoint.write_vector(prefix + "/decay_terms_tau", decay_terms_tau);
+}
+
+void CurrentSpikingSynapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  SpikingSynapses::load_state(checkpoint, prefix);
+  checkpoint.read_vector(prefix + "/decay_terms_tau", decay_terms_tau);
+}
+
 SPIKE_MAKE_INIT_BACKEND(CurrentSpikingSynapses);
 
@@ -27,6 +27,8 @@ public:
 
   SPIKE_ADD_BACKEND_GETSET(CurrentSpikingSynapses, SpikingSynapses);
   void init_backend(Context* ctx = _global_ctx) override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
   
   vector<float> decay_terms_tau;
   int AddGroup(int presynaptic_group_id, 
@@ -1,52 +1,32 @@
 #include "SpikingSynapses.hpp"
+#include "../Helpers/Checkpoint.hpp"
 #include "../Helpers/TerminalHelpers.hpp"
+#include "../Helpers/HostRandom.hpp"
+
+SpikingSynapses::SpikingSynapses() : SpikingSynapses(42) {
+}
+
+SpikingSynapses::SpikingSynapses(int seedval) : Synapses(seedval) {
+  synapse_store.add_column(&delays);
+  synapse_store.add_column(&syn_labels);
+}
 
 SpikingSynapses::~SpikingSynapses() {
 #ifdef CRAZY_DEBUG
   std::cout << "SpikingSynapses::~SpikingSynapses\n";
 #endif
-  free(delays);
-
 }
 
 void SpikingSynapses::prepare_backend_early() {
   Synapses::prepare_backend_early();
+  // Also sets the Neuron and InputNeuron efferent start indices
   Synapses::sort_synapses(model->input_spiking_neurons, model->spiking_neurons);
-  SpikingSynapses::sort_synapses();
-  
-  // Setting Neuron and InputNeuron start indices
-  set_synapse_start(presynaptic_neuron_indices[0], 0);
-  for (int s=1; s < total_number_of_synapses; s++){
-    if (presynaptic_neuron_indices[s-1] != presynaptic_neuron_indices[s])
-      set_synapse_start(presynaptic_neuron_indices[s], s); 
-  }
 }
 
-void SpikingSynapses::set_synapse_start(int pre_index, int syn_start){
-  bool is_presynaptic = PRESYNAPTIC_IS_INPUT(pre_index);
-  int corr_pre_index = CORRECTED_PRESYNAPTIC_ID(pre_index, is_presynaptic);
-
-  int* neuron_start_indices = is_presynaptic ? model->input_spiking_neurons->per_neuron_efferent_synapse_start : model->spiking_neurons->per_neuron_efferent_synapse_start;
-
-  neuron_start_indices[corr_pre_index] = syn_start;
-}
-
-
-void SpikingSynapses::sort_synapses(){
-  
-  int* temp_delay_array = (int*)malloc(total_number_of_synapses * sizeof(int));
-  int* temp_synlabel_array = (int*)malloc(total_number_of_synapses * sizeof(int));
-  // Re-ordering arrays
-  for (int s=0; s < total_number_of_synapses; s++){
-    temp_delay_array[s] = delays[synapse_sort_indices[s]];
-    temp_synlabel_array[s] = syn_labels[synapse_sort_indices[s]];
-  }
-
-  free(delays);
-  free(syn_labels);
-
-  delays = temp_delay_array;
-  syn_labels = temp_synlabel_array;
+void SpikingSynapses::sort_synapse_attributes(std::vector<char>& scratch){
+  Synapses::sort_synapse_attributes(scratch);
+  apply_synapse_sort(delays, scratch);
+  apply_synapse_sort(syn_labels, scratch);
 }
 
 // Connection Detail implementation
@@ -74,9 +54,6 @@ int SpikingSynapses::AddGroup(int presynaptic_group_id,
               timestep,
               synapse_params);
 
-  // First incrementing the synapses
-  SpikingSynapses::increment_number_of_synapses(temp_number_of_synapses_in_last_group);
-
   spiking_synapse_parameters_struct * spiking_synapse_group_params = (spiking_synapse_parameters_struct*)synapse_params;
 
   // Convert delay range from time to number of timesteps
@@ -97,27 +74,60 @@ int SpikingSynapses::AddGroup(int presynaptic_group_id,
 #endif
   }
   
-  for (int i = (total_number_of_synapses - temp_number_of_synapses_in_last_group); i < total_number_of_synapses; i++){
-    // Setup Delays
-    float delayval = delay_range_in_timesteps[0];
+  if (synapse_params->connectivity_type == CONNECTIVITY_TYPE_CONVOLUTIONAL){
     if (delay_range_in_timesteps[0] != delay_range_in_timesteps[1])
-      delayval = delay_range_in_timesteps[0] + (delay_range_in_timesteps[1] - delay_range_in_timesteps[0]) * ((float)rand() / (RAND_MAX));
-    delays[i] = round(delayval);
-    syn_labels[i] = 0; // Conductance or other systems can now use this if they wish
-    if (spiking_synapse_group_params->connectivity_type == CONNECTIVITY_TYPE_PAIRWISE){
-      if (spiking_synapse_group_params->pairwise_connect_delay.size() == temp_number_of_synapses_in_last_group){
-        delays[i] = (int)round(spiking_synapse_group_params->pairwise_connect_delay[i + temp_number_of_synapses_in_last_group - total_number_of_synapses] / timestep);
-        if (delays[i] < 1){
-          print_message_and_exit("PAIRWISE CONNECTION ERROR: All delays must be greater than one timestep.");
+      print_message_and_exit("CONVOLUTIONAL CONNECTION ERROR: Convolutional groups have a single delay (delay_range[0] must equal delay_range[1]).");
+    convolutional_groups.back().delay = delay_range_in_timesteps[0];
+    if (delay_range_in_timesteps[0] > maximum_axonal_delay_in_timesteps) maximum_axonal_delay_in_timesteps = delay_range_in_timesteps[0];
+    if (delay_range_in_timesteps[0] < minimum_axonal_delay_in_timesteps) minimum_axonal_delay_in_timesteps = delay_range_in_timesteps[0];
+  }
+
+  if (!dense_groups.empty() && (dense_groups.back().group_id == groupID)){
+    dense_groups.back().delay = delay_range_in_timesteps[0];
+    if (delay_range_in_timesteps[0] > maximum_axonal_delay_in_timesteps) maximum_axonal_delay_in_timesteps = delay_range_in_timesteps[0];
+    if (delay_range_in_timesteps[0] < minimum_axonal_delay_in_timesteps) minimum_axonal_delay_in_timesteps = delay_range_in_timesteps[0];
+  }
+
+  if (synapse_params->procedural_connectivity){
+    procedural_groups.back().delay_range[0] = delay_range_in_timesteps[0];
+    procedural_groups.back().delay_range[1] = delay_range_in_timesteps[1];
+    if (delay_range_in_timesteps[1] > maximum_axonal_delay_in_timesteps) maximum_axonal_delay_in_timesteps = delay_range_in_timesteps[1];
+    if (delay_range_in_timesteps[0] < minimum_axonal_delay_in_timesteps) minimum_axonal_delay_in_timesteps = delay_range_in_timesteps[0];
+  }
+
+  if (cached_group) {
+    // The delays came from the cache
+    for (int i = (total_number_of_synapses - temp_number_of_synapses_in_last_group); i < total_number_of_synapses; i++){
+      syn_labels[i] = 0;
+      if (delays[i] > maximum_axonal_delay_in_timesteps) maximum_axonal_delay_in_timesteps = delays[i];
+      if (delays[i] < minimum_axonal_delay_in_timesteps) minimum_axonal_delay_in_timesteps = delays[i];
+    }
+  } else {
+    // Each delay is its synapse's number of the group's delay stream
+    CounterRandom delay_stream = host_random_stream(RANDOM_STREAM_DELAYS, (uint32_t)groupID);
+    int first_synapse = total_number_of_synapses - temp_number_of_synapses_in_last_group;
+    for (int i = first_synapse; i < total_number_of_synapses; i++){
+      // Setup Delays
+      float delayval = delay_range_in_timesteps[0];
+      if (delay_range_in_timesteps[0] != delay_range_in_timesteps[1])
+        delayval = delay_range_in_timesteps[0] + (delay_range_in_timesteps[1] - delay_range_in_timesteps[0]) * delay_stream.uniform_float_at(i - first_synapse);
+      delays[i] = round(delayval);
+      syn_labels[i] = 0; // Conductance or other systems can now use this if they wish
+      if (spiking_synapse_group_params->connectivity_type == CONNECTIVITY_TYPE_PAIRWISE){
+        if (spiking_synapse_group_params->pairwise_connect_delay.size() == temp_number_of_synapses_in_last_group){
+          delays[i] = (int)round(spiking_synapse_group_params->pairwise_connect_delay[i + temp_number_of_synapses_in_last_group - total_number_of_synapses] / timestep);
+          if (delays[i] < 1){
+            print_message_and_exit("PAIRWISE CONNECTION ERROR: All delays must be greater than one timestep.");
+          }
+        } else if (spiking_synapse_group_params->pairwise_connect_delay.size() != 0) {
+          print_message_and_exit("PAIRWISE CONNECTION ERROR: Delay vector length not as expected. Should be the same length as pre/post vecs.");
         }
-      } else if (spiking_synapse_group_params->pairwise_connect_delay.size() != 0) {
-        print_message_and_exit("PAIRWISE CONNECTION ERROR: Delay vector length not as expected. Should be the same length as pre/post vecs.");
       }
-    }
     
-    // Ensure max/min delays are set correctly
-    if (delays[i] > maximum_axonal_delay_in_timesteps) maximum_axonal_delay_in_timesteps = delays[i];
-    if (delays[i] < minimum_axonal_delay_in_timesteps) minimum_axonal_delay_in_timesteps = delays[i];
+      // Ensure max/min delays are set correctly
+      if (delays[i] > maximum_axonal_delay_in_timesteps) maximum_axonal_delay_in_timesteps = delays[i];
+      if (delays[i] < minimum_axonal_delay_in_timesteps) minimum_axonal_delay_in_timesteps = delays[i];
+    }
   }
   if (neurons->total_number_of_neurons > neuron_pop_size)
     neuron_pop_size = neurons->total_number_of_neurons; 
@@ -126,9 +136,26 @@ int SpikingSynapses::AddGroup(int presynaptic_group_id,
 
 }
 
-void SpikingSynapses::increment_number_of_synapses(int increment) {
-  delays = (int*)realloc(delays, total_number_of_synapses * sizeof(int));
-  syn_labels = (int*)realloc(syn_labels, total_number_of_synapses * sizeof(int));
+
+bool SpikingSynapses::stores_weight_matrix(float timestep, synapse_parameters_struct * synapse_params) {
+  spiking_synapse_parameters_struct * spiking_synapse_group_params = (spiking_synapse_parameters_struct*)synapse_params;
+  return Synapses::stores_weight_matrix(timestep, synapse_params) &&
+    (round(spiking_synapse_group_params->delay_range[0]/timestep) == round(spiking_synapse_group_params->delay_range[1]/timestep));
+}
+
+
+void SpikingSynapses::add_group_parameters_to_hash(ContentHash& hash,
+                                                   int presynaptic_group_id,
+                                                   int postsynaptic_group_id,
+                                                   float timestep,
+                                                   synapse_parameters_struct * synapse_params) {
+  Synapses::add_group_parameters_to_hash(hash, presynaptic_group_id, postsynaptic_group_id, timestep, synapse_params);
+  spiking_synapse_parameters_struct * spiking_synapse_group_params = (spiking_synapse_parameters_struct*)synapse_params;
+  hash.add_value(timestep);
+  hash.add_value(spiking_synapse_group_params->delay_range[0]);
+  hash.add_value(spiking_synapse_group_params->delay_range[1]);
+  if (synapse_params->connectivity_type == CONNECTIVITY_TYPE_PAIRWISE)
+    hash.add_vector(spiking_synapse_group_params->pairwise_connect_delay);
 }
 
 
@@ -137,13 +164,6 @@ void SpikingSynapses::state_update(unsigned int current_time_in_timesteps, float
 }
 
 void SpikingSynapses::save_connectivity_as_txt(std::string path, std::string prefix, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
   Synapses::save_connectivity_as_txt(path, prefix, synapsegroupid);
   std::ofstream delayfile;
 
@@ -155,9 +175,9 @@ void SpikingSynapses::save_connectivity_as_txt(std::string path, std::string pre
     backend()->copy_to_frontend();
 
   // Send data to file
-  for (int i = startid; i < endid; i++){
-    delayfile << delays[synapse_reversesort_indices[i]] << std::endl;
-  }
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){ delayfile << delays[synapse_id] << std::endl; },
+    [&](dense_synapse_group& group, int pre, int post){ delayfile << group.delay << std::endl; });
 
   // Close files
   delayfile.close();
@@ -165,13 +185,6 @@ void SpikingSynapses::save_connectivity_as_txt(std::string path, std::string pre
 };
 // Ensure copied from device, then send
 void SpikingSynapses::save_connectivity_as_binary(std::string path, std::string prefix, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
   Synapses::save_connectivity_as_binary(path, prefix, synapsegroupid);
   std::ofstream delayfile;
 
@@ -183,12 +196,29 @@ void SpikingSynapses::save_connectivity_as_binary(std::string path, std::string
     backend()->copy_to_frontend();
 
   // Send data to file
-  for (int i = startid; i < endid; i++){
-    delayfile.write((char *)&delays[synapse_reversesort_indices[i]], sizeof(int));
-  }
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){ delayfile.write((char *)&delays[synapse_id], sizeof(int)); },
+    [&](dense_synapse_group& group, int pre, int post){ delayfile.write((char *)&group.delay, sizeof(int)); });
 
   // Close files
   delayfile.close();
 }
 
+
+void SpikingSynapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  Synapses::save_state(checkpoint, prefix);
+  checkpoint.write_value(prefix + "/minimum_axonal_delay_in_timesteps", minimum_axonal_delay_in_timesteps);
+  checkpoint.write_value(prefix + "/maximum_axonal_delay_in_timesteps", maximum_axonal_delay_in_timesteps);
+  checkpoint.write_value(prefix + "/neuron_pop_size", neuron_pop_size);
+  checkpoint.write_value(prefix + "/num_syn_labels", num_syn_labels);
+}
+
+void SpikingSynapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  Synapses::load_state(checkpoint, prefix);
+  minimum_axonal_delay_in_timesteps = checkpoint.read_value<int>(prefix + "/minimum_axonal_delay_in_timesteps");
+  maximum_axonal_delay_in_timesteps = checkpoint.read_value<int>(prefix + "/maximum_axonal_delay_in_timesteps");
+  neuron_pop_size = checkpoint.read_value<int>(prefix + "/neuron_pop_size");
+  num_syn_labels = checkpoint.read_value<int>(prefix + "/num_syn_labels");
+}
+
 SPIKE_MAKE_INIT_BACKEND(SpikingSynapses);
@@ -14,6 +14,9 @@ namespace Backend {
     SPIKE_ADD_BACKEND_FACTORY(SpikingSynapses);
     virtual void copy_weights_to_host() = 0;
     virtual void state_update(unsigned int current_time_in_timesteps, float timestep) = 0;
+    // The spikes which reached synapses and the synaptic events of the last
+    // state_update, for SpikingModel's profiler. Left at zero if not counted.
+    virtual void last_step_activity(long long& presynaptic_spikes, long long& synaptic_events) {}
   };
 }
 
@@ -24,13 +27,15 @@ struct spiking_synapse_parameters_struct : synapse_parameters_struct {
 
 class SpikingSynapses : public Synapses {
 public:
-  SpikingSynapses() : Synapses() {};
-  SpikingSynapses(int seedval) : Synapses(seedval) {};
+  SpikingSynapses();
+  SpikingSynapses(int seedval);
   ~SpikingSynapses() override;
 
   SPIKE_ADD_BACKEND_GETSET(SpikingSynapses, Synapses);
   void init_backend(Context* ctx = _global_ctx) override;
   void prepare_backend_early() override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
 
   // Host Pointers
   int* delays = nullptr;
@@ -52,15 +57,23 @@ public:
                 Neurons * input_neurons,
                 float timestep,
                 synapse_parameters_struct * synapse_params) override;
+  // Also requires a single delay
+  bool stores_weight_matrix(float timestep, synapse_parameters_struct * synapse_params) override;
+  void add_group_parameters_to_hash(ContentHash& hash,
+                                    int presynaptic_group_id,
+                                    int postsynaptic_group_id,
+                                    float timestep,
+                                    synapse_parameters_struct * synapse_params) override;
 
-  void increment_number_of_synapses(int increment);
-  void sort_synapses();
-  void set_synapse_start(int pre_index, int syn_start);
 
   virtual void state_update(unsigned int current_time_in_timesteps, float timestep);
 
   virtual void save_connectivity_as_txt(std::string path, std::string prefix="", int synapsegroupid=-1) override;
   virtual void save_connectivity_as_binary(std::string path, std::string prefix="",int synapsegroupid=-1) override;
+
+protected:
+  void sort_synapse_attributes(std::vector<char>& scratch) override;
+
 private:
   std::shared_ptr<::Backend::SpikingSynapses> _backend;
 };
@@ -0,0 +1,96 @@
+#include "SynapseStore.hpp"
+#include "../Helpers/TerminalHelpers.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <string.h>
+#include <stdlib.h>
+
+SynapseStore::~SynapseStore() {
+  if (external_owner)
+    return;
+  for (auto& c : columns)
+    free(c.data);
+}
+
+void SynapseStore::add_column(void** owner, size_t element_size) {
+  column c = {owner, nullptr, element_size};
+  if (allocated_synapses > 0) {
+    c.data = malloc(allocated_synapses * element_size);
+    if (c.data == nullptr)
+      print_message_and_exit("Synapse memory allocation failed.");
+  }
+  *owner = c.data;
+  columns.push_back(c);
+}
+
+void SynapseStore::reallocate(int new_capacity) {
+  if (external_owner) {
+    // Move out of the external memory, which must not be freed or grown
+    size_t kept = (size_t)std::min(number_of_synapses, new_capacity);
+    for (auto& c : columns) {
+      void* data = nullptr;
+      if (new_capacity > 0) {
+        data = malloc((size_t)new_capacity * c.element_size);
+        if (data == nullptr)
+          print_message_and_exit("Synapse memory allocation failed.");
+        memcpy(data, c.data, kept * c.element_size);
+      }
+      c.data = data;
+      *c.owner = c.data;
+    }
+    external_owner.reset();
+    allocated_synapses = new_capacity;
+    return;
+  }
+  for (auto& c : columns) {
+    if (new_capacity == 0) {
+      free(c.data);
+      c.data = nullptr;
+    } else {
+      void* data = realloc(c.data, (size_t)new_capacity * c.element_size);
+      if (data == nullptr)
+        print_message_and_exit("Synapse memory allocation failed.");
+      c.data = data;
+    }
+    *c.owner = c.data;
+  }
+  allocated_synapses = new_capacity;
+}
+
+void SynapseStore::resize(int new_number_of_synapses) {
+  if (new_number_of_synapses > allocated_synapses) {
+    long long new_capacity = 2 * (long long)allocated_synapses;
+    if (new_capacity < new_number_of_synapses)
+      new_capacity = new_number_of_synapses;
+    if (new_capacity > INT_MAX)
+      new_capacity = INT_MAX;
+    reallocate((int)new_capacity);
+  }
+  number_of_synapses = new_number_of_synapses;
+}
+
+void SynapseStore::reserve(int requested_synapses) {
+  if (requested_synapses > allocated_synapses)
+    reallocate(requested_synapses);
+}
+
+void SynapseStore::map_columns(const std::vector<void*>& data, int new_number_of_synapses, std::shared_ptr<void> owner) {
+  if (data.size() != columns.size())
+    print_message_and_exit("Mapped synapse data does not match the synapse columns.");
+  if (!external_owner)
+    for (auto& c : columns)
+      free(c.data);
+  for (int c = 0; c < columns.size(); c++) {
+    columns[c].data = data[c];
+    *columns[c].owner = data[c];
+  }
+  external_owner = owner;
+  number_of_synapses = new_number_of_synapses;
+  allocated_synapses = new_number_of_synapses;
+}
+
+void SynapseStore::shrink_to_fit() {
+  if (allocated_synapses > number_of_synapses)
+    reallocate(number_of_synapses);
+}
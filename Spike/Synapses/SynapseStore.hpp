@@ -0,0 +1,67 @@
+#ifndef SYNAPSESTORE_H
+#define SYNAPSESTORE_H
+
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+/*!
+  Owns the memory of every per-synapse array (structure of arrays).
+
+  Each array is registered once with add_column, passing the address of the
+  pointer through which it is used (e.g. &presynaptic_neuron_indices). All
+  columns share one capacity which grows geometrically, so adding synapses
+  group by group costs amortised linear time. Whenever memory is moved the
+  registered pointers are updated, so the rest of the code keeps using plain
+  pointers as before.
+*/
+class SynapseStore {
+public:
+  SynapseStore() = default;
+  SynapseStore(const SynapseStore&) = delete;
+  SynapseStore& operator=(const SynapseStore&) = delete;
+  ~SynapseStore();
+
+  template <typename T>
+  void add_column(T** column) {
+    add_column(reinterpret_cast<void**>(column), sizeof(T));
+  }
+
+  // Sets the number of synapses, growing the capacity geometrically if required
+  void resize(int number_of_synapses);
+  // Ensures room for at least number_of_synapses without further copies
+  void reserve(int number_of_synapses);
+  // Releases any capacity beyond the current number of synapses
+  void shrink_to_fit();
+  /**
+   *  Points every column (in the order they were added) at number_of_synapses
+   *  elements of external memory, e.g. a private file mapping, which owner
+   *  keeps alive. The data is only copied into owned memory if the store
+   *  is later resized beyond number_of_synapses or shrunk.
+   */
+  void map_columns(const std::vector<void*>& data, int number_of_synapses, std::shared_ptr<void> owner);
+
+  int size() const { return number_of_synapses; }
+  int capacity() const { return allocated_synapses; }
+
+  // Raw access to the columns, in the order in which they were added
+  int number_of_columns() const { return columns.size(); }
+  void* column_data(int c) const { return columns[c].data; }
+  size_t column_element_size(int c) const { return columns[c].element_size; }
+
+private:
+  struct column {
+    void** owner;
+    void* data;
+    size_t element_size;
+  };
+  std::vector<column> columns;
+  int number_of_synapses = 0;
+  int allocated_synapses = 0;
+  std::shared_ptr<void> external_owner;   /**< Set while the columns point into external memory */
+
+  void add_column(void** owner, size_t element_size);
+  void reallocate(int new_capacity);
+};
+
+#endif
@@ -6,10 +6,13 @@
 
 #include "Synapses.hpp"
 #include "../Helpers/TerminalHelpers.hpp"
+#include "../Helpers/Parallel.hpp"
+#include "../Helpers/HostRandom.hpp"
+#include "../Helpers/Checkpoint.hpp"
 
 #include <algorithm> // for random shuffle
 #include <vector> // for random shuffle
-#include <random>
+#include <climits>
 
 // Synapses Constructor
 Synapses::Synapses() : Synapses(42) {
@@ -17,74 +20,92 @@ Synapses::Synapses() : Synapses(42) {
 
 // Synapses Constructor
 Synapses::Synapses(int seedval) {
-  srand(seedval); // Seeding the random numbers
+  seed_host_random(seedval); // Seeding the random numbers
   random_state_manager = new RandomStateManager();
+
+  synapse_store.add_column(&presynaptic_neuron_indices);
+  synapse_store.add_column(&postsynaptic_neuron_indices);
+  synapse_store.add_column(&synaptic_efficacies_or_weights);
+  synapse_store.add_column(&weight_scaling_constants);
+  synapse_store.add_column(&synapse_postsynaptic_neuron_count_index);
+  synapse_store.add_column(&synapse_sort_indices);
+  synapse_store.add_column(&synapse_reversesort_indices);
 }
 
 void Synapses::prepare_backend_early() {
   random_state_manager->init_backend(backend()->context);
 }
 
+// Synapses are sorted by presynaptic neuron (input neurons first) with a
+// stable counting sort. Each thread histograms a contiguous chunk of the
+// synapses, a prefix sum over (neuron, chunk) gives every chunk its own write
+// position per neuron and the chunks are then scattered in parallel. The
+// resulting offsets are the efferent CSR start indices of each neuron.
 void Synapses::sort_synapses(Neurons* input_neurons, Neurons* neurons){
   if (!synapses_sorted){
-    std::vector<std::vector<int>> per_neuron_synapses;
-    int total_possible_pre_neurons = input_neurons->total_number_of_neurons + neurons->total_number_of_neurons;
-    for (int n=0; n < total_possible_pre_neurons; n++){
-      std::vector<int> empty;
-      per_neuron_synapses.push_back(empty);
-    }
-
-    for (int s=0; s < total_number_of_synapses; s++){
-      per_neuron_synapses[input_neurons->total_number_of_neurons + presynaptic_neuron_indices[s]].push_back(s);
-    }
-
-    // Sorting
-    int count = 0;
-    for (int n=0; n < total_possible_pre_neurons; n++){
-      for (int s=0; s < per_neuron_synapses[n].size(); s++){
-        synapse_sort_indices[count] = per_neuron_synapses[n][s];
-        count++;
+    int number_of_input_neurons = input_neurons->total_number_of_neurons;
+    int total_possible_pre_neurons = number_of_input_neurons + neurons->total_number_of_neurons;
+
+    // Fewer chunks than threads for small networks, the histograms cost O(chunks x neurons)
+    int number_of_chunks = std::min(construction_thread_count(), total_number_of_synapses / 65536 + 1);
+    std::vector<std::vector<int>> chunk_offsets(number_of_chunks);
+
+    auto chunk_start = [&](int chunk) {
+      return (int)(((long long)total_number_of_synapses * chunk) / number_of_chunks);
+    };
+
+    parallel_for_blocks(number_of_chunks, [&](int chunk) {
+        std::vector<int>& counts = chunk_offsets[chunk];
+        counts.assign(total_possible_pre_neurons, 0);
+        for (int s = chunk_start(chunk); s < chunk_start(chunk + 1); s++)
+          counts[number_of_input_neurons + presynaptic_neuron_indices[s]]++;
+      });
+
+    // Exclusive prefix sum, neuron major and chunk minor, which keeps the sort stable
+    int offset = 0;
+    for (int n = 0; n < total_possible_pre_neurons; n++){
+      int start = offset;
+      for (int chunk = 0; chunk < number_of_chunks; chunk++){
+        int count = chunk_offsets[chunk][n];
+        chunk_offsets[chunk][n] = offset;
+        offset += count;
       }
-    }
-    
-    int* temp_presyn_array = (int*)malloc(total_number_of_synapses * sizeof(int));
-    int* temp_postsyn_array = (int*)malloc(total_number_of_synapses * sizeof(int));
-    float* temp_weight_array = (float*)malloc(total_number_of_synapses * sizeof(float));
-    float* temp_scaling_array = (float*)malloc(total_number_of_synapses * sizeof(float));
-    // Re-ordering arrays
-    for (int s=0; s < total_number_of_synapses; s++){
-      temp_presyn_array[s] = presynaptic_neuron_indices[synapse_sort_indices[s]];
-      temp_postsyn_array[s] = postsynaptic_neuron_indices[synapse_sort_indices[s]];
-      temp_weight_array[s] = synaptic_efficacies_or_weights[synapse_sort_indices[s]];
-      temp_scaling_array[s] = weight_scaling_constants[synapse_sort_indices[s]];
 
-      synapse_reversesort_indices[synapse_sort_indices[s]] = s;
+      bool is_input = (n < number_of_input_neurons);
+      Neurons* pre_neurons = is_input ? input_neurons : neurons;
+      int neuron_id = is_input ? CORRECTED_PRESYNAPTIC_ID(n - number_of_input_neurons, true) : (n - number_of_input_neurons);
+      pre_neurons->per_neuron_efferent_synapse_start[neuron_id] = start;
+      pre_neurons->per_neuron_efferent_synapse_count[neuron_id] = offset - start;
     }
 
-    free(presynaptic_neuron_indices);
-    free(postsynaptic_neuron_indices);
-    free(synaptic_efficacies_or_weights);
-    free(weight_scaling_constants);
+    parallel_for_blocks(number_of_chunks, [&](int chunk) {
+        std::vector<int>& positions = chunk_offsets[chunk];
+        for (int s = chunk_start(chunk); s < chunk_start(chunk + 1); s++){
+          int location = positions[number_of_input_neurons + presynaptic_neuron_indices[s]]++;
+          synapse_sort_indices[location] = s;
+          synapse_reversesort_indices[s] = location;
+        }
+      });
+    chunk_offsets.clear();
 
-    presynaptic_neuron_indices = temp_presyn_array;
-    postsynaptic_neuron_indices = temp_postsyn_array;
-    synaptic_efficacies_or_weights = temp_weight_array;
-    weight_scaling_constants = temp_scaling_array;
+    // Re-ordering arrays
+    std::vector<char> scratch;
+    sort_synapse_attributes(scratch);
 
     synapses_sorted = true;
   }
 }
 
+void Synapses::sort_synapse_attributes(std::vector<char>& scratch){
+  apply_synapse_sort(presynaptic_neuron_indices, scratch);
+  apply_synapse_sort(postsynaptic_neuron_indices, scratch);
+  apply_synapse_sort(synaptic_efficacies_or_weights, scratch);
+  apply_synapse_sort(weight_scaling_constants, scratch);
+  apply_synapse_sort(synapse_postsynaptic_neuron_count_index, scratch);
+}
+
 // Synapses Destructor
 Synapses::~Synapses() {
-  free(presynaptic_neuron_indices);
-  free(postsynaptic_neuron_indices);
-  free(synaptic_efficacies_or_weights);
-  free(synapse_postsynaptic_neuron_count_index);
-  free(synapse_sort_indices);
-  free(synapse_reversesort_indices);
-  free(weight_scaling_constants);
-
   delete random_state_manager;
 }
 
@@ -163,13 +184,30 @@ int Synapses::AddGroup(int presynaptic_group_id,
   }
 
 
+  if (cached_group) {
+    add_cached_group(neurons, input_neurons);
+    return finish_adding_group(synapse_params, prestart, poststart, presynaptic_group_is_input);
+  }
+
   int original_number_of_synapses = total_number_of_synapses;
+  // Numbers the random streams of the group
+  uint32_t group_number = last_index_of_synapse_per_group.size();
+
+  if (synapse_params->procedural_connectivity && (synapse_params->connectivity_type != CONNECTIVITY_TYPE_RANDOM))
+    print_message_and_exit("PROCEDURAL CONNECTION ERROR: Only CONNECTIVITY_TYPE_RANDOM groups can have procedural connectivity.");
 
   // Carry out the creation of the connectivity matrix
   switch (synapse_params->connectivity_type){
             
         case CONNECTIVITY_TYPE_ALL_TO_ALL:
           {
+            if (stores_weight_matrix(timestep, synapse_params)){
+              add_dense_group(synapse_params,
+                              prestart, preend, presynaptic_group_is_input,
+                              poststart, postend,
+                              group_number);
+              break;
+            }
             
             int increment = (preend-prestart)*(postend-poststart);
             Synapses::increment_number_of_synapses(increment);
@@ -203,23 +241,77 @@ int Synapses::AddGroup(int presynaptic_group_id,
           }
         case CONNECTIVITY_TYPE_RANDOM:
           {
+            if (synapse_params->procedural_connectivity){
+              add_procedural_group(synapse_params,
+                                   prestart, preend, presynaptic_group_is_input,
+                                   poststart, postend);
+              break;
+            }
             // If the connectivity is random
-            // Begin a count
-            for (int i = prestart; i < preend; i++){
-              for (int j = poststart; j < postend; j++){
-                // Probability of connection
-                float prob = ((float)rand() / (RAND_MAX));
-                // If it is within the probability range, connect!
-                if (prob < synapse_params->random_connectivity_probability){
-            
-                  Synapses::increment_number_of_synapses(1);
-
-                  // Setup Synapses
-                  presynaptic_neuron_indices[total_number_of_synapses - 1] = CORRECTED_PRESYNAPTIC_ID(i, presynaptic_group_is_input);
-                  postsynaptic_neuron_indices[total_number_of_synapses - 1] = j;
+            // The (pre x post) Bernoulli matrix is sampled in blocks of rows by
+            // jumping geometrically distributed gaps between connections. Each
+            // block has its own random stream, numbered by the group and the
+            // block, so the result does not depend on the number of threads.
+            // A first pass counts the synapses in each block, storage is
+            // allocated once and a second pass (which replays the same streams)
+            // fills it in.
+            float probability = synapse_params->random_connectivity_probability;
+            int number_of_presynaptic_neurons = preend - prestart;
+            int number_of_postsynaptic_neurons = postend - poststart;
+            const int rows_per_block = 64;
+            int number_of_blocks = (number_of_presynaptic_neurons + rows_per_block - 1) / rows_per_block;
+            double log_of_failure_probability = log1p(-(double)probability);
+
+            // Returns the number of synapses in a block, writing them if pre/post are given
+            auto sample_block = [&](int block, int* pre, int* post) {
+              long long count = 0;
+              if (probability <= 0.0f)
+                return count;
+              int first_row = block * rows_per_block;
+              int last_row = std::min(first_row + rows_per_block, number_of_presynaptic_neurons);
+              long long block_size = (long long)(last_row - first_row) * number_of_postsynaptic_neurons;
+              CounterRandom generator = host_random_stream(RANDOM_STREAM_CONNECTIVITY, group_number, block);
+              long long location = -1;
+              while (true) {
+                if (probability < 1.0f) {
+                  double uniform = generator.uniform_double();
+                  double gap = floor(log(uniform) / log_of_failure_probability);
+                  if (gap >= (double)(block_size - location))
+                    break;
+                  location += (long long)gap;
                 }
+                location++;
+                if (location >= block_size)
+                  break;
+                if (pre) {
+                  int i = first_row + (int)(location / number_of_postsynaptic_neurons);
+                  int j = (int)(location % number_of_postsynaptic_neurons);
+                  pre[count] = CORRECTED_PRESYNAPTIC_ID(prestart + i, presynaptic_group_is_input);
+                  post[count] = poststart + j;
+                }
+                count++;
               }
-            }
+              return count;
+            };
+
+            std::vector<long long> block_offsets(number_of_blocks + 1, 0);
+            parallel_for_blocks(number_of_blocks, [&](int block) {
+                block_offsets[block + 1] = sample_block(block, nullptr, nullptr);
+              });
+            for (int block = 0; block < number_of_blocks; block++)
+              block_offsets[block + 1] += block_offsets[block];
+
+            long long increment = block_offsets[number_of_blocks];
+            if (original_number_of_synapses + increment > INT_MAX)
+              print_message_and_exit("Synapse creation error. Too many synapses requested (Random).");
+            Synapses::increment_number_of_synapses((int)increment);
+
+            parallel_for_blocks(number_of_blocks, [&](int block) {
+                int offset = original_number_of_synapses + (int)block_offsets[block];
+                sample_block(block,
+                             presynaptic_neuron_indices + offset,
+                             postsynaptic_neuron_indices + offset);
+              });
             break;
           }
     
@@ -237,44 +329,133 @@ int Synapses::AddGroup(int presynaptic_group_id,
             int total_number_of_new_synapses = number_of_new_synapses_per_postsynaptic_neuron * number_of_postsynaptic_neurons_in_group;
             Synapses::increment_number_of_synapses(total_number_of_new_synapses);
 
-            for (int postid = 0; postid < number_of_postsynaptic_neurons_in_group; postid++){
-              float post_fractional_centre_x = ((float)(postid % postsynaptic_group_shape[0]) / (float)postsynaptic_group_shape[0]);
-              float post_fractional_centre_y = ((float)((float)postid / (float)postsynaptic_group_shape[1]) / (float)postsynaptic_group_shape[1]);
-              int pre_centre_x = presynaptic_group_shape[0] * post_fractional_centre_x;
-              int pre_centre_y = presynaptic_group_shape[1] * post_fractional_centre_y;
-
-              // Constructing the probability with which we should connect to each pre-synaptic neuron
-              std::vector<float> pre_neuron_probabilities;
-              std::vector<float> pre_neuron_indices;
-              float total_probability = 0.0;
-              for (int preid = 0; preid < number_of_presynaptic_neurons; preid++){
-                int pre_xcoord = preid % presynaptic_group_shape[0]; 
-                int pre_ycoord = preid / presynaptic_group_shape[0];
-                float probability_of_connection = expf(- (powf((pre_xcoord - pre_centre_x), 2.0)) / (2.0 * powf(standard_deviation_sigma, 2)));
-                probability_of_connection *= expf(- (powf((pre_ycoord - pre_centre_y), 2.0)) / (2.0 * powf(standard_deviation_sigma, 2)));
-                pre_neuron_probabilities.push_back(probability_of_connection);
-                pre_neuron_indices.push_back(preid);
-                total_probability += probability_of_connection;
-              }
-              
-              for (int i=0; i < number_of_new_synapses_per_postsynaptic_neuron; i++){
-                postsynaptic_neuron_indices[original_number_of_synapses + postid*number_of_new_synapses_per_postsynaptic_neuron + i] = poststart + postid;
-                float randval = total_probability*((float)rand() / (RAND_MAX));
-                float probability_trace = 0.0;
-                for (int preloc = 0; preloc < pre_neuron_probabilities.size(); preloc++){
-                  if ((randval > probability_trace) && (randval < (probability_trace + pre_neuron_probabilities[preloc]))){
-                    int chosenpreid = CORRECTED_PRESYNAPTIC_ID(pre_neuron_indices[preloc] + prestart, presynaptic_group_is_input);
-                    presynaptic_neuron_indices[original_number_of_synapses + postid*number_of_new_synapses_per_postsynaptic_neuron + i] = chosenpreid;
-                    total_probability -= pre_neuron_probabilities[preloc];
-                    pre_neuron_indices.erase(pre_neuron_indices.begin() + preloc);
-                    pre_neuron_probabilities.erase(pre_neuron_probabilities.begin() + preloc);
-                    break;
-                  } else {
-                    probability_trace += pre_neuron_probabilities[preloc];
+            // Presynaptic neurons are drawn without replacement with probability
+            // proportional to their (separable) Gaussian weight. Only neurons
+            // within a window of a few standard deviations around the centre
+            // are considered. Outside of it the weights are below float
+            // precision relative to the centre, so this is the same
+            // distribution as sampling over the whole group. Weights are held
+            // in a Fenwick tree so that each draw and removal is O(log n).
+            int pre_width = presynaptic_group_shape[0];
+            int pre_height = presynaptic_group_shape[1];
+            int window_radius = (int)ceil(synapse_params->gaussian_synapses_window_in_standard_deviations * standard_deviation_sigma);
+            if ((window_radius < 0) || (window_radius > std::max(pre_width, pre_height)))
+              window_radius = std::max(pre_width, pre_height);
+            double two_sigma_squared = 2.0 * (double)standard_deviation_sigma * (double)standard_deviation_sigma;
+
+            // Postsynaptic neurons are handled in blocks, each with the random
+            // stream numbered by the group and the block
+            const int posts_per_block = 64;
+            int number_of_blocks = (number_of_postsynaptic_neurons_in_group + posts_per_block - 1) / posts_per_block;
+
+            parallel_for_blocks(number_of_blocks, [&](int block) {
+              CounterRandom generator = host_random_stream(RANDOM_STREAM_CONNECTIVITY, group_number, block);
+              std::vector<double> x_weights, y_weights, weights, tree;
+              std::vector<int> candidates;
+
+              int first_post = block * posts_per_block;
+              int last_post = std::min(first_post + posts_per_block, number_of_postsynaptic_neurons_in_group);
+              for (int postid = first_post; postid < last_post; postid++){
+                float post_fractional_centre_x = ((float)(postid % postsynaptic_group_shape[0]) / (float)postsynaptic_group_shape[0]);
+                float post_fractional_centre_y = ((float)((float)postid / (float)postsynaptic_group_shape[1]) / (float)postsynaptic_group_shape[1]);
+                int pre_centre_x = presynaptic_group_shape[0] * post_fractional_centre_x;
+                int pre_centre_y = presynaptic_group_shape[1] * post_fractional_centre_y;
+
+                // Fall back to the whole group if the window is too small
+                int radius = window_radius;
+                int xmin, xmax, ymin, ymax;
+                while (true) {
+                  xmin = std::max(0, pre_centre_x - radius);
+                  xmax = std::min(pre_width - 1, pre_centre_x + radius);
+                  ymin = std::max(0, pre_centre_y - radius);
+                  ymax = std::min(pre_height - 1, pre_centre_y + radius);
+                  if ((xmax < xmin) || (ymax < ymin) || ((xmax - xmin + 1)*(ymax - ymin + 1) < number_of_new_synapses_per_postsynaptic_neuron)) {
+                    if (radius >= std::max(pre_width, pre_height) + std::max(abs(pre_centre_x), abs(pre_centre_y)))
+                      print_message_and_exit("Synapse creation error. Not enough pre-synaptic neurons to sample from (Gaussian Sampling).");
+                    radius = 2*radius + 1;
+                    continue;
+                  }
+                  break;
+                }
+
+                // Constructing the probability with which we should connect to each pre-synaptic neuron
+                x_weights.resize(xmax - xmin + 1);
+                for (int x = xmin; x <= xmax; x++)
+                  x_weights[x - xmin] = exp(-(double)((x - pre_centre_x)*(x - pre_centre_x)) / two_sigma_squared);
+                y_weights.resize(ymax - ymin + 1);
+                for (int y = ymin; y <= ymax; y++)
+                  y_weights[y - ymin] = exp(-(double)((y - pre_centre_y)*(y - pre_centre_y)) / two_sigma_squared);
+
+                int number_of_candidates = (xmax - xmin + 1)*(ymax - ymin + 1);
+                candidates.resize(number_of_candidates);
+                weights.resize(number_of_candidates);
+                int remaining_candidates = 0;
+                int c = 0;
+                for (int y = ymin; y <= ymax; y++){
+                  for (int x = xmin; x <= xmax; x++){
+                    candidates[c] = y*pre_width + x;
+                    weights[c] = x_weights[x - xmin] * y_weights[y - ymin];
+                    if (weights[c] > 0.0)
+                      remaining_candidates++;
+                    c++;
+                  }
+                }
+                auto build_tree = [&]() {
+                  tree.assign(number_of_candidates + 1, 0.0);
+                  for (int i = 1; i <= number_of_candidates; i++){
+                    tree[i] += weights[i - 1];
+                    int parent = i + (i & -i);
+                    if (parent <= number_of_candidates)
+                      tree[parent] += tree[i];
+                  }
+                };
+                build_tree();
+                int highest_step = 1;
+                while ((highest_step << 1) <= number_of_candidates)
+                  highest_step <<= 1;
+
+                for (int i=0; i < number_of_new_synapses_per_postsynaptic_neuron; i++){
+                  int synapse_index = original_number_of_synapses + postid*number_of_new_synapses_per_postsynaptic_neuron + i;
+                  postsynaptic_neuron_indices[synapse_index] = poststart + postid;
+
+                  if (remaining_candidates == 0)
+                    print_message_and_exit("Synapse creation error. Gaussian weights too small to sample from (Gaussian Sampling).");
+                  double total_probability = 0.0;
+                  for (int node = number_of_candidates; node > 0; node -= (node & -node))
+                    total_probability += tree[node];
+
+                  int chosen = -1;
+                  while (chosen < 0) {
+                    // Uniform in [0, total_probability)
+                    double randval = total_probability * (1.0 - generator.uniform_double());
+                    int location = 0;
+                    for (int step = highest_step; step > 0; step >>= 1){
+                      if ((location + step <= number_of_candidates) && (tree[location + step] <= randval)){
+                        location += step;
+                        randval -= tree[location];
+                      }
+                    }
+                    // Rounding can land on an exhausted entry, draw again if so.
+                    // The rounding left by removals can outweigh the remaining
+                    // weights (small deviations), so the sums are rebuilt first.
+                    if ((location < number_of_candidates) && (weights[location] > 0.0))
+                      chosen = location;
+                    else {
+                      build_tree();
+                      total_probability = 0.0;
+                      for (int node = number_of_candidates; node > 0; node -= (node & -node))
+                        total_probability += tree[node];
+                    }
                   }
+
+                  presynaptic_neuron_indices[synapse_index] = CORRECTED_PRESYNAPTIC_ID(candidates[chosen] + prestart, presynaptic_group_is_input);
+                  remaining_candidates--;
+                  for (int node = chosen + 1; node <= number_of_candidates; node += (node & -node))
+                    tree[node] -= weights[chosen];
+                  weights[chosen] = 0.0;
                 }
               }
-            }
+            });
 
             if (total_number_of_new_synapses > largest_synapse_group_size) {
               largest_synapse_group_size = total_number_of_new_synapses;
@@ -308,6 +489,14 @@ int Synapses::AddGroup(int presynaptic_group_id,
 
       break;
     }
+    case CONNECTIVITY_TYPE_CONVOLUTIONAL:
+    {
+      add_convolutional_group(synapse_params,
+                              prestart, presynaptic_group_shape, presynaptic_group_is_input,
+                              poststart, postsynaptic_group_shape,
+                              group_number);
+      break;
+    }
     default:
     {
       print_message_and_exit("Unknown Connection Type.");
@@ -319,17 +508,25 @@ int Synapses::AddGroup(int presynaptic_group_id,
 
   if (print_synapse_group_details == true) printf("%d new synapses added.\n\n", temp_number_of_synapses_in_last_group);
 
+  // Each weight is its synapse's number of the group's weight stream, so they are drawn in parallel
+  float weight_range_bottom = synapse_params->weight_range[0];
+  float weight_range_top = synapse_params->weight_range[1];
+  CounterRandom weight_stream = host_random_stream(RANDOM_STREAM_WEIGHTS, group_number);
+  const int synapses_per_block = 65536;
+  parallel_for_blocks((temp_number_of_synapses_in_last_group + synapses_per_block - 1) / synapses_per_block, [&](int block) {
+      int first = block * synapses_per_block;
+      int last = std::min(first + synapses_per_block, temp_number_of_synapses_in_last_group);
+      for (int s = first; s < last; s++){
+        float weight = weight_range_bottom;
+        if (weight_range_top != weight_range_bottom)
+          weight = weight_range_bottom + (weight_range_top - weight_range_bottom)*weight_stream.uniform_float_at(s);
+        synaptic_efficacies_or_weights[original_number_of_synapses + s] = weight;
+      }
+    });
+
   for (int i = original_number_of_synapses; i < total_number_of_synapses; i++){
           
           weight_scaling_constants[i] = synapse_params->weight_scaling_constant;
-    
-          float weight_range_bottom = synapse_params->weight_range[0];
-          float weight_range_top = synapse_params->weight_range[1];
-
-          float weight = weight_range_bottom;
-          if (weight_range_top != weight_range_bottom)
-      weight = weight_range_bottom + (weight_range_top - weight_range_bottom)*((float)rand() / (RAND_MAX));
-          synaptic_efficacies_or_weights[i] = weight;
 
     if (synapse_params->connectivity_type == CONNECTIVITY_TYPE_PAIRWISE){
       if (synapse_params->pairwise_connect_weight.size() == temp_number_of_synapses_in_last_group){
@@ -341,7 +538,7 @@ int Synapses::AddGroup(int presynaptic_group_id,
 
           // Used for event count
           // printf("postsynaptic_neuron_indices[i]: %d\n", postsynaptic_neuron_indices[i]);
-          synapse_postsynaptic_neuron_count_index[postsynaptic_neuron_indices[i]] = neurons->per_neuron_afferent_synapse_count[postsynaptic_neuron_indices[i]];
+          synapse_postsynaptic_neuron_count_index[i] = neurons->per_neuron_afferent_synapse_count[postsynaptic_neuron_indices[i]];
           neurons->per_neuron_afferent_synapse_count[postsynaptic_neuron_indices[i]] ++;
 
     if (neurons->per_neuron_afferent_synapse_count[postsynaptic_neuron_indices[i]] > maximum_number_of_afferent_synapses)
@@ -357,6 +554,232 @@ int Synapses::AddGroup(int presynaptic_group_id,
     synapse_reversesort_indices[i] = i;
   }
 
+  return finish_adding_group(synapse_params, prestart, poststart, presynaptic_group_is_input);
+}
+
+
+void Synapses::add_cached_group(Neurons* neurons, Neurons* input_neurons) {
+  int original_number_of_synapses = total_number_of_synapses;
+  size_t bytes;
+  cached_group->data("group/column/0", bytes);
+  int number_of_new_synapses = bytes / synapse_store.column_element_size(0);
+  increment_number_of_synapses(number_of_new_synapses);
+  for (int c = 0; c < synapse_store.number_of_columns(); c++){
+    size_t element_size = synapse_store.column_element_size(c);
+    cached_group->read("group/column/" + std::to_string(c),
+                       (char*)synapse_store.column_data(c) + (size_t)original_number_of_synapses*element_size,
+                       (size_t)number_of_new_synapses*element_size);
+  }
+  neurons->Neurons::load_state(*cached_group, "neurons");
+  if (input_neurons)
+    input_neurons->Neurons::load_state(*cached_group, "input_neurons");
+  maximum_number_of_afferent_synapses = cached_group->read_value<int>("group/maximum_number_of_afferent_synapses");
+  largest_synapse_group_size = cached_group->read_value<int>("group/largest_synapse_group_size");
+  temp_number_of_synapses_in_last_group = number_of_new_synapses;
+
+  if (print_synapse_group_details == true) printf("%d new synapses added (from the connectivity cache).\n\n", temp_number_of_synapses_in_last_group);
+}
+
+
+bool Synapses::stores_weight_matrix(float timestep, synapse_parameters_struct * synapse_params) {
+  if ((synapse_params->connectivity_type != CONNECTIVITY_TYPE_ALL_TO_ALL) || !synapse_params->all_to_all_weight_matrix)
+    return false;
+  for (Plasticity* plasticity_ptr : synapse_params->plasticity_vec)
+    if (plasticity_ptr != nullptr)
+      return false;
+  return true;
+}
+
+
+void Synapses::add_dense_group(synapse_parameters_struct * synapse_params,
+                               int prestart, int preend, bool presynaptic_group_is_input,
+                               int poststart, int postend,
+                               uint32_t group_number) {
+  dense_synapse_group group;
+  group.group_id = last_index_of_synapse_per_group.size();
+  group.presynaptic_group_is_input = presynaptic_group_is_input;
+  group.presynaptic_start = prestart;
+  group.number_of_presynaptic_neurons = preend - prestart;
+  group.postsynaptic_start = poststart;
+  group.number_of_postsynaptic_neurons = postend - poststart;
+  group.delay = 1;
+  group.syn_label = 0;
+  group.weight_scaling_constant = synapse_params->weight_scaling_constant;
+
+  // The weights the synapses would have if stored, from the same stream positions
+  float weight_range_bottom = synapse_params->weight_range[0];
+  float weight_range_top = synapse_params->weight_range[1];
+  CounterRandom weight_stream = host_random_stream(RANDOM_STREAM_WEIGHTS, group_number);
+  long long number_of_synapses = group.number_of_synapses();
+  group.weights.resize(number_of_synapses);
+  const int synapses_per_block = 65536;
+  parallel_for_blocks((int)((number_of_synapses + synapses_per_block - 1) / synapses_per_block), [&](int block) {
+      long long first = (long long)block * synapses_per_block;
+      long long last = std::min(first + synapses_per_block, number_of_synapses);
+      for (long long s = first; s < last; s++){
+        float weight = weight_range_bottom;
+        if (weight_range_top != weight_range_bottom)
+          weight = weight_range_bottom + (weight_range_top - weight_range_bottom)*weight_stream.uniform_float_at(s);
+        group.weights[s] = weight;
+      }
+    });
+  dense_groups.push_back(std::move(group));
+
+  if (print_synapse_group_details == true) printf("Dense group of %lld synapses (stored as a weight matrix).\n", number_of_synapses);
+}
+
+
+void Synapses::add_convolutional_group(synapse_parameters_struct * synapse_params,
+                                       int prestart, int* presynaptic_group_shape, bool presynaptic_group_is_input,
+                                       int poststart, int* postsynaptic_group_shape,
+                                       uint32_t group_number) {
+  for (Plasticity* plasticity_ptr : synapse_params->plasticity_vec)
+    if (plasticity_ptr != nullptr)
+      print_message_and_exit("CONVOLUTIONAL CONNECTION ERROR: Plasticity is not supported on convolutional groups.");
+
+  convolutional_synapse_group group;
+  group.group_id = last_index_of_synapse_per_group.size();
+  group.presynaptic_group_is_input = presynaptic_group_is_input;
+  group.presynaptic_start = prestart;
+  group.postsynaptic_start = poststart;
+  for (int d = 0; d < 2; d++){
+    group.presynaptic_shape[d] = presynaptic_group_shape[d];
+    group.postsynaptic_shape[d] = postsynaptic_group_shape[d];
+    group.kernel_shape[d] = synapse_params->convolution_kernel_shape[d];
+    group.stride[d] = synapse_params->convolution_stride[d];
+    group.padding[d] = synapse_params->convolution_padding[d];
+    if ((group.kernel_shape[d] < 1) || (group.stride[d] < 1) || (group.padding[d] < 0))
+      print_message_and_exit("CONVOLUTIONAL CONNECTION ERROR: Kernel shape and stride must be positive and padding not negative.");
+    int output_size = (group.presynaptic_shape[d] + 2*group.padding[d] - group.kernel_shape[d]) / group.stride[d] + 1;
+    if ((group.presynaptic_shape[d] + 2*group.padding[d] < group.kernel_shape[d]) || (output_size != group.postsynaptic_shape[d])){
+      std::cerr << "CONVOLUTIONAL CONNECTION ERROR: The postsynaptic group shape must be the output shape of the convolution (dimension " << d << ": " << output_size << ")." << std::endl;
+      exit(1);
+    }
+  }
+  group.delay = 1;
+  group.syn_label = 0;
+  group.weight_scaling_constant = synapse_params->weight_scaling_constant;
+
+  int kernel_size = group.kernel_shape[0]*group.kernel_shape[1];
+  if (synapse_params->convolution_kernel_weights.size() > 0){
+    if (synapse_params->convolution_kernel_weights.size() != kernel_size)
+      print_message_and_exit("CONVOLUTIONAL CONNECTION ERROR: Kernel weight vector length not as expected. Should be kernel_shape[0]*kernel_shape[1].");
+    group.kernel_weights = synapse_params->convolution_kernel_weights;
+  } else {
+    float weight_range_bottom = synapse_params->weight_range[0];
+    float weight_range_top = synapse_params->weight_range[1];
+    CounterRandom weight_stream = host_random_stream(RANDOM_STREAM_WEIGHTS, group_number);
+    group.kernel_weights.resize(kernel_size);
+    for (int k = 0; k < kernel_size; k++){
+      group.kernel_weights[k] = weight_range_bottom;
+      if (weight_range_top != weight_range_bottom)
+        group.kernel_weights[k] = weight_range_bottom + (weight_range_top - weight_range_bottom)*weight_stream.uniform_float_at(k);
+    }
+  }
+  convolutional_groups.push_back(group);
+
+  if (print_synapse_group_details == true) printf("Convolutional group of %lld synapses (not stored).\n", group.number_of_synapses());
+}
+
+
+void Synapses::add_procedural_group(synapse_parameters_struct * synapse_params,
+                                    int prestart, int preend, bool presynaptic_group_is_input,
+                                    int poststart, int postend) {
+  for (Plasticity* plasticity_ptr : synapse_params->plasticity_vec)
+    if (plasticity_ptr != nullptr)
+      print_message_and_exit("PROCEDURAL CONNECTION ERROR: Plasticity is not supported on procedural groups.");
+
+  procedural_synapse_group group;
+  group.group_id = last_index_of_synapse_per_group.size();
+  group.presynaptic_group_is_input = presynaptic_group_is_input;
+  group.presynaptic_start = prestart;
+  group.number_of_presynaptic_neurons = preend - prestart;
+  group.postsynaptic_start = poststart;
+  group.number_of_postsynaptic_neurons = postend - poststart;
+  group.probability = synapse_params->random_connectivity_probability;
+  group.weight_range[0] = synapse_params->weight_range[0];
+  group.weight_range[1] = synapse_params->weight_range[1];
+  group.weight_scaling_constant = synapse_params->weight_scaling_constant;
+  group.delay_range[0] = 1;
+  group.delay_range[1] = 1;
+  group.syn_label = 0;
+  group.seed = host_random_seed();
+  procedural_groups.push_back(group);
+
+  if (print_synapse_group_details == true) printf("Procedural group of about %.0f synapses (not stored).\n", group.expected_number_of_synapses());
+}
+
+
+double procedural_synapse_group::expected_number_of_synapses() const {
+  return (double)number_of_presynaptic_neurons*number_of_postsynaptic_neurons*std::min(std::max(probability, 0.0f), 1.0f);
+}
+
+
+long long dense_synapse_group::number_of_synapses() const {
+  return (long long)number_of_presynaptic_neurons*number_of_postsynaptic_neurons;
+}
+
+
+long long convolutional_synapse_group::number_of_synapses() const {
+  long long count = 0;
+  for (int pre = 0; pre < presynaptic_shape[0]*presynaptic_shape[1]; pre++)
+    for_each_target(pre, [&](int post, int kernel_index) { count++; });
+  return count;
+}
+
+
+void Synapses::save_last_group(CheckpointWriter& cache, Neurons* neurons, Neurons* input_neurons) {
+  int first_synapse = total_number_of_synapses - temp_number_of_synapses_in_last_group;
+  for (int c = 0; c < synapse_store.number_of_columns(); c++){
+    size_t element_size = synapse_store.column_element_size(c);
+    cache.write("group/column/" + std::to_string(c),
+                (char*)synapse_store.column_data(c) + (size_t)first_synapse*element_size,
+                (size_t)temp_number_of_synapses_in_last_group*element_size);
+  }
+  neurons->Neurons::save_state(cache, "neurons");
+  if (input_neurons)
+    input_neurons->Neurons::save_state(cache, "input_neurons");
+  cache.write_value("group/maximum_number_of_afferent_synapses", maximum_number_of_afferent_synapses);
+  cache.write_value("group/largest_synapse_group_size", largest_synapse_group_size);
+}
+
+
+void Synapses::add_group_parameters_to_hash(ContentHash& hash,
+                                            int presynaptic_group_id,
+                                            int postsynaptic_group_id,
+                                            float timestep,
+                                            synapse_parameters_struct * synapse_params) {
+  hash.add_value(presynaptic_group_id);
+  hash.add_value(postsynaptic_group_id);
+  hash.add_value(synapse_params->connectivity_type);
+  hash.add_value(synapse_params->weight_range[0]);
+  hash.add_value(synapse_params->weight_range[1]);
+  hash.add_value(synapse_params->weight_scaling_constant);
+  switch (synapse_params->connectivity_type){
+    case CONNECTIVITY_TYPE_RANDOM:
+      hash.add_value(synapse_params->random_connectivity_probability);
+      break;
+    case CONNECTIVITY_TYPE_GAUSSIAN_SAMPLE:
+      hash.add_value(synapse_params->gaussian_synapses_per_postsynaptic_neuron);
+      hash.add_value(synapse_params->gaussian_synapses_standard_deviation);
+      hash.add_value(synapse_params->gaussian_synapses_window_in_standard_deviations);
+      break;
+    case CONNECTIVITY_TYPE_PAIRWISE:
+      hash.add_vector(synapse_params->pairwise_connect_presynaptic);
+      hash.add_vector(synapse_params->pairwise_connect_postsynaptic);
+      hash.add_vector(synapse_params->pairwise_connect_weight);
+      break;
+    case CONNECTIVITY_TYPE_CONVOLUTIONAL:
+      hash.add(synapse_params->convolution_kernel_shape, sizeof(synapse_params->convolution_kernel_shape));
+      hash.add(synapse_params->convolution_stride, sizeof(synapse_params->convolution_stride));
+      hash.add(synapse_params->convolution_padding, sizeof(synapse_params->convolution_padding));
+      hash.add_vector(synapse_params->convolution_kernel_weights);
+      break;
+  }
+}
+
+
+int Synapses::finish_adding_group(synapse_parameters_struct * synapse_params, int prestart, int poststart, bool presynaptic_group_is_input) {
   // SETTING UP PLASTICITY
   int plasticity_id = -1;
   int original_num_plasticity_indices = 0;
@@ -392,50 +815,25 @@ int Synapses::AddGroup(int presynaptic_group_id,
   last_index_of_synapse_per_group.push_back(total_number_of_synapses);
 
   return(last_index_of_synapse_per_group.size() - 1);
-
 }
 
 
 void Synapses::increment_number_of_synapses(int increment) {
 
   total_number_of_synapses += increment;
+  synapse_store.resize(total_number_of_synapses);
 
-  if (total_number_of_synapses - increment == 0) {
-          presynaptic_neuron_indices = (int*)malloc(total_number_of_synapses * sizeof(int));
-          postsynaptic_neuron_indices = (int*)malloc(total_number_of_synapses * sizeof(int));
-          synaptic_efficacies_or_weights = (float*)malloc(total_number_of_synapses * sizeof(float));
-          weight_scaling_constants = (float*)malloc(total_number_of_synapses * sizeof(float));
-          synapse_postsynaptic_neuron_count_index = (int*)malloc(total_number_of_synapses * sizeof(int));
-          synapse_sort_indices = (int*)malloc(total_number_of_synapses * sizeof(int));
-          synapse_reversesort_indices = (int*)malloc(total_number_of_synapses * sizeof(int));
-  } else {
-    int* temp_presynaptic_neuron_indices = (int*)realloc(presynaptic_neuron_indices, total_number_of_synapses * sizeof(int));
-    int* temp_postsynaptic_neuron_indices = (int*)realloc(postsynaptic_neuron_indices, total_number_of_synapses * sizeof(int));
-    float* temp_synaptic_efficacies_or_weights = (float*)realloc(synaptic_efficacies_or_weights, total_number_of_synapses * sizeof(float));
-    int* temp_synapse_postsynaptic_neuron_count_index = (int*)realloc(synapse_postsynaptic_neuron_count_index, total_number_of_synapses * sizeof(int));
-    float* temp_weight_scaling_constants = (float*)realloc(weight_scaling_constants, total_number_of_synapses * sizeof(float));
-    int* temp_sort_indices = (int*)realloc(synapse_sort_indices, total_number_of_synapses * sizeof(int));
-    int* temp_revsort_indices = (int*)realloc(synapse_reversesort_indices, total_number_of_synapses * sizeof(int));
-
-    if (temp_presynaptic_neuron_indices != nullptr) presynaptic_neuron_indices = temp_presynaptic_neuron_indices;
-    if (temp_postsynaptic_neuron_indices != nullptr) postsynaptic_neuron_indices = temp_postsynaptic_neuron_indices;
-    if (temp_synaptic_efficacies_or_weights != nullptr) synaptic_efficacies_or_weights = temp_synaptic_efficacies_or_weights;
-    if (temp_synapse_postsynaptic_neuron_count_index != nullptr) synapse_postsynaptic_neuron_count_index = temp_synapse_postsynaptic_neuron_count_index;
-    if (temp_weight_scaling_constants != nullptr) weight_scaling_constants = temp_weight_scaling_constants;
-    if (temp_sort_indices != nullptr) synapse_sort_indices = temp_sort_indices;
-    if (temp_revsort_indices != nullptr) synapse_reversesort_indices = temp_revsort_indices;
-  }
+}
+
+void Synapses::reserve(int number_of_synapses) {
+  synapse_store.reserve(number_of_synapses);
+}
 
+void Synapses::shrink_to_fit() {
+  synapse_store.shrink_to_fit();
 }
 
 void Synapses::save_connectivity_as_txt(std::string path, std::string prefix, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
   int precorrection = 0;
   int postcorrection = 0;
   bool presynaptic_group_is_input = false;
@@ -456,14 +854,23 @@ void Synapses::save_connectivity_as_txt(std::string path, std::string prefix, in
     backend()->copy_to_frontend();
 
   // Send data to file
-  for (int i = startid; i < endid; i++){
-    if (synapsegroupid >= 0)
-      preidfile << CORRECTED_PRESYNAPTIC_ID(presynaptic_neuron_indices[synapse_reversesort_indices[i]], presynaptic_group_is_input) - precorrection << std::endl;
-    else 
-      preidfile << presynaptic_neuron_indices[synapse_reversesort_indices[i]] << std::endl;
-    postidfile << postsynaptic_neuron_indices[synapse_reversesort_indices[i]] - postcorrection << std::endl;
-    weightfile << synaptic_efficacies_or_weights[synapse_reversesort_indices[i]] << std::endl;
-  }
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){
+      if (synapsegroupid >= 0)
+        preidfile << CORRECTED_PRESYNAPTIC_ID(presynaptic_neuron_indices[synapse_id], presynaptic_group_is_input) - precorrection << std::endl;
+      else 
+        preidfile << presynaptic_neuron_indices[synapse_id] << std::endl;
+      postidfile << postsynaptic_neuron_indices[synapse_id] - postcorrection << std::endl;
+      weightfile << synaptic_efficacies_or_weights[synapse_id] << std::endl;
+    },
+    [&](dense_synapse_group& group, int pre, int post){
+      if (synapsegroupid >= 0)
+        preidfile << group.presynaptic_start + pre - precorrection << std::endl;
+      else
+        preidfile << CORRECTED_PRESYNAPTIC_ID(group.presynaptic_start + pre, group.presynaptic_group_is_input) << std::endl;
+      postidfile << group.postsynaptic_start + post - postcorrection << std::endl;
+      weightfile << group.weight(pre, post) << std::endl;
+    });
 
   // Close files
   preidfile.close();
@@ -473,13 +880,6 @@ void Synapses::save_connectivity_as_txt(std::string path, std::string prefix, in
 };
 // Ensure copied from device, then send
 void Synapses::save_connectivity_as_binary(std::string path, std::string prefix, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
   int precorrection = 0;
   int postcorrection = 0;
   bool presynaptic_group_is_input = false;
@@ -502,23 +902,29 @@ void Synapses::save_connectivity_as_binary(std::string path, std::string prefix,
   // Send data to file
   int preid, postid;
   float weight;
-  for (int i = startid; i < endid; i++){
-    if (synapsegroupid >= 0)
-      preid = CORRECTED_PRESYNAPTIC_ID(presynaptic_neuron_indices[synapse_reversesort_indices[i]], presynaptic_group_is_input) - precorrection;
-    else
-      preid = presynaptic_neuron_indices[synapse_reversesort_indices[i]];
-    postid = postsynaptic_neuron_indices[synapse_reversesort_indices[i]] - postcorrection;
-    weight = synaptic_efficacies_or_weights[synapse_reversesort_indices[i]];
-    preidfile.write((char *)&preid, sizeof(int));
-    postidfile.write((char *)&postid, sizeof(int));
-    weightfile.write((char *)&weight, sizeof(float));
-  }
-  /*
-  // Send data to file
-  preidfile.write((char *)&presynaptic_neuron_indices[startid], (endid - startid)*sizeof(int));
-  postidfile.write((char *)&postsynaptic_neuron_indices[startid], (endid - startid)*sizeof(int));
-  */
-  //weightfile.write((char *)&synaptic_efficacies_or_weights[startid], (endid - startid)*sizeof(float));
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){
+      if (synapsegroupid >= 0)
+        preid = CORRECTED_PRESYNAPTIC_ID(presynaptic_neuron_indices[synapse_id], presynaptic_group_is_input) - precorrection;
+      else
+        preid = presynaptic_neuron_indices[synapse_id];
+      postid = postsynaptic_neuron_indices[synapse_id] - postcorrection;
+      weight = synaptic_efficacies_or_weights[synapse_id];
+      preidfile.write((char *)&preid, sizeof(int));
+      postidfile.write((char *)&postid, sizeof(int));
+      weightfile.write((char *)&weight, sizeof(float));
+    },
+    [&](dense_synapse_group& group, int pre, int post){
+      if (synapsegroupid >= 0)
+        preid = group.presynaptic_start + pre - precorrection;
+      else
+        preid = CORRECTED_PRESYNAPTIC_ID(group.presynaptic_start + pre, group.presynaptic_group_is_input);
+      postid = group.postsynaptic_start + post - postcorrection;
+      weight = group.weight(pre, post);
+      preidfile.write((char *)&preid, sizeof(int));
+      postidfile.write((char *)&postid, sizeof(int));
+      weightfile.write((char *)&weight, sizeof(float));
+    });
 
   // Close files
   preidfile.close();
@@ -528,61 +934,57 @@ void Synapses::save_connectivity_as_binary(std::string path, std::string prefix,
 
 // Load Network??
 //void Synapses::load_connectivity_from_txt(std::string path, std::string prefix);
-//void Synapses::load_connectivity_from_binary(std::string path, std::string prefix);
 
 void Synapses::save_weights_as_txt(std::string path, std::string prefix, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
-
   std::ofstream weightfile;
   if (_backend)
     backend()->copy_to_frontend();
   weightfile.open((path + "/" + prefix + "SynapticWeights.txt"), std::ios::out | std::ios::binary);
-  for (int i = startid; i < endid; i++){
-    weightfile << synaptic_efficacies_or_weights[synapse_reversesort_indices[i]] << std::endl;
-  }
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){ weightfile << synaptic_efficacies_or_weights[synapse_id] << std::endl; },
+    [&](dense_synapse_group& group, int pre, int post){ weightfile << group.weight(pre, post) << std::endl; });
+  for (auto& group : convolutional_groups)
+    if ((synapsegroupid < 0) || (group.group_id == synapsegroupid))
+      for (float weight : group.kernel_weights)
+        weightfile << weight << std::endl;
   weightfile.close();
 }
 
 void Synapses::save_weights_as_binary(std::string path, std::string prefix, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
-
   std::ofstream weightfile;
   if (_backend)
     backend()->copy_to_frontend();
   weightfile.open((path + "/" + prefix + "SynapticWeights.bin"), std::ios::out | std::ios::binary);
-  for (int i = startid; i < endid; i++){
-    weightfile.write((char *)&synaptic_efficacies_or_weights[synapse_reversesort_indices[i]], sizeof(float));
-  }
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){ weightfile.write((char *)&synaptic_efficacies_or_weights[synapse_id], sizeof(float)); },
+    [&](dense_synapse_group& group, int pre, int post){ weightfile.write((char *)&group.weight(pre, post), sizeof(float)); });
+  for (auto& group : convolutional_groups)
+    if ((synapsegroupid < 0) || (group.group_id == synapsegroupid))
+      weightfile.write((char *)group.kernel_weights.data(), group.kernel_weights.size()*sizeof(float));
   
   weightfile.close();
 }
 
 
 void Synapses::load_weights(std::vector<float> weights, int synapsegroupid){
-  int startid = 0;
-  int endid = total_number_of_synapses;
-  if (synapsegroupid >= 0)
-    endid = last_index_of_synapse_per_group[synapsegroupid];
-  if ((synapsegroupid > 0) && (synapsegroupid < last_index_of_synapse_per_group.size())){
-    startid = last_index_of_synapse_per_group[synapsegroupid - 1];
-  }
-
-  if (weights.size() == (endid - startid)){
-    for (int i = startid; i < endid; i++){
-      synaptic_efficacies_or_weights[synapse_reversesort_indices[i]] = weights[i - startid];
-    }
+  size_t number_of_weights = 0;
+  for_each_synapse(synapsegroupid,
+    [&](int synapse_id){ number_of_weights++; },
+    [&](dense_synapse_group& group, int pre, int post){ number_of_weights++; });
+  for (auto& group : convolutional_groups)
+    if ((synapsegroupid < 0) || (group.group_id == synapsegroupid))
+      number_of_weights += group.kernel_weights.size();
+
+  if (weights.size() == number_of_weights){
+    size_t index = 0;
+    for_each_synapse(synapsegroupid,
+      [&](int synapse_id){ synaptic_efficacies_or_weights[synapse_id] = weights[index++]; },
+      [&](dense_synapse_group& group, int pre, int post){ group.weight(pre, post) = weights[index++]; });
+    for (auto& group : convolutional_groups)
+      if ((synapsegroupid < 0) || (group.group_id == synapsegroupid)){
+        std::copy(weights.begin() + index, weights.begin() + index + group.kernel_weights.size(), group.kernel_weights.begin());
+        index += group.kernel_weights.size();
+      }
   } else {
     print_message_and_exit("Number of weights loading not equal to number of synapses!!");
   }
@@ -622,4 +1024,178 @@ void Synapses::load_weights_from_binary(std::string filepath, int synapsegroupid
 }
 
 
+
+void Synapses::save_state(CheckpointWriter& checkpoint, const std::string& prefix) {
+  checkpoint.write_value(prefix + "/total_number_of_synapses", total_number_of_synapses);
+  checkpoint.write_value(prefix + "/temp_number_of_synapses_in_last_group", temp_number_of_synapses_in_last_group);
+  checkpoint.write_value(prefix + "/largest_synapse_group_size", largest_synapse_group_size);
+  checkpoint.write_value(prefix + "/maximum_number_of_afferent_synapses", maximum_number_of_afferent_synapses);
+  checkpoint.write_value(prefix + "/synapses_sorted", synapses_sorted);
+  checkpoint.write_vector(prefix + "/last_index_of_synapse_per_group", last_index_of_synapse_per_group);
+  std::vector<char> prepop_is_input_values(prepop_is_input.begin(), prepop_is_input.end());
+  checkpoint.write_vector(prefix + "/prepop_is_input", prepop_is_input_values);
+  checkpoint.write_vector(prefix + "/prepop_start_per_group", prepop_start_per_group);
+  checkpoint.write_vector(prefix + "/postpop_start_per_group", postpop_start_per_group);
+  std::vector<int> dense_group_values;
+  std::vector<float> dense_group_weight_scaling_constants;
+  for (size_t d = 0; d < dense_groups.size(); d++){
+    auto& group = dense_groups[d];
+    int values[] = {group.group_id, group.presynaptic_group_is_input, group.presynaptic_start, group.number_of_presynaptic_neurons,
+                    group.postsynaptic_start, group.number_of_postsynaptic_neurons, group.delay, group.syn_label};
+    dense_group_values.insert(dense_group_values.end(), values, values + 8);
+    dense_group_weight_scaling_constants.push_back(group.weight_scaling_constant);
+    // A section per matrix, written without a copy
+    checkpoint.write_vector(prefix + "/dense_group_weights/" + std::to_string(d), group.weights);
+  }
+  checkpoint.write_vector(prefix + "/dense_groups", dense_group_values);
+  checkpoint.write_vector(prefix + "/dense_group_weight_scaling_constants", dense_group_weight_scaling_constants);
+  std::vector<int> convolutional_group_values;
+  std::vector<float> convolutional_group_weights;
+  for (auto& group : convolutional_groups){
+    int values[] = {group.group_id, group.presynaptic_group_is_input, group.presynaptic_start,
+                    group.presynaptic_shape[0], group.presynaptic_shape[1],
+                    group.postsynaptic_start, group.postsynaptic_shape[0], group.postsynaptic_shape[1],
+                    group.kernel_shape[0], group.kernel_shape[1], group.stride[0], group.stride[1],
+                    group.padding[0], group.padding[1], group.delay, group.syn_label};
+    convolutional_group_values.insert(convolutional_group_values.end(), values, values + 16);
+    convolutional_group_weights.push_back(group.weight_scaling_constant);
+    convolutional_group_weights.insert(convolutional_group_weights.end(), group.kernel_weights.begin(), group.kernel_weights.end());
+  }
+  checkpoint.write_vector(prefix + "/convolutional_groups", convolutional_group_values);
+  checkpoint.write_vector(prefix + "/convolutional_group_weights", convolutional_group_weights);
+  std::vector<int> procedural_group_values;
+  std::vector<float> procedural_group_parameters;
+  for (auto& group : procedural_groups){
+    int values[] = {group.group_id, group.presynaptic_group_is_input, group.presynaptic_start, group.number_of_presynaptic_neurons,
+                    group.postsynaptic_start, group.number_of_postsynaptic_neurons,
+                    group.delay_range[0], group.delay_range[1], group.syn_label, (int)group.seed};
+    procedural_group_values.insert(procedural_group_values.end(), values, values + 10);
+    float parameters[] = {group.probability, group.weight_range[0], group.weight_range[1], group.weight_scaling_constant};
+    procedural_group_parameters.insert(procedural_group_parameters.end(), parameters, parameters + 4);
+  }
+  checkpoint.write_vector(prefix + "/procedural_groups", procedural_group_values);
+  checkpoint.write_vector(prefix + "/procedural_group_parameters", procedural_group_parameters);
+  // Every per-synapse array, including those of sub-classes and the sort permutation
+  for (int c = 0; c < synapse_store.number_of_columns(); c++)
+    checkpoint.write(prefix + "/column/" + std::to_string(c),
+                     synapse_store.column_data(c),
+                     (size_t)total_number_of_synapses*synapse_store.column_element_size(c));
+}
+
+void Synapses::load_state(const CheckpointReader& checkpoint, const std::string& prefix) {
+  int number_of_synapses = checkpoint.read_value<int>(prefix + "/total_number_of_synapses");
+  if ((total_number_of_synapses != 0) && (total_number_of_synapses != number_of_synapses))
+    print_message_and_exit("Checkpoint synapses do not match the synapses of the model.");
+  // Without synapses of our own, the arrays are used in place (zero-copy) from the file
+  bool map_columns = (total_number_of_synapses == 0);
+  total_number_of_synapses = number_of_synapses;
+
+  temp_number_of_synapses_in_last_group = checkpoint.read_value<int>(prefix + "/temp_number_of_synapses_in_last_group");
+  largest_synapse_group_size = checkpoint.read_value<int>(prefix + "/largest_synapse_group_size");
+  maximum_number_of_afferent_synapses = checkpoint.read_value<int>(prefix + "/maximum_number_of_afferent_synapses");
+  synapses_sorted = checkpoint.read_value<bool>(prefix + "/synapses_sorted");
+  checkpoint.read_vector(prefix + "/last_index_of_synapse_per_group", last_index_of_synapse_per_group);
+  std::vector<char> prepop_is_input_values;
+  checkpoint.read_vector(prefix + "/prepop_is_input", prepop_is_input_values);
+  prepop_is_input.assign(prepop_is_input_values.begin(), prepop_is_input_values.end());
+  checkpoint.read_vector(prefix + "/prepop_start_per_group", prepop_start_per_group);
+  checkpoint.read_vector(prefix + "/postpop_start_per_group", postpop_start_per_group);
+  dense_groups.clear();
+  if (checkpoint.has(prefix + "/dense_groups")){
+    std::vector<int> values;
+    std::vector<float> weight_scaling_constants;
+    checkpoint.read_vector(prefix + "/dense_groups", values);
+    checkpoint.read_vector(prefix + "/dense_group_weight_scaling_constants", weight_scaling_constants);
+    for (size_t v = 0, d = 0; v + 8 <= values.size(); v += 8, d++){
+      dense_synapse_group group;
+      group.group_id = values[v];
+      group.presynaptic_group_is_input = values[v + 1];
+      group.presynaptic_start = values[v + 2];
+      group.number_of_presynaptic_neurons = values[v + 3];
+      group.postsynaptic_start = values[v + 4];
+      group.number_of_postsynaptic_neurons = values[v + 5];
+      group.delay = values[v + 6];
+      group.syn_label = values[v + 7];
+      group.weight_scaling_constant = weight_scaling_constants[d];
+      checkpoint.read_vector(prefix + "/dense_group_weights/" + std::to_string(d), group.weights);
+      if ((long long)group.weights.size() != group.number_of_synapses())
+        print_message_and_exit("Checkpoint weight matrix does not match its synapse group.");
+      dense_groups.push_back(std::move(group));
+    }
+  }
+  convolutional_groups.clear();
+  if (checkpoint.has(prefix + "/convolutional_groups")){
+    std::vector<int> values;
+    std::vector<float> weights;
+    checkpoint.read_vector(prefix + "/convolutional_groups", values);
+    checkpoint.read_vector(prefix + "/convolutional_group_weights", weights);
+    size_t weight_index = 0;
+    for (size_t v = 0; v + 16 <= values.size(); v += 16){
+      convolutional_synapse_group group;
+      group.group_id = values[v];
+      group.presynaptic_group_is_input = values[v + 1];
+      group.presynaptic_start = values[v + 2];
+      group.presynaptic_shape[0] = values[v + 3];
+      group.presynaptic_shape[1] = values[v + 4];
+      group.postsynaptic_start = values[v + 5];
+      group.postsynaptic_shape[0] = values[v + 6];
+      group.postsynaptic_shape[1] = values[v + 7];
+      group.kernel_shape[0] = values[v + 8];
+      group.kernel_shape[1] = values[v + 9];
+      group.stride[0] = values[v + 10];
+      group.stride[1] = values[v + 11];
+      group.padding[0] = values[v + 12];
+      group.padding[1] = values[v + 13];
+      group.delay = values[v + 14];
+      group.syn_label = values[v + 15];
+      group.weight_scaling_constant = weights[weight_index++];
+      int kernel_size = group.kernel_shape[0]*group.kernel_shape[1];
+      group.kernel_weights.assign(weights.begin() + weight_index, weights.begin() + weight_index + kernel_size);
+      weight_index += kernel_size;
+      convolutional_groups.push_back(group);
+    }
+  }
+  procedural_groups.clear();
+  if (checkpoint.has(prefix + "/procedural_groups")){
+    std::vector<int> values;
+    std::vector<float> parameters;
+    checkpoint.read_vector(prefix + "/procedural_groups", values);
+    checkpoint.read_vector(prefix + "/procedural_group_parameters", parameters);
+    for (size_t v = 0, p = 0; v + 10 <= values.size(); v += 10, p += 4){
+      procedural_synapse_group group;
+      group.group_id = values[v];
+      group.presynaptic_group_is_input = values[v + 1];
+      group.presynaptic_start = values[v + 2];
+      group.number_of_presynaptic_neurons = values[v + 3];
+      group.postsynaptic_start = values[v + 4];
+      group.number_of_postsynaptic_neurons = values[v + 5];
+      group.delay_range[0] = values[v + 6];
+      group.delay_range[1] = values[v + 7];
+      group.syn_label = values[v + 8];
+      group.seed = (uint32_t)values[v + 9];
+      group.probability = parameters[p];
+      group.weight_range[0] = parameters[p + 1];
+      group.weight_range[1] = parameters[p + 2];
+      group.weight_scaling_constant = parameters[p + 3];
+      procedural_groups.push_back(group);
+    }
+  }
+  if (map_columns){
+    std::vector<void*> columns(synapse_store.number_of_columns());
+    for (int c = 0; c < synapse_store.number_of_columns(); c++){
+      size_t bytes;
+      columns[c] = const_cast<void*>(checkpoint.data(prefix + "/column/" + std::to_string(c), bytes));
+      if (bytes != (size_t)total_number_of_synapses*synapse_store.column_element_size(c))
+        print_message_and_exit("Checkpoint synapse arrays do not match the synapse type of the model.");
+    }
+    synapse_store.map_columns(columns, total_number_of_synapses, checkpoint.mapping());
+  } else {
+    synapse_store.resize(total_number_of_synapses);
+    for (int c = 0; c < synapse_store.number_of_columns(); c++)
+      checkpoint.read(prefix + "/column/" + std::to_string(c),
+                      synapse_store.column_data(c),
+                      (size_t)total_number_of_synapses*synapse_store.column_element_size(c));
+  }
+}
+
 SPIKE_MAKE_STUB_INIT_BACKEND(Synapses);
@@ -18,6 +18,8 @@
 #include "Spike/Backend/Device.hpp"
 #include "Spike/Plasticity/Plasticity.hpp"
 #include "Spike/Neurons/Neurons.hpp"
+#include "Spike/Helpers/ContentHash.hpp"
+#include "Spike/Helpers/CounterRandom.hpp"
 
 // stdlib allows random numbers
 #include <stdlib.h>
@@ -26,11 +28,14 @@
 // allows maths
 #include <math.h>
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <iostream>
 
 #include "Spike/Helpers/RandomStateManager.hpp"
+#include "Spike/Helpers/Parallel.hpp"
+#include "SynapseStore.hpp"
 
 class Synapses; // forward definition
 
@@ -56,7 +61,8 @@ enum CONNECTIVITY_TYPE
   CONNECTIVITY_TYPE_ONE_TO_ONE,
   CONNECTIVITY_TYPE_RANDOM,
   CONNECTIVITY_TYPE_GAUSSIAN_SAMPLE,
-  CONNECTIVITY_TYPE_PAIRWISE
+  CONNECTIVITY_TYPE_PAIRWISE,
+  CONNECTIVITY_TYPE_CONVOLUTIONAL
 };
 
 /*!
@@ -71,13 +77,161 @@ struct synapse_parameters_struct {
   std::vector<float> pairwise_connect_weight;
   int gaussian_synapses_per_postsynaptic_neuron = 10;
   float gaussian_synapses_standard_deviation = 10.0;
+  float gaussian_synapses_window_in_standard_deviations = 6.0; /**< Presynaptic neurons further away than this (in x or y) are never sampled */
   float weight_range[2] = {0.0f, 0.0f};
   float weight_scaling_constant = 1.0;
   float random_connectivity_probability;
+  // CONNECTIVITY_TYPE_ALL_TO_ALL without plasticity: stored as a weight matrix instead of synapse by synapse (CPU backend)
+  bool all_to_all_weight_matrix = false;
+  // CONNECTIVITY_TYPE_RANDOM without plasticity: synapses are regenerated when their presynaptic neuron spikes instead of stored (CPU backend)
+  bool procedural_connectivity = false;
+  // CONNECTIVITY_TYPE_CONVOLUTIONAL, as (x, y). The postsynaptic group shape must be the output shape.
+  int convolution_kernel_shape[2] = {3, 3};
+  int convolution_stride[2] = {1, 1};
+  int convolution_padding[2] = {0, 0};           /**< Zeros added on each side of the presynaptic group */
+  std::vector<float> convolution_kernel_weights; /**< kernel_shape[0]*kernel_shape[1], at y*kernel_shape[0] + x. Drawn from weight_range if empty */
   int connectivity_type = CONNECTIVITY_TYPE_ALL_TO_ALL;
   std::vector<Plasticity*> plasticity_vec;
 };
 
+/*!
+  A CONNECTIVITY_TYPE_ALL_TO_ALL group stored as a weight matrix (see
+  Synapses::stores_weight_matrix). Its synapses are not stored one by one:
+  presynaptic neuron i is connected to postsynaptic neuron j (both counted
+  from the starts) with weight weights[i*number_of_postsynaptic_neurons + j],
+  and every synapse has the group's delay, label and scaling constant.
+*/
+struct dense_synapse_group {
+  int group_id;                      /**< As returned by AddGroup */
+  bool presynaptic_group_is_input;
+  int presynaptic_start;             /**< Of the input neurons if presynaptic_group_is_input */
+  int number_of_presynaptic_neurons;
+  int postsynaptic_start;
+  int number_of_postsynaptic_neurons;
+  int delay;                         /**< In timesteps (spiking synapses) */
+  int syn_label;
+  float weight_scaling_constant;
+  std::vector<float> weights;        /**< Row-major, a row per presynaptic neuron */
+
+  // The number of synapses the group stands for
+  long long number_of_synapses() const;
+  // The weight of the synapse from pre to post (counted from the starts)
+  float& weight(int pre, int post) { return weights[(size_t)pre*number_of_postsynaptic_neurons + post]; }
+};
+
+/*!
+  A CONNECTIVITY_TYPE_CONVOLUTIONAL group. Its synapses are not stored: neuron
+  (x, y) of the postsynaptic group is connected to presynaptic neuron
+  (x*stride[0] - padding[0] + kx, y*stride[1] - padding[1] + ky), where it
+  exists, with weight kernel_weights[ky*kernel_shape[0] + kx]. Neurons of a
+  group are numbered y*shape[0] + x.
+*/
+struct convolutional_synapse_group {
+  int group_id;                      /**< As returned by AddGroup */
+  bool presynaptic_group_is_input;
+  int presynaptic_start;             /**< Of the input neurons if presynaptic_group_is_input */
+  int presynaptic_shape[2];
+  int postsynaptic_start;
+  int postsynaptic_shape[2];
+  int kernel_shape[2];
+  int stride[2];
+  int padding[2];
+  int delay;                         /**< In timesteps, the same for all synapses (spiking synapses) */
+  int syn_label;
+  float weight_scaling_constant;
+  std::vector<float> kernel_weights;
+
+  // The number of synapses the group stands for
+  long long number_of_synapses() const;
+  // Calls target(postsynaptic_neuron_id, kernel_index) for each synapse of presynaptic neuron pre (counted from presynaptic_start)
+  template <typename Target>
+  void for_each_target(int pre, Target target) const {
+    int x = pre % presynaptic_shape[0];
+    int y = pre / presynaptic_shape[0];
+    for (int ky = 0; ky < kernel_shape[1]; ky++){
+      int shifted_y = y + padding[1] - ky;
+      if ((shifted_y < 0) || (shifted_y % stride[1] != 0) || (shifted_y / stride[1] >= postsynaptic_shape[1]))
+        continue;
+      for (int kx = 0; kx < kernel_shape[0]; kx++){
+        int shifted_x = x + padding[0] - kx;
+        if ((shifted_x < 0) || (shifted_x % stride[0] != 0) || (shifted_x / stride[0] >= postsynaptic_shape[0]))
+          continue;
+        target(postsynaptic_start + (shifted_y / stride[1])*postsynaptic_shape[0] + shifted_x / stride[0], ky*kernel_shape[0] + kx);
+      }
+    }
+  }
+};
+
+/*!
+  A CONNECTIVITY_TYPE_RANDOM group with procedural_connectivity. Its synapses
+  are not stored: they are regenerated from the random streams of the group
+  and presynaptic neuron whenever that neuron spikes. The postsynaptic group
+  is sampled in chunks of postsynaptic_chunk_size neurons, each from its own
+  part of the connectivity stream, with each synapse's weight and delay drawn
+  after the gap that finds it. Any range of postsynaptic neurons is therefore
+  generated from the start of its first chunk, without the rest.
+*/
+struct procedural_synapse_group {
+  static const int postsynaptic_chunk_size = 4096;
+
+  int group_id;                      /**< As returned by AddGroup */
+  bool presynaptic_group_is_input;
+  int presynaptic_start;             /**< Of the input neurons if presynaptic_group_is_input */
+  int number_of_presynaptic_neurons;
+  int postsynaptic_start;
+  int number_of_postsynaptic_neurons;
+  float probability;
+  float weight_range[2];
+  float weight_scaling_constant;
+  int delay_range[2];                /**< In timesteps (spiking synapses) */
+  int syn_label;
+  uint32_t seed;                     /**< The host random seed when the group was added */
+
+  // The expected number of synapses of the group
+  double expected_number_of_synapses() const;
+  /**
+   *  Calls target(postsynaptic_neuron_id, weight, delay) for each synapse of
+   *  presynaptic neuron pre (counted from presynaptic_start) onto postsynaptic
+   *  neurons [first_post, last_post), in postsynaptic order.
+   */
+  template <typename Target>
+  void for_each_target(int pre, int first_post, int last_post, Target target) const {
+    int first = std::max(first_post - postsynaptic_start, 0);
+    int last = std::min(last_post - postsynaptic_start, number_of_postsynaptic_neurons);
+    if ((first >= last) || (probability <= 0.0f))
+      return;
+    uint64_t stream = ((uint64_t)group_id << 32) | (uint32_t)pre;
+    double log_of_failure_probability = log1p(-(double)probability);
+    for (int chunk = first / postsynaptic_chunk_size; chunk*postsynaptic_chunk_size < last; chunk++){
+      int chunk_end = std::min((chunk + 1)*postsynaptic_chunk_size, number_of_postsynaptic_neurons);
+      CounterRandom generator(seed, RANDOM_STREAM_CONNECTIVITY, stream, (uint64_t)chunk << 32);
+      // Geometric gaps between connections, as CONNECTIVITY_TYPE_RANDOM groups are sampled
+      int location = chunk*postsynaptic_chunk_size - 1;
+      while (true){
+        if (probability < 1.0f){
+          double gap = floor(log(generator.uniform_double()) / log_of_failure_probability);
+          if (gap >= (double)(chunk_end - location))
+            break;
+          location += (int)gap;
+        }
+        location++;
+        if ((location >= chunk_end) || (location >= last))
+          break;
+        // The weight and delay follow the gap in the same stream (also for skipped synapses)
+        float weight = weight_range[0];
+        float delay = delay_range[0];
+        if (weight_range[1] != weight_range[0])
+          weight += (weight_range[1] - weight_range[0])*generator.uniform_float();
+        if (delay_range[1] != delay_range[0])
+          delay += (delay_range[1] - delay_range[0])*generator.uniform_float();
+        if (location < first)
+          continue;
+        target(postsynaptic_start + location, weight, (int)round(delay));
+      }
+    }
+  }
+};
+
 /*!
   This is the parent class for SpikingSpiking.
   It provides a set of default methods which are primarily used to add groups of synapses to the connectivity.
@@ -105,6 +259,9 @@ public:
   std::vector<bool> prepop_is_input;
   std::vector<int> prepop_start_per_group;
   std::vector<int> postpop_start_per_group;
+  std::vector<dense_synapse_group> dense_groups;                  /**< Groups without stored synapses, in group order */
+  std::vector<convolutional_synapse_group> convolutional_groups;  /**< Likewise */
+  std::vector<procedural_synapse_group> procedural_groups;        /**< Likewise */
   
 
 	
@@ -120,6 +277,8 @@ public:
   int* synapse_sort_indices = nullptr;   // Re-sorting synapses by pre-synaptic neuron
   int* synapse_reversesort_indices = nullptr;   // Re-sorting synapses by pre-synaptic neuron
 
+  SynapseStore synapse_store;   /**< Owns the memory of all of the per-synapse arrays above (and those of sub-classes) */
+
   // Functions
 
   /**
@@ -140,26 +299,131 @@ public:
                         float timestep,
                         synapse_parameters_struct * synapse_params);
 
+  /**
+   *  Adds everything AddGroup reads from its arguments to hash, so that the
+   *  hash identifies the synapses a group will get (used as the key of the
+   *  connectivity cache, see SpikingModel::SetConnectivityCache). Sub-classes
+   *  whose AddGroup reads further parameters extend this.
+   */
+  virtual void add_group_parameters_to_hash(ContentHash& hash,
+                                            int presynaptic_group_id,
+                                            int postsynaptic_group_id,
+                                            float timestep,
+                                            synapse_parameters_struct * synapse_params);
+  /**
+   *  Whether AddGroup stores the group as a weight matrix (one of dense_groups)
+   *  instead of synapse by synapse: CONNECTIVITY_TYPE_ALL_TO_ALL groups without
+   *  plasticity which set all_to_all_weight_matrix. Sub-classes add
+   *  their own conditions (e.g. a single delay).
+   */
+  virtual bool stores_weight_matrix(float timestep, synapse_parameters_struct * synapse_params);
+  // When set, AddGroup takes the group's synapses from this cache entry instead of generating them
+  const CheckpointReader* cached_group = nullptr;
+  // Writes the synapses of the last added group (and the resulting neuron counts) as a cache entry
+  void save_last_group(CheckpointWriter& cache, Neurons* neurons, Neurons* input_neurons);
+
   /**
      *  A function called in to reallocate memory for a given number more synapses.
      /param increment The number of synapses for which allocated memory must be expanded.
   */
   void increment_number_of_synapses(int increment);
+  // Pre-allocates memory for a total of number_of_synapses (avoids re-allocation during AddGroup)
+  void reserve(int number_of_synapses);
+  // Releases memory allocated beyond total_number_of_synapses
+  void shrink_to_fit();
+  /**
+   *  Sorts all per-synapse arrays by presynaptic neuron (stable) and sets the
+   *  per_neuron_efferent_synapse_start/count of the pre-synaptic neurons.
+   *  synapse_sort_indices/synapse_reversesort_indices record the permutation.
+   */
   void sort_synapses(Neurons* input_neurons, Neurons* neurons);
   
+  // The synapses of weight matrices are written in their group's place.
+  // Convolutional and procedural groups have no stored synapses and are not written.
   virtual void save_connectivity_as_txt(std::string path, std::string prefix="", int synapsegroupid=-1);
   virtual void save_connectivity_as_binary(std::string path, std::string prefix="", int synapsegroupid=-1);
   //virtual void load_connectivity_from_txt(std::string path, std::string prefix="");
-  //virtual void load_connectivity_from_bin(std::string path, std::string prefix="");
+  // Binary connectivity is loaded by SpikingModel::load_connectivity_from_binary
 
+  // Weight matrices are written in their group's place, row by row, and the
+  // kernels of convolutional groups follow the weights of all other groups.
+  // Procedural groups have no stored weights (they are a function of the seed).
   void save_weights_as_txt(std::string path, std::string prefix="", int synapsegroupid=-1);
   void save_weights_as_binary(std::string path, std::string prefix="", int synapsegroupid=-1);
 
+  // weights as saved by save_weights_as_*, kernels included
   void load_weights(std::vector<float> weights, int synapsegroupid=-1);
   void load_weights_from_txt(std::string filepath, int synapsegroupid=-1);
   void load_weights_from_binary(std::string filepath, int synapsegroupid=-1);
 
   void reset_state() override;
+  void save_state(CheckpointWriter& checkpoint, const std::string& prefix) override;
+  void load_state(const CheckpointReader& checkpoint, const std::string& prefix) override;
+
+protected:
+  /**
+   *  Re-orders every per-synapse array by synapse_sort_indices. Sub-classes
+   *  with their own per-synapse arrays extend this (and call the parent).
+   *  scratch is a re-usable buffer so only one temporary array is ever held.
+   */
+  virtual void sort_synapse_attributes(std::vector<char>& scratch);
+
+  // AddGroup from cached_group
+  void add_cached_group(Neurons* neurons, Neurons* input_neurons);
+  // AddGroup of a CONNECTIVITY_TYPE_ALL_TO_ALL group stored as a weight matrix (which adds no synapses)
+  void add_dense_group(synapse_parameters_struct * synapse_params,
+                       int prestart, int preend, bool presynaptic_group_is_input,
+                       int poststart, int postend,
+                       uint32_t group_number);
+  // AddGroup of a CONNECTIVITY_TYPE_CONVOLUTIONAL group (which adds no synapses)
+  void add_convolutional_group(synapse_parameters_struct * synapse_params,
+                               int prestart, int* presynaptic_group_shape, bool presynaptic_group_is_input,
+                               int poststart, int* postsynaptic_group_shape,
+                               uint32_t group_number);
+  // AddGroup of a procedural CONNECTIVITY_TYPE_RANDOM group (which adds no synapses)
+  void add_procedural_group(synapse_parameters_struct * synapse_params,
+                            int prestart, int preend, bool presynaptic_group_is_input,
+                            int poststart, int postend);
+  // The bookkeeping shared by generated and cached groups: plasticity and the per-group tables
+  int finish_adding_group(synapse_parameters_struct * synapse_params, int prestart, int poststart, bool presynaptic_group_is_input);
+
+  /**
+   *  Visits the synapses of group synapsegroupid (all groups if < 0) in group
+   *  order, calling stored(synapse_id) for each stored synapse (in the order
+   *  they were added) and dense(group, pre, post) for each synapse of a weight
+   *  matrix (row by row). Convolutional and procedural groups are skipped.
+   */
+  template <typename Stored, typename Dense>
+  void for_each_synapse(int synapsegroupid, Stored stored, Dense dense){
+    int first_group = (synapsegroupid >= 0) ? synapsegroupid : 0;
+    int last_group = (synapsegroupid >= 0) ? synapsegroupid + 1 : (int)last_index_of_synapse_per_group.size();
+    size_t d = 0;
+    for (int group_id = first_group; group_id < last_group; group_id++){
+      int startid = (group_id > 0) ? last_index_of_synapse_per_group[group_id - 1] : 0;
+      for (int i = startid; i < last_index_of_synapse_per_group[group_id]; i++)
+        stored(synapse_reversesort_indices[i]);
+      while ((d < dense_groups.size()) && (dense_groups[d].group_id < group_id))
+        d++;
+      if ((d < dense_groups.size()) && (dense_groups[d].group_id == group_id))
+        for (int pre = 0; pre < dense_groups[d].number_of_presynaptic_neurons; pre++)
+          for (int post = 0; post < dense_groups[d].number_of_postsynaptic_neurons; post++)
+            dense(dense_groups[d], pre, post);
+    }
+  }
+
+  template <typename T>
+  void apply_synapse_sort(T* synapse_array, std::vector<char>& scratch){
+    scratch.resize((size_t)total_number_of_synapses * sizeof(T));
+    T* sorted = reinterpret_cast<T*>(scratch.data());
+    const int synapses_per_block = 1 << 16;
+    int number_of_blocks = (total_number_of_synapses + synapses_per_block - 1) / synapses_per_block;
+    parallel_for_blocks(number_of_blocks, [&](int block) {
+        int end = std::min(total_number_of_synapses, (block + 1)*synapses_per_block);
+        for (int s = block*synapses_per_block; s < end; s++)
+          sorted[s] = synapse_array[synapse_sort_indices[s]];
+      });
+    std::copy(sorted, sorted + total_number_of_synapses, synapse_array);
+  }
 
 private:
   std::shared_ptr<::Backend::Synapses> _backend;
@@ -34,8 +34,6 @@ public:
                 float timestep,
                 synapse_parameters_struct * synapse_params) override;
 
-  void increment_number_of_synapses(int increment);
-
   void state_update(unsigned int current_time_in_timesteps, float timestep) override;
 
 private:
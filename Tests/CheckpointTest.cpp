@@ -0,0 +1,115 @@
+// CheckpointTest: a simulation resumed from a checkpoint continues exactly
+/*
+  A plastic network is run, checkpointed and run on. The checkpoint is then
+  loaded into a new model (finalised with the same synapse groups, and not
+  finalised at all, taking the synapses from the checkpoint), which is run
+  on for the same time. The spikes, the weights and the simulation time
+  must be identical to those of the original run.
+*/
+
+#include "TestHelpers.hpp"
+
+#include <cstdio>
+#include <vector>
+
+struct checkpoint_network {
+  SpikingModel* model;
+  SpikingActivityMonitor* spike_monitor;
+};
+
+static checkpoint_network build_network(bool add_synapses){
+  checkpoint_network network;
+  network.model = new_test_model();
+  SpikingModel* model = network.model;
+
+  weightdependent_stdp_plasticity_parameters_struct* stdp_params = new weightdependent_stdp_plasticity_parameters_struct;
+  stdp_params->a_plus = 1.0f;
+  stdp_params->a_minus = 1.0f;
+  stdp_params->tau_plus = 0.02f;
+  stdp_params->tau_minus = 0.02f;
+  stdp_params->lambda = 1.0f*pow(10.0, -2);
+  stdp_params->alpha = 2.02f;
+  stdp_params->w_max = 0.3f*pow(10.0, -3);
+  WeightDependentSTDPPlasticity* stdp = new WeightDependentSTDPPlasticity(model->spiking_synapses, model->spiking_neurons, model->input_spiking_neurons, stdp_params);
+  model->AddPlasticityRule(stdp);
+  network.spike_monitor = new SpikingActivityMonitor(model->spiking_neurons);
+  model->AddActivityMonitor(network.spike_monitor);
+
+  int inputs = add_test_input_group(model, 1, 300, 20.0f);
+  int excitatory = add_test_neuron_group(model, 1, 250);
+  int inhibitory = add_test_neuron_group(model, 1, 100);
+  if (!add_synapses)
+    return network;
+
+  voltage_spiking_synapse_parameters_struct* input_params = new_test_synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, 0.3f*pow(10.0, -3), 0.001f);
+  input_params->weight_range[0] = 0.1f*pow(10.0, -3);
+  input_params->plasticity_vec.push_back(stdp);
+  model->AddSynapseGroup(inputs, excitatory, input_params);
+
+  voltage_spiking_synapse_parameters_struct* excitatory_params = new_test_synapse_params(CONNECTIVITY_TYPE_RANDOM, 0.6f*pow(10.0, -3), 0.001f);
+  excitatory_params->delay_range[1] = 0.003f;
+  excitatory_params->random_connectivity_probability = 0.1f;
+  model->AddSynapseGroup(excitatory, excitatory, excitatory_params);
+  model->AddSynapseGroup(excitatory, inhibitory, excitatory_params);
+
+  voltage_spiking_synapse_parameters_struct* inhibitory_params = new_test_synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, -0.3f*pow(10.0, -3), 0.0005f);
+  model->AddSynapseGroup(inhibitory, excitatory, inhibitory_params);
+  return network;
+}
+
+static void check_same_simulation(const checkpoint_network& resumed, const checkpoint_network& original){
+  SpikingActivityMonitor* monitor = resumed.spike_monitor;
+  SpikingActivityMonitor* original_monitor = original.spike_monitor;
+  SPIKE_CHECK(resumed.model->current_time_in_timesteps == original.model->current_time_in_timesteps);
+  SPIKE_CHECK(monitor->total_number_of_spikes_stored_on_host == original_monitor->total_number_of_spikes_stored_on_host);
+  if (monitor->total_number_of_spikes_stored_on_host == original_monitor->total_number_of_spikes_stored_on_host){
+    bool identical = true;
+    for (int s = 0; s < monitor->total_number_of_spikes_stored_on_host; s++)
+      if ((monitor->neuron_ids_of_stored_spikes_on_host[s] != original_monitor->neuron_ids_of_stored_spikes_on_host[s]) ||
+          (monitor->spike_times_of_stored_spikes_on_host[s] != original_monitor->spike_times_of_stored_spikes_on_host[s]))
+        identical = false;
+    SPIKE_CHECK(identical);
+  }
+
+  SpikingSynapses* synapses = resumed.model->spiking_synapses;
+  SpikingSynapses* original_synapses = original.model->spiking_synapses;
+  SPIKE_CHECK(synapses->total_number_of_synapses == original_synapses->total_number_of_synapses);
+  if (synapses->total_number_of_synapses == original_synapses->total_number_of_synapses){
+    synapses->backend()->copy_to_frontend();
+    original_synapses->backend()->copy_to_frontend();
+    bool identical = true;
+    for (int s = 0; s < synapses->total_number_of_synapses; s++)
+      if ((synapses->presynaptic_neuron_indices[s] != original_synapses->presynaptic_neuron_indices[s]) ||
+          (synapses->postsynaptic_neuron_indices[s] != original_synapses->postsynaptic_neuron_indices[s]) ||
+          (synapses->delays[s] != original_synapses->delays[s]) ||
+          (synapses->synaptic_efficacies_or_weights[s] != original_synapses->synaptic_efficacies_or_weights[s]))
+        identical = false;
+    SPIKE_CHECK(identical);
+  }
+}
+
+int main (int argc, char *argv[]){
+  const char* filename = "CheckpointTest.checkpoint";
+  set_test_context(2);
+
+  checkpoint_network original = build_network(true);
+  original.model->finalise_model();
+  original.model->run(0.2f);
+  original.model->save_checkpoint(filename);
+  original.model->run(0.2f);
+  SPIKE_CHECK(original.spike_monitor->total_number_of_spikes_stored_on_host > 0);
+
+  checkpoint_network resumed = build_network(true);
+  resumed.model->finalise_model();
+  resumed.model->load_checkpoint(filename);
+  resumed.model->run(0.2f);
+  check_same_simulation(resumed, original);
+
+  checkpoint_network loaded = build_network(false);
+  loaded.model->load_checkpoint(filename);
+  loaded.model->run(0.2f);
+  check_same_simulation(loaded, original);
+
+  remove(filename);
+  return test_result("CheckpointTest");
+}
@@ -0,0 +1,214 @@
+// GaussianConnectivityTest: CONNECTIVITY_TYPE_GAUSSIAN_SAMPLE against the baseline sampler
+/*
+  Each postsynaptic neuron draws gaussian_synapses_per_postsynaptic_neuron
+  presynaptic neurons without replacement, with probability proportional to
+  a Gaussian of their distance from its centre in the presynaptic group. The
+  sampler only considers a window around the centre, which must not change
+  this distribution. The reference sampler below is the original one, which
+  weighs the whole presynaptic group.
+*/
+
+#include "TestHelpers.hpp"
+
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+struct gaussian_group {
+  int presynaptic_group;   // An input group
+  int presynaptic_shape[2];
+  int postsynaptic_group;
+  int postsynaptic_shape[2];
+  int synapses_per_postsynaptic_neuron;
+  float standard_deviation;
+  int first_synapse;
+  int number_of_synapses;
+};
+
+struct gaussian_network {
+  SpikingModel* model;
+  std::vector<gaussian_group> groups;
+};
+
+static gaussian_network build_network(int threads){
+  set_test_context(threads);
+  gaussian_network network;
+  network.model = new_test_model();
+  int inputs = add_test_input_group(network.model, 40, 40, 10.0f);
+  int small_inputs = add_test_input_group(network.model, 30, 30, 10.0f);
+  int layer = add_test_neuron_group(network.model, 40, 40);
+  int small_layer = add_test_neuron_group(network.model, 30, 30);
+
+  network.groups = {
+    {inputs, {40, 40}, layer, {40, 40}, 1, 1.5f},
+    {small_inputs, {30, 30}, small_layer, {30, 30}, 20, 3.0f},
+    // The window (three neurons either side) holds too few neurons and is widened
+    {small_inputs, {30, 30}, small_layer, {30, 30}, 60, 0.5f},
+  };
+  for (gaussian_group& group : network.groups){
+    voltage_spiking_synapse_parameters_struct* params = new_test_synapse_params(CONNECTIVITY_TYPE_GAUSSIAN_SAMPLE, 1.0f, 0.001f);
+    params->gaussian_synapses_per_postsynaptic_neuron = group.synapses_per_postsynaptic_neuron;
+    params->gaussian_synapses_standard_deviation = group.standard_deviation;
+    group.first_synapse = network.model->spiking_synapses->total_number_of_synapses;
+    network.model->AddSynapseGroup(group.presynaptic_group, group.postsynaptic_group, params);
+    group.number_of_synapses = network.model->spiking_synapses->total_number_of_synapses - group.first_synapse;
+  }
+  return network;
+}
+
+// The centre of a postsynaptic neuron in the presynaptic group, as computed by the sampler
+static void presynaptic_centre(const gaussian_group& group, int postid, int& centre_x, int& centre_y){
+  float post_fractional_centre_x = ((float)(postid % group.postsynaptic_shape[0]) / (float)group.postsynaptic_shape[0]);
+  float post_fractional_centre_y = ((float)((float)postid / (float)group.postsynaptic_shape[1]) / (float)group.postsynaptic_shape[1]);
+  centre_x = group.presynaptic_shape[0] * post_fractional_centre_x;
+  centre_y = group.presynaptic_shape[1] * post_fractional_centre_y;
+}
+
+// Histogram bins of the offset of a presynaptic neuron from the centre
+static const int number_of_bins = 13;
+static int offset_bin(const gaussian_group& group, int preid, int centre_x, int centre_y){
+  int distance = abs(preid % group.presynaptic_shape[0] - centre_x) + abs(preid / group.presynaptic_shape[0] - centre_y);
+  return std::min(distance, number_of_bins - 1);
+}
+
+// The histogram of the offsets drawn by the original sampler, repeated a number of times
+static std::vector<double> reference_histogram(const gaussian_group& group, int repeats){
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<double> histogram(number_of_bins, 0.0);
+  int number_of_presynaptic_neurons = group.presynaptic_shape[0]*group.presynaptic_shape[1];
+  int number_of_postsynaptic_neurons = group.postsynaptic_shape[0]*group.postsynaptic_shape[1];
+  double two_sigma_squared = 2.0*group.standard_deviation*group.standard_deviation;
+  for (int repeat = 0; repeat < repeats; repeat++){
+    for (int postid = 0; postid < number_of_postsynaptic_neurons; postid++){
+      int centre_x, centre_y;
+      presynaptic_centre(group, postid, centre_x, centre_y);
+      std::vector<double> x_weights(group.presynaptic_shape[0]), y_weights(group.presynaptic_shape[1]);
+      for (int x = 0; x < group.presynaptic_shape[0]; x++)
+        x_weights[x] = exp(-(double)((x - centre_x)*(x - centre_x)) / two_sigma_squared);
+      for (int y = 0; y < group.presynaptic_shape[1]; y++)
+        y_weights[y] = exp(-(double)((y - centre_y)*(y - centre_y)) / two_sigma_squared);
+      std::vector<double> probabilities(number_of_presynaptic_neurons);
+      std::vector<double> row_probabilities(group.presynaptic_shape[1], 0.0);
+      double total_probability = 0.0;
+      for (int preid = 0; preid < number_of_presynaptic_neurons; preid++){
+        probabilities[preid] = x_weights[preid % group.presynaptic_shape[0]] * y_weights[preid / group.presynaptic_shape[0]];
+        row_probabilities[preid / group.presynaptic_shape[0]] += probabilities[preid];
+        total_probability += probabilities[preid];
+      }
+      // Each draw picks a row and then a neuron within it
+      for (int i = 0; i < group.synapses_per_postsynaptic_neuron; i++){
+        double randval = total_probability * uniform(generator);
+        int row = group.presynaptic_shape[1] - 1;
+        for (int y = 0; y < group.presynaptic_shape[1]; y++){
+          if (randval < row_probabilities[y]){
+            row = y;
+            break;
+          }
+          randval -= row_probabilities[y];
+        }
+        int chosen = -1;
+        for (int x = 0; x < group.presynaptic_shape[0]; x++){
+          int preid = row*group.presynaptic_shape[0] + x;
+          if (probabilities[preid] > 0.0)
+            chosen = preid;
+          if ((chosen >= 0) && (randval < probabilities[preid]))
+            break;
+          randval -= probabilities[preid];
+        }
+        if (chosen < 0){
+          // Rounding picked an exhausted row
+          i--;
+          continue;
+        }
+        histogram[offset_bin(group, chosen, centre_x, centre_y)]++;
+        row_probabilities[row] -= probabilities[chosen];
+        total_probability -= probabilities[chosen];
+        probabilities[chosen] = 0.0;
+      }
+    }
+  }
+  return histogram;
+}
+
+// The chi-squared statistic of two histograms drawn from the same distribution
+static double two_sample_chi_squared(const std::vector<double>& a, const std::vector<double>& b){
+  double total_a = 0.0, total_b = 0.0;
+  for (int bin = 0; bin < number_of_bins; bin++){
+    total_a += a[bin];
+    total_b += b[bin];
+  }
+  double chi_squared = 0.0;
+  for (int bin = 0; bin < number_of_bins; bin++){
+    if (a[bin] + b[bin] == 0.0)
+      continue;
+    double difference = sqrt(total_b / total_a)*a[bin] - sqrt(total_a / total_b)*b[bin];
+    chi_squared += difference*difference / (a[bin] + b[bin]);
+  }
+  return chi_squared;
+}
+
+static void check_group(SpikingModel* model, const gaussian_group& group, bool check_distribution){
+  Synapses* synapses = model->spiking_synapses;
+  int prestart = model->input_spiking_neurons->start_neuron_indices_for_each_group[CORRECTED_PRESYNAPTIC_ID(group.presynaptic_group, true)];
+  int poststart = model->spiking_neurons->start_neuron_indices_for_each_group[group.postsynaptic_group];
+  int number_of_presynaptic_neurons = group.presynaptic_shape[0]*group.presynaptic_shape[1];
+  int number_of_postsynaptic_neurons = group.postsynaptic_shape[0]*group.postsynaptic_shape[1];
+  SPIKE_CHECK(group.number_of_synapses == number_of_postsynaptic_neurons*group.synapses_per_postsynaptic_neuron);
+  if (group.number_of_synapses != number_of_postsynaptic_neurons*group.synapses_per_postsynaptic_neuron)
+    return;
+
+  // Each postsynaptic neuron has its synapses in turn, from distinct presynaptic neurons
+  std::vector<double> histogram(number_of_bins, 0.0);
+  bool in_range = true, distinct = true;
+  for (int postid = 0; postid < number_of_postsynaptic_neurons; postid++){
+    int centre_x, centre_y;
+    presynaptic_centre(group, postid, centre_x, centre_y);
+    std::set<int> presynaptic_neurons;
+    for (int i = 0; i < group.synapses_per_postsynaptic_neuron; i++){
+      int s = group.first_synapse + postid*group.synapses_per_postsynaptic_neuron + i;
+      int pre = CORRECTED_PRESYNAPTIC_ID(synapses->presynaptic_neuron_indices[s], true) - prestart;
+      if ((pre < 0) || (pre >= number_of_presynaptic_neurons) || (synapses->postsynaptic_neuron_indices[s] != poststart + postid)){
+        in_range = false;
+        continue;
+      }
+      if (!presynaptic_neurons.insert(pre).second)
+        distinct = false;
+      histogram[offset_bin(group, pre, centre_x, centre_y)]++;
+    }
+  }
+  SPIKE_CHECK(in_range);
+  SPIKE_CHECK(distinct);
+
+  // Twelve degrees of freedom, the 1e-4 quantile of the chi-squared distribution is 36.5
+  if (check_distribution){
+    double chi_squared = two_sample_chi_squared(histogram, reference_histogram(group, 5));
+    if (chi_squared >= 36.5)
+      fprintf(stderr, "Offsets differ from the reference sampler: chi-squared %f\n", chi_squared);
+    SPIKE_CHECK(chi_squared < 36.5);
+  }
+}
+
+int main (int argc, char *argv[]){
+  gaussian_network network = build_network(1);
+  check_group(network.model, network.groups[0], true);
+  check_group(network.model, network.groups[1], true);
+  check_group(network.model, network.groups[2], false);
+
+  // The same connectivity with several threads
+  gaussian_network threaded_network = build_network(4);
+  Synapses* synapses = network.model->spiking_synapses;
+  Synapses* threaded_synapses = threaded_network.model->spiking_synapses;
+  SPIKE_CHECK(synapses->total_number_of_synapses == threaded_synapses->total_number_of_synapses);
+  if (synapses->total_number_of_synapses == threaded_synapses->total_number_of_synapses){
+    bool identical = true;
+    for (int s = 0; s < synapses->total_number_of_synapses; s++)
+      if ((synapses->presynaptic_neuron_indices[s] != threaded_synapses->presynaptic_neuron_indices[s]) ||
+          (synapses->postsynaptic_neuron_indices[s] != threaded_synapses->postsynaptic_neuron_indices[s]))
+        identical = false;
+    SPIKE_CHECK(identical);
+  }
+
+  return test_result("GaussianConnectivityTest");
+}
@@ -0,0 +1,137 @@
+// RandomConnectivityTest: CONNECTIVITY_TYPE_RANDOM against the Bernoulli model
+/*
+  Every (pre, post) pair of a random group is a synapse with probability
+  random_connectivity_probability, independently of every other pair. The
+  synapses of a group are written row by row (by presynaptic neuron), and
+  the result depends on the seed only, not on the number of threads.
+*/
+
+#include "TestHelpers.hpp"
+
+#include <cmath>
+#include <vector>
+
+struct random_group {
+  int presynaptic_group;   // An input group if negative
+  int number_of_presynaptic_neurons;
+  int postsynaptic_group;
+  int number_of_postsynaptic_neurons;
+  float probability;
+  int first_synapse;
+  int number_of_synapses;
+};
+
+struct random_network {
+  SpikingModel* model;
+  std::vector<random_group> groups;
+};
+
+static random_network build_network(int threads){
+  set_test_context(threads);
+  random_network network;
+  network.model = new_test_model();
+  int inputs = add_test_input_group(network.model, 1, 700, 10.0f);
+  int excitatory = add_test_neuron_group(network.model, 1, 2000);
+  int small = add_test_neuron_group(network.model, 1, 50);
+
+  network.groups = {
+    {inputs, 700, excitatory, 2000, 0.05f},
+    {excitatory, 2000, excitatory, 2000, 0.1f},
+    {inputs, 700, small, 50, 1.0f},
+    {excitatory, 2000, small, 50, 0.0f},
+    {small, 50, excitatory, 2000, 0.5f},
+  };
+  for (random_group& group : network.groups){
+    voltage_spiking_synapse_parameters_struct* params = new_test_synapse_params(CONNECTIVITY_TYPE_RANDOM, 1.0f, 0.001f);
+    params->random_connectivity_probability = group.probability;
+    group.first_synapse = network.model->spiking_synapses->total_number_of_synapses;
+    network.model->AddSynapseGroup(group.presynaptic_group, group.postsynaptic_group, params);
+    group.number_of_synapses = network.model->spiking_synapses->total_number_of_synapses - group.first_synapse;
+  }
+  return network;
+}
+
+// The sample variance of counts, relative to that of Binomial(trials, probability)
+static double relative_variance(const std::vector<int>& counts, int trials, double probability){
+  double mean = 0.0;
+  for (int count : counts)
+    mean += count;
+  mean /= counts.size();
+  double variance = 0.0;
+  for (int count : counts)
+    variance += (count - mean)*(count - mean);
+  variance /= (counts.size() - 1);
+  return variance / (trials*probability*(1.0 - probability));
+}
+
+static void check_group(SpikingModel* model, const random_group& group){
+  Synapses* synapses = model->spiking_synapses;
+  bool presynaptic_group_is_input = (group.presynaptic_group < 0);
+  Neurons* pre_neurons = presynaptic_group_is_input ? (Neurons*)model->input_spiking_neurons : (Neurons*)model->spiking_neurons;
+  int prestart = pre_neurons->start_neuron_indices_for_each_group[CORRECTED_PRESYNAPTIC_ID(group.presynaptic_group, presynaptic_group_is_input)];
+  int poststart = model->spiking_neurons->start_neuron_indices_for_each_group[group.postsynaptic_group];
+
+  long long pairs = (long long)group.number_of_presynaptic_neurons * group.number_of_postsynaptic_neurons;
+  double expected = pairs * (double)group.probability;
+  double sigma = sqrt(expected * (1.0 - group.probability));
+  SPIKE_CHECK(fabs(group.number_of_synapses - expected) <= 5.0*sigma);
+
+  std::vector<int> out_degree(group.number_of_presynaptic_neurons, 0);
+  std::vector<int> in_degree(group.number_of_postsynaptic_neurons, 0);
+  long long previous_location = -1;
+  bool in_range = true, in_order = true;
+  for (int s = group.first_synapse; s < group.first_synapse + group.number_of_synapses; s++){
+    int pre = CORRECTED_PRESYNAPTIC_ID(synapses->presynaptic_neuron_indices[s], presynaptic_group_is_input) - prestart;
+    int post = synapses->postsynaptic_neuron_indices[s] - poststart;
+    if ((pre < 0) || (pre >= group.number_of_presynaptic_neurons) || (post < 0) || (post >= group.number_of_postsynaptic_neurons)){
+      in_range = false;
+      continue;
+    }
+    // Row by row and without repeats
+    long long location = (long long)pre*group.number_of_postsynaptic_neurons + post;
+    if (location <= previous_location)
+      in_order = false;
+    previous_location = location;
+    out_degree[pre]++;
+    in_degree[post]++;
+  }
+  SPIKE_CHECK(in_range);
+  SPIKE_CHECK(in_order);
+
+  // Independent pairs: the degrees are binomially distributed (checked where
+  // there are enough of them for the sample variance to be within 10%)
+  if ((group.probability > 0.0f) && (group.probability < 1.0f)){
+    if (group.number_of_presynaptic_neurons >= 500){
+      double out_variance = relative_variance(out_degree, group.number_of_postsynaptic_neurons, group.probability);
+      SPIKE_CHECK((out_variance > 0.8) && (out_variance < 1.2));
+    }
+    if (group.number_of_postsynaptic_neurons >= 500){
+      double in_variance = relative_variance(in_degree, group.number_of_presynaptic_neurons, group.probability);
+      SPIKE_CHECK((in_variance > 0.8) && (in_variance < 1.2));
+    }
+  }
+}
+
+int main (int argc, char *argv[]){
+  random_network network = build_network(1);
+  for (const random_group& group : network.groups)
+    check_group(network.model, group);
+  SPIKE_CHECK(network.groups[2].number_of_synapses == 700*50);
+  SPIKE_CHECK(network.groups[3].number_of_synapses == 0);
+
+  // The same connectivity with several threads
+  random_network threaded_network = build_network(4);
+  Synapses* synapses = network.model->spiking_synapses;
+  Synapses* threaded_synapses = threaded_network.model->spiking_synapses;
+  SPIKE_CHECK(synapses->total_number_of_synapses == threaded_synapses->total_number_of_synapses);
+  if (synapses->total_number_of_synapses == threaded_synapses->total_number_of_synapses){
+    bool identical = true;
+    for (int s = 0; s < synapses->total_number_of_synapses; s++)
+      if ((synapses->presynaptic_neuron_indices[s] != threaded_synapses->presynaptic_neuron_indices[s]) ||
+          (synapses->postsynaptic_neuron_indices[s] != threaded_synapses->postsynaptic_neuron_indices[s]))
+        identical = false;
+    SPIKE_CHECK(identical);
+  }
+
+  return test_result("RandomConnectivityTest");
+}
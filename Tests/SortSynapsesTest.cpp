@@ -0,0 +1,104 @@
+// SortSynapsesTest: Synapses::sort_synapses against a stable sort
+/*
+  Finalising a model sorts every per-synapse array by presynaptic neuron,
+  keeping the order in which the synapses were added within each neuron (as
+  the original per-neuron sort did). The efferent synapses of each neuron
+  are then the range per_neuron_efferent_synapse_start/count, and
+  synapse_sort_indices/synapse_reversesort_indices record the permutation.
+*/
+
+#include "TestHelpers.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+struct synapse_record {
+  int presynaptic_neuron;
+  int postsynaptic_neuron;
+  float weight;
+  int delay;
+  int added_index;
+};
+
+int main (int argc, char *argv[]){
+  // Enough synapses to be sorted in several chunks
+  set_test_context(4);
+  SpikingModel* model = new_test_model();
+  int inputs = add_test_input_group(model, 1, 500, 10.0f);
+  int excitatory = add_test_neuron_group(model, 1, 3000);
+  int inhibitory = add_test_neuron_group(model, 1, 200);
+
+  voltage_spiking_synapse_parameters_struct* input_params = new_test_synapse_params(CONNECTIVITY_TYPE_RANDOM, 0.5f, 0.001f);
+  input_params->random_connectivity_probability = 0.05f;
+  model->AddSynapseGroup(inputs, excitatory, input_params);
+
+  voltage_spiking_synapse_parameters_struct* excitatory_params = new_test_synapse_params(CONNECTIVITY_TYPE_RANDOM, 0.2f, 0.001f);
+  excitatory_params->random_connectivity_probability = 0.05f;
+  excitatory_params->delay_range[1] = 0.005f;
+  model->AddSynapseGroup(excitatory, excitatory, excitatory_params);
+
+  voltage_spiking_synapse_parameters_struct* inhibitory_params = new_test_synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, -0.5f, 0.002f);
+  inhibitory_params->weight_range[1] = -0.1f;
+  model->AddSynapseGroup(inhibitory, excitatory, inhibitory_params);
+
+  // Pairwise synapses in a shuffled order, with repeated presynaptic neurons
+  voltage_spiking_synapse_parameters_struct* pairwise_params = new_test_synapse_params(CONNECTIVITY_TYPE_PAIRWISE, 0.3f, 0.001f);
+  std::mt19937 generator(42);
+  for (int i = 0; i < 5000; i++){
+    pairwise_params->pairwise_connect_presynaptic.push_back(generator() % 3000);
+    pairwise_params->pairwise_connect_postsynaptic.push_back(generator() % 200);
+    pairwise_params->pairwise_connect_weight.push_back(0.001f*i);
+    pairwise_params->pairwise_connect_delay.push_back(0.0001f*(1 + i % 20));
+  }
+  model->AddSynapseGroup(excitatory, inhibitory, pairwise_params);
+
+  SpikingSynapses* synapses = model->spiking_synapses;
+  int number_of_synapses = synapses->total_number_of_synapses;
+  int number_of_input_neurons = model->input_spiking_neurons->total_number_of_neurons;
+  std::vector<synapse_record> added(number_of_synapses);
+  for (int s = 0; s < number_of_synapses; s++)
+    added[s] = {synapses->presynaptic_neuron_indices[s], synapses->postsynaptic_neuron_indices[s],
+                synapses->synaptic_efficacies_or_weights[s], synapses->delays[s], s};
+
+  model->finalise_model();
+  SPIKE_CHECK(synapses->total_number_of_synapses == number_of_synapses);
+
+  // Input neurons have negative presynaptic ids and come first
+  std::vector<synapse_record> expected = added;
+  std::stable_sort(expected.begin(), expected.end(), [](const synapse_record& a, const synapse_record& b) {
+      return a.presynaptic_neuron < b.presynaptic_neuron;
+    });
+  bool sorted = true, permutation = true;
+  for (int s = 0; s < number_of_synapses; s++){
+    if ((synapses->presynaptic_neuron_indices[s] != expected[s].presynaptic_neuron) ||
+        (synapses->postsynaptic_neuron_indices[s] != expected[s].postsynaptic_neuron) ||
+        (synapses->synaptic_efficacies_or_weights[s] != expected[s].weight) ||
+        (synapses->delays[s] != expected[s].delay))
+      sorted = false;
+    if ((synapses->synapse_sort_indices[s] != expected[s].added_index) ||
+        (synapses->synapse_reversesort_indices[expected[s].added_index] != s))
+      permutation = false;
+  }
+  SPIKE_CHECK(sorted);
+  SPIKE_CHECK(permutation);
+
+  // The efferent ranges of every neuron
+  std::vector<int> count(number_of_input_neurons + model->spiking_neurons->total_number_of_neurons, 0);
+  for (const synapse_record& synapse : added)
+    count[number_of_input_neurons + synapse.presynaptic_neuron]++;
+  bool ranges = true;
+  int start = 0;
+  for (int n = 0; n < (int)count.size(); n++){
+    bool is_input = (n < number_of_input_neurons);
+    Neurons* neurons = is_input ? (Neurons*)model->input_spiking_neurons : (Neurons*)model->spiking_neurons;
+    int neuron_id = is_input ? CORRECTED_PRESYNAPTIC_ID(n - number_of_input_neurons, true) : (n - number_of_input_neurons);
+    if ((neurons->per_neuron_efferent_synapse_start[neuron_id] != start) ||
+        (neurons->per_neuron_efferent_synapse_count[neuron_id] != count[n]))
+      ranges = false;
+    start += count[n];
+  }
+  SPIKE_CHECK(ranges);
+
+  return test_result("SortSynapsesTest");
+}
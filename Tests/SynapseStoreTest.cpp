@@ -0,0 +1,135 @@
+// SynapseStoreTest: SynapseStore against std::vector columns
+/*
+  The registered pointers of a SynapseStore must always point at the
+  current memory and keep their contents through growth, reserve,
+  shrink_to_fit and mapping, like a std::vector per column. Growth is
+  geometric, so adding synapses one by one moves the memory only a
+  logarithmic number of times.
+*/
+
+#include "TestHelpers.hpp"
+
+#include <random>
+#include <vector>
+
+struct store_columns {
+  int* indices = nullptr;
+  float* weights = nullptr;
+  char* labels = nullptr;
+};
+
+static bool columns_equal(const store_columns& columns, const std::vector<int>& indices,
+                          const std::vector<float>& weights, const std::vector<char>& labels){
+  for (int s = 0; s < (int)indices.size(); s++)
+    if ((columns.indices[s] != indices[s]) || (columns.weights[s] != weights[s]) || (columns.labels[s] != labels[s]))
+      return false;
+  return true;
+}
+
+int main (int argc, char *argv[]){
+  SynapseStore store;
+  store_columns columns;
+  std::vector<int> indices;
+  std::vector<float> weights;
+  std::vector<char> labels;
+  store.add_column(&columns.indices);
+  store.add_column(&columns.weights);
+  SPIKE_CHECK(store.size() == 0);
+  SPIKE_CHECK(columns.indices == nullptr);
+
+  // Growing one synapse at a time
+  int moves = 0;
+  for (int s = 0; s < 100000; s++){
+    int* previous = columns.indices;
+    store.resize(s + 1);
+    if (columns.indices != previous)
+      moves++;
+    columns.indices[s] = s;
+    columns.weights[s] = 0.5f*s;
+    indices.push_back(s);
+    weights.push_back(0.5f*s);
+  }
+  SPIKE_CHECK(store.size() == 100000);
+  SPIKE_CHECK(store.capacity() >= store.size());
+  SPIKE_CHECK(moves <= 20);
+
+  // A column added later starts with the current capacity
+  store.add_column(&columns.labels);
+  SPIKE_CHECK(columns.labels != nullptr);
+  for (int s = 0; s < store.size(); s++){
+    columns.labels[s] = (char)(s % 7);
+    labels.push_back((char)(s % 7));
+  }
+  SPIKE_CHECK(store.number_of_columns() == 3);
+  SPIKE_CHECK(store.column_element_size(1) == sizeof(float));
+  SPIKE_CHECK(store.column_element_size(2) == sizeof(char));
+  SPIKE_CHECK(columns_equal(columns, indices, weights, labels));
+
+  // Random resizes, each followed by writes to the new synapses
+  std::mt19937 generator(7);
+  bool equal = true;
+  for (int step = 0; step < 200; step++){
+    int size = generator() % 300000;
+    int previous_size = indices.size();
+    store.resize(size);
+    indices.resize(size);
+    weights.resize(size);
+    labels.resize(size);
+    for (int s = previous_size; s < size; s++){
+      columns.indices[s] = indices[s] = (int)generator();
+      columns.weights[s] = weights[s] = (float)(generator() % 1000);
+      columns.labels[s] = labels[s] = (char)(generator() % 100);
+    }
+    if (!columns_equal(columns, indices, weights, labels))
+      equal = false;
+  }
+  SPIKE_CHECK(equal);
+
+  // Reserved memory does not move
+  store.reserve(store.size() + 50000);
+  int* reserved = columns.indices;
+  int reserved_size = store.size() + 50000;
+  store.resize(reserved_size);
+  SPIKE_CHECK(columns.indices == reserved);
+  store.resize(indices.size());
+
+  // shrink_to_fit keeps the contents
+  store.shrink_to_fit();
+  SPIKE_CHECK(store.capacity() == store.size());
+  SPIKE_CHECK(columns_equal(columns, indices, weights, labels));
+
+  // Mapped columns are used in place until the store grows
+  int mapped_size = 1000;
+  std::shared_ptr<std::vector<char>> mapped_memory = std::make_shared<std::vector<char>>(mapped_size*(sizeof(int) + sizeof(float) + sizeof(char)));
+  int* mapped_indices = (int*)mapped_memory->data();
+  float* mapped_weights = (float*)(mapped_memory->data() + mapped_size*sizeof(int));
+  char* mapped_labels = mapped_memory->data() + mapped_size*(sizeof(int) + sizeof(float));
+  for (int s = 0; s < mapped_size; s++){
+    mapped_indices[s] = 3*s;
+    mapped_weights[s] = 0.25f*s;
+    mapped_labels[s] = (char)(s % 5);
+  }
+  store.map_columns({mapped_indices, mapped_weights, mapped_labels}, mapped_size, mapped_memory);
+  SPIKE_CHECK(store.size() == mapped_size);
+  SPIKE_CHECK(columns.indices == mapped_indices);
+  SPIKE_CHECK(columns.weights == mapped_weights);
+  SPIKE_CHECK(columns.labels == mapped_labels);
+  SPIKE_CHECK(mapped_memory.use_count() == 2);
+
+  store.resize(mapped_size + 1);
+  SPIKE_CHECK(columns.indices != mapped_indices);
+  SPIKE_CHECK(mapped_memory.use_count() == 1);
+  bool copied = true;
+  for (int s = 0; s < mapped_size; s++)
+    if ((columns.indices[s] != 3*s) || (columns.weights[s] != 0.25f*s) || (columns.labels[s] != (char)(s % 5)))
+      copied = false;
+  SPIKE_CHECK(copied);
+
+  // Back to no synapses
+  store.resize(0);
+  store.shrink_to_fit();
+  SPIKE_CHECK(store.capacity() == 0);
+  SPIKE_CHECK(columns.indices == nullptr);
+
+  return test_result("SynapseStoreTest");
+}
@@ -0,0 +1,80 @@
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+/*
+  Helpers shared by the regression tests. Each test is an executable of its
+  own (registered with CTest in Tests/CMakeLists.txt) which prints every
+  failed check and returns non-zero if there were any.
+*/
+
+#include "Spike/Spike.hpp"
+
+#include <cstdio>
+
+static int number_of_failed_checks = 0;
+
+#define SPIKE_CHECK(condition)                                          \
+  do {                                                                  \
+    if (!(condition)) {                                                 \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      number_of_failed_checks++;                                        \
+    }                                                                   \
+  } while (0)
+
+// The return value of main
+static int test_result(const char* test_name){
+  if (number_of_failed_checks > 0)
+    fprintf(stderr, "%s: %d checks failed\n", test_name, number_of_failed_checks);
+  else
+    printf("%s: passed\n", test_name);
+  return (number_of_failed_checks > 0) ? 1 : 0;
+}
+
+// The tests run on the CPU backend with the given number of worker threads
+static void set_test_context(int threads){
+  Backend::init_global_context();
+  _global_ctx->backend = "CPU";
+  _global_ctx->params.threads = threads;
+}
+
+// A model of LIF neurons, Poisson inputs and voltage synapses
+static SpikingModel* new_test_model(){
+  SpikingModel* model = new SpikingModel();
+  model->SetTimestep(0.0001f);
+  model->spiking_neurons = new LIFSpikingNeurons();
+  model->input_spiking_neurons = new PoissonInputSpikingNeurons();
+  model->spiking_synapses = new VoltageSpikingSynapses(42);
+  return model;
+}
+
+static int add_test_neuron_group(SpikingModel* model, int width, int height){
+  lif_spiking_neuron_parameters_struct* params = new lif_spiking_neuron_parameters_struct();
+  params->group_shape[0] = width;
+  params->group_shape[1] = height;
+  params->somatic_capacitance_Cm = 200.0f*pow(10, -12);
+  params->somatic_leakage_conductance_g0 = 10.0f*pow(10, -9);
+  params->resting_potential_v0 = 0.0f;
+  params->after_spike_reset_potential_vreset = 0.0f;
+  params->threshold_for_action_potential_spike = 20.0f*pow(10, -3);
+  return model->AddNeuronGroup(params);
+}
+
+static int add_test_input_group(SpikingModel* model, int width, int height, float rate){
+  poisson_input_spiking_neuron_parameters_struct* params = new poisson_input_spiking_neuron_parameters_struct();
+  params->group_shape[0] = width;
+  params->group_shape[1] = height;
+  params->rate = rate;
+  return model->AddInputNeuronGroup(params);
+}
+
+static voltage_spiking_synapse_parameters_struct* new_test_synapse_params(int connectivity_type, float weight, float delay){
+  voltage_spiking_synapse_parameters_struct* params = new voltage_spiking_synapse_parameters_struct();
+  params->connectivity_type = connectivity_type;
+  params->weight_range[0] = weight;
+  params->weight_range[1] = weight;
+  params->delay_range[0] = delay;
+  params->delay_range[1] = delay;
+  return params;
+}
+
+#endif
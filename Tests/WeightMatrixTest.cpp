@@ -0,0 +1,137 @@
+// WeightMatrixTest: all-to-all groups stored as weight matrices
+/*
+  CONNECTIVITY_TYPE_ALL_TO_ALL groups which set all_to_all_weight_matrix
+  are stored as weight matrices instead of synapse by synapse. The same
+  network built both ways, with voltage and with conductance synapses,
+  must give identical spikes and identical weight, connectivity and delay
+  files.
+*/
+
+#include "TestHelpers.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct weight_matrix_network {
+  SpikingModel* model;
+  SpikingActivityMonitor* spike_monitor;
+};
+
+static weight_matrix_network build_network(bool conductance, bool weight_matrices){
+  weight_matrix_network network;
+  network.model = new_test_model();
+  SpikingModel* model = network.model;
+  if (conductance){
+    delete model->spiking_synapses;
+    model->spiking_synapses = new ConductanceSpikingSynapses(42);
+  }
+  network.spike_monitor = new SpikingActivityMonitor(model->spiking_neurons);
+  model->AddActivityMonitor(network.spike_monitor);
+
+  int first_inputs = add_test_input_group(model, 1, 300, 20.0f);
+  int second_inputs = add_test_input_group(model, 1, 300, 20.0f);
+  lif_spiking_neuron_parameters_struct* neuron_params = new lif_spiking_neuron_parameters_struct();
+  neuron_params->group_shape[0] = 1;
+  neuron_params->group_shape[1] = 250;
+  neuron_params->somatic_capacitance_Cm = 200.0f*pow(10, -12);
+  neuron_params->somatic_leakage_conductance_g0 = 10.0f*pow(10, -9);
+  if (conductance){
+    neuron_params->resting_potential_v0 = -60.0f*pow(10, -3);
+    neuron_params->after_spike_reset_potential_vreset = -60.0f*pow(10, -3);
+    neuron_params->threshold_for_action_potential_spike = -50.0f*pow(10, -3);
+    neuron_params->background_current = 0.5f*pow(10, -9);
+  } else {
+    neuron_params->resting_potential_v0 = 0.0f;
+    neuron_params->after_spike_reset_potential_vreset = 0.0f;
+    neuron_params->threshold_for_action_potential_spike = 20.0f*pow(10, -3);
+  }
+  int excitatory = model->AddNeuronGroup(neuron_params);
+  neuron_params->group_shape[1] = 120;
+  int inhibitory = model->AddNeuronGroup(neuron_params);
+
+  // Conductance weights are in nS, voltage weights in V
+  float scale = conductance ? 1.0f : 3.0f*pow(10, -3);
+  auto synapse_params = [&](int connectivity_type, float minimum_weight, float maximum_weight,
+                            float minimum_delay, float maximum_delay, float reversal_potential, float tau){
+    conductance_spiking_synapse_parameters_struct* params = new conductance_spiking_synapse_parameters_struct();
+    params->connectivity_type = connectivity_type;
+    params->weight_range[0] = minimum_weight*scale;
+    params->weight_range[1] = maximum_weight*scale;
+    params->delay_range[0] = minimum_delay;
+    params->delay_range[1] = maximum_delay;
+    params->weight_scaling_constant = conductance ? pow(10, -9) : 1.0f;
+    params->random_connectivity_probability = 0.1f;
+    params->reversal_potential_Vhat = reversal_potential;
+    params->decay_term_tau_g = tau;
+    params->all_to_all_weight_matrix = weight_matrices;
+    return params;
+  };
+  model->AddSynapseGroup(first_inputs, excitatory, synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, 0.05f, 0.2f, 0.001f, 0.001f, 0.0f, 0.005f));
+  model->AddSynapseGroup(second_inputs, inhibitory, synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, 0.05f, 0.1f, 0.002f, 0.002f, 0.0f, 0.005f));
+  model->AddSynapseGroup(excitatory, excitatory, synapse_params(CONNECTIVITY_TYPE_RANDOM, 0.1f, 0.3f, 0.001f, 0.003f, 0.0f, 0.005f));
+  if (conductance)
+    model->AddSynapseGroup(inhibitory, excitatory, synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, 0.3f, 1.0f, 0.0005f, 0.0005f, -80.0f*pow(10, -3), 0.01f));
+  else
+    model->AddSynapseGroup(inhibitory, excitatory, synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, -0.3f, -0.1f, 0.0005f, 0.0005f, 0.0f, 0.01f));
+  // A range of delays, which is never a weight matrix
+  model->AddSynapseGroup(excitatory, inhibitory, synapse_params(CONNECTIVITY_TYPE_ALL_TO_ALL, 0.01f, 0.05f, 0.001f, 0.004f, 0.0f, 0.005f));
+  return network;
+}
+
+static std::vector<char> file_contents(const std::string& filename){
+  std::ifstream file(filename, std::ios::binary);
+  SPIKE_CHECK(file.is_open());
+  return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void check_same_files(const std::string& kind){
+  for (std::string name : {"PresynapticIDs.bin", "PostsynapticIDs.bin", "SynapticWeights.bin", "SynapticDelays.bin"}){
+    std::string stored_file = "./" + kind + "Stored" + name;
+    std::string matrix_file = "./" + kind + "Matrix" + name;
+    std::vector<char> stored = file_contents(stored_file);
+    SPIKE_CHECK(!stored.empty());
+    SPIKE_CHECK(file_contents(matrix_file) == stored);
+    remove(stored_file.c_str());
+    remove(matrix_file.c_str());
+  }
+}
+
+static void check_weight_matrices(bool conductance){
+  std::string kind = conductance ? "Conductance" : "Voltage";
+  weight_matrix_network stored = build_network(conductance, false);
+  weight_matrix_network matrix = build_network(conductance, true);
+  SPIKE_CHECK(stored.model->spiking_synapses->dense_groups.empty());
+  SPIKE_CHECK(matrix.model->spiking_synapses->dense_groups.size() == 3);
+
+  stored.model->finalise_model();
+  matrix.model->finalise_model();
+  stored.model->run(0.5f);
+  matrix.model->run(0.5f);
+
+  SpikingActivityMonitor* stored_monitor = stored.spike_monitor;
+  SpikingActivityMonitor* matrix_monitor = matrix.spike_monitor;
+  SPIKE_CHECK(stored_monitor->total_number_of_spikes_stored_on_host > 0);
+  SPIKE_CHECK(matrix_monitor->total_number_of_spikes_stored_on_host == stored_monitor->total_number_of_spikes_stored_on_host);
+  if (matrix_monitor->total_number_of_spikes_stored_on_host == stored_monitor->total_number_of_spikes_stored_on_host){
+    bool identical = true;
+    for (int s = 0; s < stored_monitor->total_number_of_spikes_stored_on_host; s++)
+      if ((matrix_monitor->neuron_ids_of_stored_spikes_on_host[s] != stored_monitor->neuron_ids_of_stored_spikes_on_host[s]) ||
+          (matrix_monitor->spike_times_of_stored_spikes_on_host[s] != stored_monitor->spike_times_of_stored_spikes_on_host[s]))
+        identical = false;
+    SPIKE_CHECK(identical);
+  }
+
+  stored.model->spiking_synapses->save_connectivity_as_binary(".", kind + "Stored");
+  matrix.model->spiking_synapses->save_connectivity_as_binary(".", kind + "Matrix");
+  check_same_files(kind);
+}
+
+int main (int argc, char *argv[]){
+  set_test_context(2);
+  check_weight_matrices(false);
+  check_weight_matrices(true);
+  return test_result("WeightMatrixTest");
+}